@@ -0,0 +1,16 @@
+#version 460
+
+layout (location = 0) in vec3 inNormal;
+layout (location = 1) in vec2 inUV;
+
+layout (location = 0) out vec4 outColor;
+
+void main()
+{
+    const vec3 lightDirection = normalize(vec3(0.4, 1.0, 0.3));
+
+    vec3  normal  = normalize(inNormal);
+    float diffuse = max(dot(normal, lightDirection), 0.0);
+
+    outColor = vec4(vec3(0.1 + 0.9 * diffuse), 1.0);
+}
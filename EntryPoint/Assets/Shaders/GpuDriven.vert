@@ -0,0 +1,28 @@
+#version 460
+
+// Draws emitted by GpuCull.comp, firstInstance carries the object index
+
+#include <GpuScene.glsl>
+#include <Vertex.glsl>
+
+layout (push_constant) uniform DrawConstants
+{
+    ObjectBuffer objects;
+    uvec2        vertices;
+    mat4         viewProj;
+} pc;
+
+layout (location = 0) out vec3 outNormal;
+layout (location = 1) out vec2 outUV;
+
+void main()
+{
+    GpuObject        object    = pc.objects.objects[gl_InstanceIndex];
+    VertexAttributes attributes = LoadVertex(pc.vertices, gl_VertexIndex);
+
+    gl_Position = pc.viewProj * object.transform * vec4(attributes.position, 1.0);
+
+    // Uniform scale assumed, no inverse transpose
+    outNormal = normalize(mat3(object.transform) * attributes.normal);
+    outUV     = attributes.uv;
+}
@@ -0,0 +1,75 @@
+#ifndef GPU_SCENE_GLSL
+#define GPU_SCENE_GLSL
+
+// Mirrors GpuScene.h, std430 through buffer device addresses
+
+#extension GL_EXT_buffer_reference : require
+
+struct GpuObject
+{
+    mat4 transform;
+    vec4 boundingSphere; // world space, xyz center + w radius
+    uint meshIndex;
+    float scale;         // largest axis scale of the transform
+    uint padding0;
+    uint padding1;
+};
+
+#define MAX_MESH_LODS 8
+
+struct GpuMeshLod
+{
+    uint  indexCount;
+    uint  firstIndex;
+    float error;         // mesh space
+    uint  padding;
+};
+
+struct GpuMesh
+{
+    uint       lodCount;
+    int        vertexOffset;
+    uint       firstMeshlet;  // LOD 0 only
+    uint       meshletCount;
+    GpuMeshLod lods[MAX_MESH_LODS]; // full detail first
+};
+
+struct GpuCullData
+{
+    vec4 frustumPlanes[6];  // xyz normal pointing inside, w distance
+    mat4 occlusionViewProj; // view projection the depth pyramid was rendered with
+    vec2 pyramidSize;       // mip 0
+    uint pyramidMipCount;
+    uint occlusionEnabled;
+    vec3 cameraPosition;
+    float lodDistanceFactor; // LodSelection::GetDistanceFactor
+    mat4 viewProj;           // mesh shader path transforms with it
+};
+
+// VkDrawIndexedIndirectCommand
+struct DrawCommand
+{
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int  vertexOffset;
+    uint firstInstance; // object index, read back through gl_InstanceIndex
+};
+
+// VkDrawMeshTasksIndirectCommandEXT + the object, drawn with a 16 byte stride
+struct TaskCommand
+{
+    uint groupCountX;   // one task workgroup per TASK_MESHLETS meshlets
+    uint groupCountY;
+    uint groupCountZ;
+    uint objectIndex;   // read back through gl_DrawID
+};
+
+layout (buffer_reference, std430, buffer_reference_align = 16) readonly buffer ObjectBuffer   { GpuObject objects[]; };
+layout (buffer_reference, std430, buffer_reference_align = 16) readonly buffer MeshBuffer     { GpuMesh meshes[]; };
+layout (buffer_reference, std430, buffer_reference_align = 16) readonly buffer CullDataBuffer { GpuCullData data; };
+layout (buffer_reference, std430, buffer_reference_align = 4)  buffer DrawCountBuffer         { uint count; };
+layout (buffer_reference, std430, buffer_reference_align = 4)  writeonly buffer DrawCommandBuffer { DrawCommand commands[]; };
+layout (buffer_reference, std430, buffer_reference_align = 16) buffer TaskCommandBuffer        { TaskCommand commands[]; };
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef MESHLET_GLSL
+#define MESHLET_GLSL
+
+// Mirrors Meshlet in MeshData.h (std430) and GpuScene::DrawMeshlets, shared by Meshlet.task and Meshlet.mesh
+
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_buffer_reference_uvec2 : require
+
+#include <GpuScene.glsl>
+
+#define MESHLET_MAX_VERTICES  64  // kMeshletMaxVertices
+#define MESHLET_MAX_TRIANGLES 124 // kMeshletMaxTriangles
+#define TASK_MESHLETS         32  // meshlets tested by one task workgroup, GpuCull.comp sizes the draws by it
+
+struct Meshlet
+{
+    vec4  boundingSphere; // mesh space, xyz center + w radius
+    vec3  coneApex;
+    float coneCutoff;     // backfacing from every view when dot(normalize(apex - eye), axis) >= cutoff
+    vec3  coneAxis;
+    uint  vertexOffset;
+    uint  triangleOffset;
+    uint  vertexCount;
+    uint  triangleCount;
+    uint  padding;
+};
+
+layout (buffer_reference, std430, buffer_reference_align = 16) readonly buffer MeshletBuffer         { Meshlet meshlets[]; };
+layout (buffer_reference, std430, buffer_reference_align = 4)  readonly buffer MeshletVertexBuffer   { uint indices[]; };  // local to the submesh
+layout (buffer_reference, std430, buffer_reference_align = 4)  readonly buffer MeshletTriangleBuffer { uint triangles[]; }; // 8 bits per corner
+
+// GpuMeshletConstants
+layout (push_constant) uniform MeshletConstants
+{
+    ObjectBuffer          objects;
+    MeshBuffer            meshes;
+    CullDataBuffer        cull;
+    TaskCommandBuffer     taskCommands;
+    MeshletBuffer         meshlets;
+    MeshletVertexBuffer   meshletVertices;
+    MeshletTriangleBuffer meshletTriangles;
+    uvec2                 vertices;
+} pc;
+
+// Written by the task workgroup, read by every mesh workgroup it launches
+struct TaskPayload
+{
+    uint objectIndex;
+    uint meshletIndices[TASK_MESHLETS];
+};
+
+#endif
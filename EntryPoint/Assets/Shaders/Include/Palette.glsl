@@ -0,0 +1,12 @@
+#ifndef PALETTE_GLSL
+#define PALETTE_GLSL
+
+vec3 palette[5] = vec3[5] (
+  vec3(1.0, 0.0, 0.0), // red
+  vec3(0.0, 1.0, 0.0), // green
+  vec3(0.0, 0.0, 1.0), // blue
+  vec3(1.0, 1.0, 0.0), // yellow
+  vec3(0.0, 0.0, 0.0) // black
+);
+
+#endif
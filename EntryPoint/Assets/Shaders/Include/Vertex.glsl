@@ -0,0 +1,66 @@
+#ifndef VERTEX_GLSL
+#define VERTEX_GLSL
+
+// Mirrors MeshData.h, vertices are pulled through a buffer device address
+
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_buffer_reference_uvec2 : require
+
+struct Vertex
+{
+    vec3  position;
+    float uvX;
+    vec3  normal;
+    float uvY;
+};
+
+// QuantizedVertex, 3 words: half position xy | half position z + snorm8 octahedral normal | half uv
+layout (buffer_reference, std430, buffer_reference_align = 16) readonly buffer VertexBuffer          { Vertex vertices[]; };
+layout (buffer_reference, std430, buffer_reference_align = 4)  readonly buffer QuantizedVertexBuffer { uint words[]; };
+
+layout (constant_id = 3) const bool QUANTIZED_VERTICES = false;
+
+struct VertexAttributes
+{
+    vec3 position;
+    vec3 normal;
+    vec2 uv;
+};
+
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3  n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+
+    return normalize(n);
+}
+
+VertexAttributes LoadVertex(uvec2 address, uint index)
+{
+    VertexAttributes attributes;
+
+    if (QUANTIZED_VERTICES)
+    {
+        QuantizedVertexBuffer buffer = QuantizedVertexBuffer(address);
+        uint w0 = buffer.words[index * 3 + 0];
+        uint w1 = buffer.words[index * 3 + 1];
+        uint w2 = buffer.words[index * 3 + 2];
+
+        attributes.position = vec3(unpackHalf2x16(w0), unpackHalf2x16(w1).x);
+        attributes.normal   = DecodeOctahedral(unpackSnorm4x8(w1).zw);
+        attributes.uv       = unpackHalf2x16(w2);
+    }
+    else
+    {
+        Vertex vertex = VertexBuffer(address).vertices[index];
+
+        attributes.position = vertex.position;
+        attributes.normal   = vertex.normal;
+        attributes.uv       = vec2(vertex.uvX, vertex.uvY);
+    }
+
+    return attributes;
+}
+
+#endif
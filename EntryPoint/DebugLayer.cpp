@@ -19,12 +19,9 @@ void DebugLayer::OnDetach()
 	Client_INFO(fmt::runtime("Layer {}: detached!"), m_Name);
 }
 
-void DebugLayer::OnUpdate()
+void DebugLayer::OnImGuiRender()
 {
-	VulkanEngine::VulkanRenderer::BeginImGui();
-	VulkanEngine::VulkanRenderer::EndImGui();
 
-	VulkanEngine::VulkanRenderer::EndFrame();
 }
 
 void DebugLayer::OnEvent()
@@ -14,6 +14,6 @@ public:
 
 	void OnAttach() override;
 	void OnDetach() override;
-	void OnUpdate() override;
+	void OnImGuiRender() override;
 	void OnEvent()  override;
 };
\ No newline at end of file
@@ -4,7 +4,7 @@
 MainLayer::MainLayer(std::string layerName)
 	: VulkanEngine::Layer(layerName)
 {
-
+	DeclarePhase(VulkanEngine::LayerPhase::Record);
 }
 
 void MainLayer::OnAttach()
@@ -15,30 +15,68 @@ void MainLayer::OnAttach()
 
 	std::filesystem::current_path("F:\\Langs\\C++\\Petprojects\\VulkanEngine\\EntryPoint");
 
+	// Shaders
+	VulkanEngine::ShaderCompiler::SetIncludeDirectories({ "Assets\\Shaders\\Include" });
+	if (!VulkanEngine::ShaderArchive::Mount("Assets\\Shaders.pak", "Assets\\Shaders"))
+		VulkanEngine::ShaderBatchCompiler::CompileDirectory("Assets\\Shaders"); // no packed build, warm the loose cache
+	VulkanEngine::ShaderHotReloader::Start({ "Assets\\Shaders" });
+
+	m_Shader = std::make_shared<VulkanEngine::VulkanShader>("Assets\\Shaders\\MyCompute.comp");
+
+	// Layouts, reflected from the shader
+	VulkanEngine::ReflectedLayout layout = VulkanEngine::VulkanLayoutCache::GetLayout({ m_Shader });
+	m_SetLayout			= layout.setLayouts[0];
+	m_PipelineLayout	= layout.pipelineLayout;
+
 	// Descriptors
 	uint32_t maxSetsToAllocate = 1;
-	std::vector<VulkanEngine::PoolSize> poolSizes = { {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1} };
-	m_SetAllocator = std::make_shared<VulkanEngine::VulkanDescriptorSetAllocator>(maxSetsToAllocate, poolSizes);
-
-	m_SetLayout = VulkanEngine::VkDescriptorSetLayoutBuilder()
-		.AddBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1)
-		.Build();
+	m_SetAllocator = std::make_shared<VulkanEngine::VulkanDescriptorSetAllocator>(maxSetsToAllocate, layout.GetPoolSizes(0, maxSetsToAllocate));
 
 	m_Set = m_SetAllocator->Allocate(m_SetLayout);
 	m_Set->WriteImage(VulkanEngine::VulkanRenderer::GetRenderTarget().imageView, VK_IMAGE_LAYOUT_GENERAL, 0);
+	m_SetHandle = VulkanEngine::VulkanRenderer::GetResources().AddDescriptorSet(m_Set->GetRaw());
 
-	// Shaders
-	m_Shader = std::make_shared<VulkanEngine::VulkanShader>("Assets\\Shaders\\MyCompute.comp");
+	// Workgroup size, benchmarked once per device
+	VulkanEngine::VkPipelineBuilder computeBuilder;
+	computeBuilder
+		.AddPipelineLayout(m_PipelineLayout)
+		.AddPipelineShader(m_Shader);
 
-	// Pipeline
-	m_PipelineLayout = VulkanEngine::VkPipelineLayoutBuilder()
-		.AddDescriptorSetLayout(m_SetLayout)
-		.Build();
+	const VulkanEngine::AllocatedImage& renderTarget = VulkanEngine::VulkanRenderer::GetRenderTarget();
 
-	m_Pipeline = VulkanEngine::VkPipelineBuilder()
-		.AddPipelineLayout(m_PipelineLayout)
-		.AddPipelineShader(m_Shader)
-		.Build(VulkanEngine::PipelineType::Compute);
+	m_WorkgroupSize = VulkanEngine::WorkgroupAutotuner::Tune("MyCompute", computeBuilder, renderTarget.extent,
+		[this, &renderTarget](VkCommandBuffer cmd, VkPipelineLayout layout)
+		{
+			// Runs before the first frame, the renderer still transitions the target from UNDEFINED
+			VulkanEngine::ImageState discardedState;
+			VulkanEngine::VulkanUtils::InsertImageMemoryBarrier(
+				cmd, renderTarget.image, discardedState,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+				VK_IMAGE_LAYOUT_GENERAL
+			);
+
+			VkDescriptorSet set = m_Set->GetRaw();
+			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &set, 0, nullptr);
+		});
+
+	computeBuilder.SetWorkgroupSize(m_WorkgroupSize);
+
+	// Pipeline
+	if (VulkanEngine::VulkanShaderObject::IsSupported())
+	{
+		VulkanEngine::ShaderObjectSpecification shaderObjectSpec;
+		shaderObjectSpec.setLayouts			= layout.setLayouts;
+		shaderObjectSpec.pushConstantRanges = layout.reflection.pushConstantRanges;
+		shaderObjectSpec.specialization.Set(VulkanEngine::WORKGROUP_SIZE_X_ID, m_WorkgroupSize[0]);
+		shaderObjectSpec.specialization.Set(VulkanEngine::WORKGROUP_SIZE_Y_ID, m_WorkgroupSize[1]);
+		shaderObjectSpec.specialization.Set(VulkanEngine::WORKGROUP_SIZE_Z_ID, m_WorkgroupSize[2]);
+
+		m_ShaderObject = std::make_shared<VulkanEngine::VulkanShaderObject>(m_Shader, shaderObjectSpec);
+	}
+	else
+	{
+		m_Pipeline = computeBuilder.BuildHandle(VulkanEngine::PipelineType::Compute);
+	}
 
 	// End
 	VulkanEngine::VulkanRenderer::EndInit();
@@ -49,12 +87,21 @@ void MainLayer::OnDetach()
 	Client_INFO(fmt::runtime("Layer {}: detached!"), m_Name);
 }
 
-void MainLayer::OnUpdate()
+void MainLayer::OnRecord(const VulkanEngine::FramePacket& packet)
 {
-	VulkanEngine::VulkanRenderer::BeginFrame();
-	VulkanEngine::VulkanRenderer::BindPipeline(m_Pipeline, VK_PIPELINE_BIND_POINT_COMPUTE);
-	VulkanEngine::VulkanRenderer::BindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, m_Set->GetRaw());
-	VulkanEngine::VulkanRenderer::Dispatch(80, 45, 1);
+	if (m_ShaderObject)
+	{
+		VkShaderStageFlagBits	stage	= m_ShaderObject->GetStage();
+		VkShaderEXT				shader	= m_ShaderObject->GetRaw();
+		VulkanEngine::VulkanRenderer::BindShaderObjects({ &stage, 1 }, { &shader, 1 });
+	}
+	else
+	{
+		VulkanEngine::VulkanRenderer::BindPipeline(m_Pipeline);
+	}
+
+	VulkanEngine::VulkanRenderer::BindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, m_SetHandle);
+	VulkanEngine::VulkanRenderer::Dispatch(VulkanEngine::VulkanRenderer::GetRenderTarget().extent, m_WorkgroupSize);
 }
 
 void MainLayer::OnEvent()
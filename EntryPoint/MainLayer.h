@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
 
@@ -14,19 +15,22 @@ public:
 
 	void OnAttach() override;
 	void OnDetach() override;
-	void OnUpdate() override;
+	void OnRecord(const VulkanEngine::FramePacket& packet) override;
 	void OnEvent()  override;
 
 private:
 	// Descriptors
 	std::shared_ptr<VulkanEngine::VulkanDescriptorSetAllocator> m_SetAllocator;
 	std::shared_ptr<VulkanEngine::VulkanDescriptorSet>			m_Set;
+	VulkanEngine::DescriptorSetHandle							m_SetHandle; // bound each frame
 	VkDescriptorSetLayout										m_SetLayout{ VK_NULL_HANDLE };
 
 	// Shaders
-	std::shared_ptr<VulkanEngine::VulkanShader> m_Shader;
+	std::shared_ptr<VulkanEngine::VulkanShader>			m_Shader;
+	std::shared_ptr<VulkanEngine::VulkanShaderObject>	m_ShaderObject; // null when VK_EXT_shader_object is unavailable
 
 	// Pipeline
-	VkPipelineLayout	m_PipelineLayout{ VK_NULL_HANDLE };
-	VkPipeline			m_Pipeline{ VK_NULL_HANDLE };
+	VkPipelineLayout								m_PipelineLayout{ VK_NULL_HANDLE };
+	VulkanEngine::PipelineHandle					m_Pipeline; // hot reloaded in place
+	std::array<uint32_t, 3>							m_WorkgroupSize{ 16, 16, 1 };
 };
\ No newline at end of file
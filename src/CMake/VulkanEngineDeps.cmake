@@ -8,12 +8,27 @@ set(FETCHCONTENT_QUIET OFF)
 # ------------------------------------
 # Vulkan library
 # ------------------------------------
+# shaderc is always needed by the ShaderPacker tool; the engine only links it when shaders
+# may be compiled at runtime (development), shipped builds load everything from Shaders.pak
+option(VULKANENGINE_RUNTIME_SHADERC "Compile shaders missing from the shader archive at runtime" ON)
+
 find_package(Vulkan REQUIRED COMPONENTS shaderc_combined)
 target_link_libraries(${ENGINE_NAME} PUBLIC 
 	Vulkan::Vulkan
-	Vulkan::shaderc_combined
 )
 
+if(VULKANENGINE_RUNTIME_SHADERC)
+	target_link_libraries(${ENGINE_NAME} PUBLIC 
+		Vulkan::shaderc_combined
+	)
+	target_compile_definitions(${ENGINE_NAME} PUBLIC 
+		VULKANENGINE_RUNTIME_SHADERC=1
+		VULKANENGINE_SHADER_TOOLCHAIN="${Vulkan_VERSION}" # part of the SPIR-V cache key
+	)
+else()
+	target_compile_definitions(${ENGINE_NAME} PUBLIC VULKANENGINE_RUNTIME_SHADERC=0)
+endif()
+
 
 # ------------------------------------
 # GLFW library via FetchContent
@@ -145,6 +160,53 @@ target_link_libraries(${ENGINE_NAME} PUBLIC
 )
 
 
+# ------------------------------------
+# SPIRV-Reflect library via FetchContent
+# ------------------------------------
+FetchContent_Declare(
+	spirv_reflect
+	URL https://github.com/KhronosGroup/SPIRV-Reflect/archive/refs/tags/vulkan-sdk-1.4.309.0.tar.gz
+)
+set(SPIRV_REFLECT_EXECUTABLE	OFF CACHE BOOL "" FORCE)
+set(SPIRV_REFLECT_EXAMPLES		OFF CACHE BOOL "" FORCE)
+set(SPIRV_REFLECT_STATIC_LIB	ON  CACHE BOOL "" FORCE)
+FetchContent_MakeAvailable(spirv_reflect)
+target_link_libraries(${ENGINE_NAME} PUBLIC 
+	spirv-reflect-static
+)
+
+
+# ------------------------------------
+# meshoptimizer library via FetchContent
+# ------------------------------------
+FetchContent_Declare(
+	meshoptimizer
+	URL https://github.com/zeux/meshoptimizer/archive/refs/tags/v0.22.tar.gz
+)
+FetchContent_MakeAvailable(meshoptimizer)
+target_link_libraries(${ENGINE_NAME} PUBLIC 
+	meshoptimizer
+)
+
+
+# ------------------------------------
+# cgltf library via FetchContent
+# ------------------------------------
+FetchContent_Declare(
+	cgltf
+	URL https://github.com/jkuhlmann/cgltf/archive/refs/tags/v1.14.tar.gz
+)
+FetchContent_MakeAvailable(cgltf)
+
+add_library(cgltf INTERFACE)
+set_target_properties(cgltf PROPERTIES 
+	INTERFACE_INCLUDE_DIRECTORIES ${cgltf_SOURCE_DIR}
+)
+target_link_libraries(${ENGINE_NAME} PUBLIC 
+	cgltf
+)
+
+
 # Finish
 function(group_third_party target_name)
     if(TARGET ${target_name})
@@ -158,6 +220,9 @@ group_third_party(stb)
 group_third_party(glm)
 group_third_party(spdlog)
 group_third_party(vk-bootstrap)
+group_third_party(spirv-reflect-static)
+group_third_party(meshoptimizer)
+group_third_party(cgltf)
 group_third_party(gtest)
 group_third_party(gtest_main)
 group_third_party(gmock)
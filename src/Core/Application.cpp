@@ -1,5 +1,6 @@
 ﻿#include "Core/Application.h"
 #include "Core/LogSystem.h"
+#include "VulkanAbstraction/Assets/AssetLoader.h"
 
 
 namespace VulkanEngine {
@@ -14,6 +15,9 @@ namespace VulkanEngine {
 		LogSystem::Initialize();
 
 		m_LifetimeManager = std::make_unique<LifetimeManager>();
+		m_JobSystem = std::make_unique<JobSystem>(spec.jobSystem);
+		m_LayerScheduler = std::make_unique<LayerScheduler>(*m_LayerStack, *m_JobSystem);
+		m_FramePacket = std::make_unique<FramePacket>();
 
 		WindowSpecification winSpec;
 		winSpec.Width		= spec.windowWidth;
@@ -26,21 +30,34 @@ namespace VulkanEngine {
 
 	void Application::PushLayer(std::shared_ptr<Layer> layer)
 	{
+		// The render thread records from the layers of the stack
+		if (m_RenderThread)
+			m_RenderThread->WaitIdle();
+
 		m_LayerStack->PushLayer(layer);
 	}
 
 	void Application::PushOverlay(std::shared_ptr<Layer> overlay)
 	{
+		if (m_RenderThread)
+			m_RenderThread->WaitIdle();
+
 		m_LayerStack->PushOverlay(overlay);
 	}
 
 	void Application::RemoveLayer(std::string layerName)
 	{
+		if (m_RenderThread)
+			m_RenderThread->WaitIdle();
+
 		m_LayerStack->RemoveLayer(layerName);
 	}
 
 	void Application::RemoveOverlay(std::string overlayName)
 	{
+		if (m_RenderThread)
+			m_RenderThread->WaitIdle();
+
 		m_LayerStack->RemoveOverlay(overlayName);
 	}
 
@@ -51,15 +68,74 @@ namespace VulkanEngine {
 			m_Window->OnUpdate();
 
 			OnUpdate();
+
+			m_JobSystem->RunMainThreadJobs();
+
+			// Between frames: completed assets can be handed out. With the render thread something is being
+			// recorded meanwhile, layers reach Record with them through the next frame packet.
+			AssetLoader::Update();
 		}
 	}
 
 	void Application::OnUpdate()
 	{
-		for (auto it = m_LayerStack->begin(); it != m_LayerStack->end(); it++)
+		// Some layer attaches the renderer, the render thread starts once it is there
+		if (m_Spec.renderThread.enabled && !m_RenderThread && VulkanRenderer::IsInitialized())
 		{
-			(*it)->OnUpdate();
+			m_RenderThread = std::make_unique<RenderThread>(m_Spec.renderThread.maxQueuedFrames,
+				[this](FramePacket& packet)
+				{
+					m_JobSystem->RegisterRenderThread();
+					RenderFrame(packet, packet.GetImGuiDrawData());
+				});
 		}
+
+		FramePacket& packet = m_RenderThread ? m_RenderThread->AcquirePacket() : *m_FramePacket;
+		packet.Reset(m_FrameCount);
+		packet.timing.begin = FramePacket::Clock::now();
+
+		// Numbered like the renderer's frames: what is released from here on may be in this one
+		if (VulkanRenderer::IsInitialized())
+			VulkanRenderer::GetDeletionQueue().BeginFrame(m_FrameCount);
+
+		m_LayerScheduler->Run(LayerPhase::Simulate, packet);
+		m_LayerScheduler->Run(LayerPhase::PrepareRender, packet);
+
+		if (!VulkanRenderer::IsInitialized())
+			return;
+
+		m_FrameCount++;
+
+		// ImGui stays on the main thread with GLFW, only its draw data goes to the render thread
+		VulkanRenderer::BeginImGui();
+		m_LayerScheduler->RunImGui();
+		ImDrawData* imGuiDrawData = VulkanRenderer::EndImGui();
+
+		if (!m_RenderThread)
+		{
+			RenderFrame(packet, imGuiDrawData);
+			return;
+		}
+
+		packet.CaptureImGui(imGuiDrawData);
+		bool imGuiTextureUpdates = packet.HasImGuiTextureUpdates();
+
+		m_RenderThread->Publish(packet);
+
+		// The backend uploads them from the render thread, the next ImGui frame must not change them meanwhile
+		if (imGuiTextureUpdates)
+			m_RenderThread->WaitIdle();
+	}
+
+	void Application::RenderFrame(FramePacket& packet, ImDrawData* imGuiDrawData)
+	{
+		VulkanRenderer::BeginFrame();
+
+		packet.RunCommands();
+		m_LayerScheduler->Run(LayerPhase::Record, packet);
+		VulkanRenderer::RenderImGui(imGuiDrawData);
+
+		VulkanRenderer::EndFrame();
 	}
 
 	void Application::OnEvent()
@@ -72,6 +148,15 @@ namespace VulkanEngine {
 
 	void Application::Shutdown()
 	{
+		// Renders what is published, nothing records after this
+		if (m_RenderThread)
+			m_RenderThread->Stop();
+
+		// Jobs may still reference resources the lifetime manager destroys
+		m_JobSystem->Shutdown();
+
+		// What the layers own goes to the deletion queue, flushed by the lifetime manager once the device is idle
+		m_LayerStack->Clear();
 		m_LifetimeManager->Flush();
 	}
 
@@ -1,6 +1,9 @@
 ﻿#pragma once
 
+#include "Core/Jobs/JobSystem.h"
 #include "Core/Layers/LayerStack.h"
+#include "Core/Layers/LayerScheduler.h"
+#include "Core/RenderThread/RenderThread.h"
 #include "Core/LifetimeManager.h"
 #include "Window/Window.h"
 
@@ -12,6 +15,9 @@ namespace VulkanEngine {
 		std::string  windowName;
 		int			 windowWidth;
 		int			 windowHeight;
+
+		JobSystemSpecification		jobSystem;
+		RenderThreadSpecification	renderThread;
 	};
 
 	class Application
@@ -33,6 +39,12 @@ namespace VulkanEngine {
 		static Application*						GetRaw()					{ return s_Instance;		}
 		const std::unique_ptr<Window>&			GetWindow()			 const	{ return m_Window;			}
 		const std::unique_ptr<LifetimeManager>& GetLifetimeManager() const	{ return m_LifetimeManager; }
+		const std::unique_ptr<JobSystem>&		GetJobSystem()		 const	{ return m_JobSystem;		}
+		const std::unique_ptr<RenderThread>&	GetRenderThread()	 const	{ return m_RenderThread;		} // null unless enabled
+
+	private:
+		// BeginFrame to EndFrame, on the main thread or the render thread
+		void RenderFrame(FramePacket& packet, ImDrawData* imGuiDrawData);
 
 	private:
 		static Application*					s_Instance;
@@ -40,6 +52,11 @@ namespace VulkanEngine {
 		std::unique_ptr<Window>				m_Window;
 		std::unique_ptr<LayerStack>			m_LayerStack;
 		std::unique_ptr<LifetimeManager>	m_LifetimeManager;
+		std::unique_ptr<JobSystem>			m_JobSystem;
+		std::unique_ptr<LayerScheduler>		m_LayerScheduler;
+		std::unique_ptr<RenderThread>		m_RenderThread;
+		std::unique_ptr<FramePacket>		m_FramePacket; // without the render thread
+		uint64_t							m_FrameCount = 0; // rendered frames, the renderer's frame number
 	};
 
 }
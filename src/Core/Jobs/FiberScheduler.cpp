@@ -0,0 +1,186 @@
+#include "Core/Jobs/FiberScheduler.h"
+#include "Core/Jobs/JobSystem.h"
+#include "Core/LogSystem.h"
+
+#ifdef __linux__
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+
+namespace VulkanEngine {
+
+	FiberScheduler::FiberScheduler(JobSystem& jobSystem, uint32_t threadCount, uint32_t fibersPerThread, size_t stackSize)
+		: m_JobSystem(jobSystem), m_Threads(threadCount)
+	{
+#ifdef __linux__
+		size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		m_StackSize = (stackSize + pageSize - 1) / pageSize * pageSize;
+
+		for (uint32_t threadIndex = 1; threadIndex < threadCount; ++threadIndex)
+		{
+			for (uint32_t i = 0; i < fibersPerThread; ++i)
+			{
+				auto fiber = std::make_unique<Fiber>();
+				fiber->threadIndex	= threadIndex;
+				fiber->scheduler	= this;
+
+				if (!CreateFiber(*fiber))
+				{
+					VulkanEngine_ERROR(fmt::runtime("Failed to allocate a {} KB fiber stack"), m_StackSize / 1024);
+					break;
+				}
+
+				m_Threads[threadIndex].free.push_back(fiber.get());
+				m_Fibers.push_back(std::move(fiber));
+			}
+		}
+
+		VulkanEngine_INFO(fmt::runtime("Fiber scheduler: {} fibers with {} KB stacks"), m_Fibers.size(), m_StackSize / 1024);
+#endif
+	}
+
+	FiberScheduler::~FiberScheduler()
+	{
+#ifdef __linux__
+		for (auto& fiber : m_Fibers)
+			munmap(fiber->mapping, fiber->mappingSize);
+#endif
+	}
+
+	bool FiberScheduler::IsSupported()
+	{
+#ifdef __linux__
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	bool FiberScheduler::Run(uint32_t threadIndex, Job* job)
+	{
+		auto& thread = m_Threads[threadIndex];
+		if (thread.free.empty())
+			return false;
+
+		Fiber* fiber = thread.free.back();
+		thread.free.pop_back();
+
+		fiber->job = job;
+		SwitchTo(threadIndex, fiber);
+		return true;
+	}
+
+	bool FiberScheduler::ResumeReady(uint32_t threadIndex)
+	{
+		auto& suspended = m_Threads[threadIndex].suspended;
+
+		for (size_t i = 0; i < suspended.size(); ++i)
+		{
+			Fiber* fiber = suspended[i];
+			if (!fiber->condition())
+				continue;
+
+			suspended[i] = suspended.back();
+			suspended.pop_back();
+
+			fiber->condition = nullptr;
+			SwitchTo(threadIndex, fiber);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool FiberScheduler::Suspend(Condition condition)
+	{
+		Fiber* fiber = s_CurrentFiber;
+		if (!fiber)
+			return false;
+
+#ifdef __linux__
+		fiber->condition = std::move(condition);
+		swapcontext(&fiber->context, &m_Threads[fiber->threadIndex].context);
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void FiberScheduler::FiberMain(uint32_t fiberLow, uint32_t fiberHigh)
+	{
+#ifdef __linux__
+		// makecontext only passes ints
+		auto* fiber = reinterpret_cast<Fiber*>((static_cast<uintptr_t>(fiberHigh) << 32) | fiberLow);
+		FiberScheduler* scheduler = fiber->scheduler;
+
+		while (true)
+		{
+			scheduler->m_JobSystem.Execute(fiber->job);
+
+			fiber->job		= nullptr;
+			fiber->finished = true;
+			swapcontext(&fiber->context, &scheduler->m_Threads[fiber->threadIndex].context);
+		}
+#endif
+	}
+
+	bool FiberScheduler::CreateFiber(Fiber& fiber)
+	{
+#ifdef __linux__
+		size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+		fiber.mappingSize	= m_StackSize + pageSize;
+		fiber.mapping		= mmap(nullptr, fiber.mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+		if (fiber.mapping == MAP_FAILED)
+		{
+			fiber.mapping = nullptr;
+			return false;
+		}
+
+		// Stacks grow down, an overflow faults on the guard page instead of corrupting the next stack
+		mprotect(fiber.mapping, pageSize, PROT_NONE);
+
+		if (getcontext(&fiber.context) != 0)
+		{
+			munmap(fiber.mapping, fiber.mappingSize);
+			fiber.mapping = nullptr;
+			return false;
+		}
+
+		fiber.context.uc_stack.ss_sp	= static_cast<uint8_t*>(fiber.mapping) + pageSize;
+		fiber.context.uc_stack.ss_size	= m_StackSize;
+		fiber.context.uc_link			= nullptr;
+
+		uintptr_t address = reinterpret_cast<uintptr_t>(&fiber);
+		makecontext(&fiber.context, reinterpret_cast<void (*)()>(&FiberScheduler::FiberMain), 2,
+			static_cast<uint32_t>(address), static_cast<uint32_t>(address >> 32));
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void FiberScheduler::SwitchTo(uint32_t threadIndex, Fiber* fiber)
+	{
+#ifdef __linux__
+		auto& thread = m_Threads[threadIndex];
+
+		s_CurrentFiber = fiber;
+		swapcontext(&thread.context, &fiber->context);
+		s_CurrentFiber = nullptr;
+
+		// Back on the worker: the job either finished or suspended
+		if (fiber->finished)
+		{
+			fiber->finished = false;
+			thread.free.push_back(fiber);
+		}
+		else
+		{
+			thread.suspended.push_back(fiber);
+		}
+#endif
+	}
+
+}
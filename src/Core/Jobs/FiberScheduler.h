@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#ifdef __linux__
+	#include <ucontext.h>
+#endif
+
+
+namespace VulkanEngine {
+
+	struct Job;
+	class JobSystem;
+
+	// Fibers for JobSystem, so a job waiting on a counter or a GPU timeline suspends instead of tying up
+	// its worker, which picks up other jobs meanwhile.
+	// Every worker owns a fixed pool of fibers whose stacks are allocated up front with a guard page below
+	// each. A suspended fiber is resumed by the worker that started it once its condition holds, so thread
+	// locals stay valid across a wait. Linux only (ucontext); elsewhere IsSupported is false and
+	// jobs keep running on the worker stacks.
+	class FiberScheduler
+	{
+	public:
+		using Condition = std::function<bool()>;
+
+		// Thread 0 (the main thread) gets no fibers, its jobs run inline
+		FiberScheduler(JobSystem& jobSystem, uint32_t threadCount, uint32_t fibersPerThread, size_t stackSize);
+		virtual ~FiberScheduler();
+		FiberScheduler(const FiberScheduler&)				= delete;
+		FiberScheduler& operator=(const FiberScheduler&)	= delete;
+
+		static bool IsSupported();
+
+		// Worker thread: runs job on a free fiber until it finishes or suspends.
+		// False when every fiber of the thread is suspended, the caller runs the job itself.
+		bool Run(uint32_t threadIndex, Job* job);
+
+		// Worker thread: resumes one suspended fiber whose condition holds
+		bool ResumeReady(uint32_t threadIndex);
+		bool HasSuspended(uint32_t threadIndex) const { return !m_Threads[threadIndex].suspended.empty(); }
+
+		// Inside a job: back to the worker until condition holds, false when the job is not on a fiber
+		bool Suspend(Condition condition);
+
+	private:
+		struct Fiber
+		{
+#ifdef __linux__
+			ucontext_t		context{};
+#endif
+			void*			mapping{ nullptr };	// stack and its guard page
+			size_t			mappingSize{ 0 };
+			Job*			job{ nullptr };
+			Condition		condition;
+			uint32_t		threadIndex{ 0 };
+			bool			finished{ false };
+			FiberScheduler* scheduler{ nullptr };
+		};
+
+		struct ThreadFibers
+		{
+#ifdef __linux__
+			ucontext_t			context{}; // the worker's own stack while a fiber runs
+#endif
+			std::vector<Fiber*> free;
+			std::vector<Fiber*> suspended;
+		};
+
+		// Runs one job per switch in, forever: a finished fiber is reused without a new context
+		static void FiberMain(uint32_t fiberLow, uint32_t fiberHigh);
+
+		bool CreateFiber(Fiber& fiber);
+		void SwitchTo(uint32_t threadIndex, Fiber* fiber);
+
+	private:
+		JobSystem&							m_JobSystem;
+		size_t								m_StackSize{ 0 };
+		std::vector<std::unique_ptr<Fiber>>	m_Fibers;
+		std::vector<ThreadFibers>			m_Threads;
+
+		static inline thread_local Fiber*	s_CurrentFiber{ nullptr };
+	};
+
+}
@@ -0,0 +1,315 @@
+#include "Core/Jobs/JobSystem.h"
+#include "Core/LogSystem.h"
+
+
+namespace VulkanEngine {
+
+	void JobCounter::Increment(uint32_t count)
+	{
+		m_Value.fetch_add(count, std::memory_order_relaxed);
+	}
+
+	std::vector<Job*> JobCounter::Decrement()
+	{
+		uint32_t value = m_Value.load(std::memory_order_relaxed);
+		while (value > 1)
+		{
+			if (m_Value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+				return {};
+		}
+
+		// Probably the last one. Under the lock, so a waiter that sees zero cannot destroy the counter
+		// before this is done with it (JobSystem::Wait).
+		std::lock_guard lock(m_Mutex);
+
+		if (m_Value.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return {};
+
+		return std::exchange(m_Waiting, {});
+	}
+
+	bool JobCounter::AddWaiting(Job* job)
+	{
+		std::lock_guard lock(m_Mutex);
+
+		if (m_Value.load(std::memory_order_acquire) == 0)
+			return false;
+
+		m_Waiting.push_back(job);
+		return true;
+	}
+
+	JobSystem::JobSystem(const JobSystemSpecification& spec)
+	{
+		uint32_t threadCount = spec.threadCount;
+		if (threadCount == 0)
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		// Created by the application on the main thread
+		s_ThreadIndex = 0;
+
+		m_Queues.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; ++i)
+			m_Queues.push_back(std::make_unique<JobQueue>());
+
+		if (spec.useFibers)
+		{
+			if (FiberScheduler::IsSupported())
+				m_Fibers = std::make_unique<FiberScheduler>(*this, threadCount, spec.fibersPerThread, spec.fiberStackSize);
+			else
+				VulkanEngine_WARN("Fibers are not supported on this platform, jobs wait on their worker");
+		}
+
+		for (uint32_t i = 1; i < threadCount; ++i)
+			m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+
+		VulkanEngine_INFO(fmt::runtime("Job system started with {} workers"), m_Workers.size());
+	}
+
+	JobSystem::~JobSystem()
+	{
+		Shutdown();
+	}
+
+	void JobSystem::Schedule(std::function<void()> function, JobCounter* counter)
+	{
+		if (counter)
+			counter->Increment();
+
+		Submit(new Job{ std::move(function), counter });
+	}
+
+	void JobSystem::Schedule(std::function<void()> function, JobCounter& dependency, JobCounter* counter)
+	{
+		if (counter)
+			counter->Increment();
+
+		Job* job = new Job{ std::move(function), counter };
+		if (!dependency.AddWaiting(job))
+			Submit(job);
+	}
+
+	void JobSystem::ScheduleOnMainThread(std::function<void()> function, JobCounter* counter)
+	{
+		if (counter)
+			counter->Increment();
+
+		std::lock_guard lock(m_MainThreadMutex);
+		m_MainThreadJobs.push_back(new Job{ std::move(function), counter });
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		WaitUntil([&counter]() { return counter.IsDone(); });
+
+		// The last decrement still holds the lock, the caller may destroy the counter once it is released
+		std::lock_guard lock(counter.m_Mutex);
+	}
+
+	void JobSystem::Wait(VkDevice device, VkSemaphore timelineSemaphore, uint64_t value)
+	{
+		WaitUntil([=]()
+			{
+				uint64_t current = 0;
+				vkGetSemaphoreCounterValue(device, timelineSemaphore, &current);
+				return current >= value;
+			});
+	}
+
+	void JobSystem::WaitUntil(const std::function<bool()>& condition)
+	{
+		if (condition())
+			return;
+
+		// The worker resumes this job once condition holds
+		if (m_Fibers && m_Fibers->Suspend(condition))
+			return;
+
+		// Not on a fiber: the main thread, or a job a worker runs inline because its fibers are all taken
+		uint32_t threadIndex = s_ThreadIndex;
+		bool fiberWorker = m_Fibers && threadIndex != 0 && threadIndex < m_Queues.size();
+
+		while (!condition())
+		{
+			// What is waited on may be a main thread job
+			if (threadIndex == 0 && RunMainThreadJob())
+				continue;
+
+			// Or a job suspended on this worker, only this worker ever resumes it
+			if (fiberWorker && m_Fibers->ResumeReady(threadIndex))
+				continue;
+
+			// On a fiber when one is free, so it suspends instead of nesting another wait here
+			if (Job* job = FindJob(threadIndex))
+			{
+				if (!fiberWorker || !m_Fibers->Run(threadIndex, job))
+					Execute(job);
+				continue;
+			}
+
+			std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::RunMainThreadJobs()
+	{
+		// Only what is queued now, jobs scheduling more main thread jobs run again next frame
+		std::deque<Job*> jobs;
+		{
+			std::lock_guard lock(m_MainThreadMutex);
+			jobs.swap(m_MainThreadJobs);
+		}
+
+		for (Job* job : jobs)
+			Execute(job);
+	}
+
+	bool JobSystem::RunMainThreadJob()
+	{
+		Job* job = nullptr;
+		{
+			std::lock_guard lock(m_MainThreadMutex);
+			if (m_MainThreadJobs.empty())
+				return false;
+
+			job = m_MainThreadJobs.front();
+			m_MainThreadJobs.pop_front();
+		}
+
+		Execute(job);
+		return true;
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if (m_Stop.exchange(true))
+			return;
+
+		{
+			std::lock_guard lock(m_SleepMutex);
+		}
+		m_SleepCondition.notify_all();
+
+		for (auto& worker : m_Workers)
+		{
+			if (worker.joinable())
+				worker.join();
+		}
+		m_Workers.clear();
+		m_Fibers.reset();
+
+		// Whatever the workers left behind, including jobs those jobs schedule
+		while (Job* job = FindJob(0))
+			Execute(job);
+
+		RunMainThreadJobs();
+	}
+
+	void JobSystem::Submit(Job* job)
+	{
+		uint32_t threadIndex = s_ThreadIndex;
+
+		if (threadIndex >= m_Queues.size() || !m_Queues[threadIndex]->Push(job))
+		{
+			std::lock_guard lock(m_ExternalMutex);
+			m_ExternalJobs.push_back(job);
+		}
+
+		m_QueuedJobs.fetch_add(1);
+		WakeWorker();
+	}
+
+	void JobSystem::Execute(Job* job)
+	{
+		job->function();
+
+		if (job->counter)
+		{
+			for (Job* waiting : job->counter->Decrement())
+				Submit(waiting);
+		}
+
+		delete job;
+	}
+
+	Job* JobSystem::FindJob(uint32_t threadIndex)
+	{
+		uint32_t queueCount = static_cast<uint32_t>(m_Queues.size());
+		Job* job = nullptr;
+
+		if (threadIndex < queueCount)
+			job = m_Queues[threadIndex]->Pop();
+
+		if (!job)
+		{
+			std::lock_guard lock(m_ExternalMutex);
+			if (!m_ExternalJobs.empty())
+			{
+				job = m_ExternalJobs.front();
+				m_ExternalJobs.pop_front();
+			}
+		}
+
+		// Starting next to our own deque spreads the thieves over the victims
+		for (uint32_t i = 1; !job && i <= queueCount; ++i)
+		{
+			uint32_t victim = (threadIndex + i) % queueCount;
+			if (victim != threadIndex)
+				job = m_Queues[victim]->Steal();
+		}
+
+		if (job)
+			m_QueuedJobs.fetch_sub(1);
+
+		return job;
+	}
+
+	void JobSystem::WorkerLoop(uint32_t threadIndex)
+	{
+		s_ThreadIndex = threadIndex;
+
+		// Suspended jobs are finished before the worker exits
+		while (!m_Stop.load(std::memory_order_relaxed) || (m_Fibers && m_Fibers->HasSuspended(threadIndex)))
+		{
+			if (m_Fibers && m_Fibers->ResumeReady(threadIndex))
+				continue;
+
+			if (Job* job = FindJob(threadIndex))
+			{
+				if (!m_Fibers || !m_Fibers->Run(threadIndex, job))
+					Execute(job);
+				continue;
+			}
+
+			// Their conditions are polled, nothing would wake a sleeping worker for them
+			if (m_Fibers && m_Fibers->HasSuspended(threadIndex))
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			if (m_Stop.load())
+				break;
+
+			// Sleeping is counted before the queue is checked again, Submit counts the job before it
+			// looks for sleepers, so one of the two always sees the other
+			std::unique_lock lock(m_SleepMutex);
+			m_SleepingWorkers.fetch_add(1);
+			m_SleepCondition.wait(lock, [this]() { return m_Stop.load() || m_QueuedJobs.load() > 0; });
+			m_SleepingWorkers.fetch_sub(1);
+		}
+	}
+
+	void JobSystem::WakeWorker()
+	{
+		if (m_SleepingWorkers.load() == 0)
+			return;
+
+		// A worker between its check and the wait holds the mutex, taking it means the notify can't be missed
+		{
+			std::lock_guard lock(m_SleepMutex);
+		}
+		m_SleepCondition.notify_one();
+	}
+
+}
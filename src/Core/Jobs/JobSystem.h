@@ -0,0 +1,189 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Core/Jobs/FiberScheduler.h"
+#include "Core/Jobs/WorkStealingDeque.h"
+
+
+namespace VulkanEngine {
+
+	struct Job;
+
+	// Counts unfinished jobs. Jobs scheduled with a counter increment it and decrement it when they finish;
+	// jobs scheduled after a counter start once it is back to zero. Must outlive every job using it.
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&)				= delete;
+		JobCounter& operator=(const JobCounter&)	= delete;
+
+		bool		IsDone()	const { return m_Value.load(std::memory_order_acquire) == 0; }
+		uint32_t	GetValue()	const { return m_Value.load(std::memory_order_acquire); }
+
+	private:
+		friend class JobSystem;
+
+		void Increment(uint32_t count = 1);
+
+		// The jobs waiting for zero, empty until it gets there
+		std::vector<Job*> Decrement();
+
+		// False when already at zero, the caller runs the job itself
+		bool AddWaiting(Job* job);
+
+	private:
+		std::atomic<uint32_t>	m_Value{ 0 };
+		std::mutex				m_Mutex; // waiting list, held across the last decrement
+		std::vector<Job*>		m_Waiting;
+	};
+
+	struct Job
+	{
+		std::function<void()>	function;
+		JobCounter*				counter{ nullptr }; // decremented when done
+	};
+
+	struct JobSystemSpecification
+	{
+		uint32_t	threadCount		= 0;			// 0 uses every hardware thread, the main thread included
+		bool		useFibers		= false;		// FiberScheduler, ignored where it is not supported
+		uint32_t	fibersPerThread = 32;			// jobs a worker can have suspended at once, plus the running one
+		size_t		fiberStackSize	= 256 * 1024;	// glTF import and shader compilation run in jobs
+	};
+
+	// Work-stealing job system, one worker per hardware thread next to the main thread.
+	// Every worker and the main thread own a lock-free deque: they push and pop their own jobs at one end
+	// and idle threads steal from the other, so fanned out work spreads across cores without a shared queue.
+	// Threads outside the system (asset workers, the shader watcher) schedule through a locked queue.
+	// Waiting on a counter runs other jobs instead of blocking. Main-thread-only jobs run in
+	// RunMainThreadJobs, called by Application::Run once per frame, or while the main thread waits.
+	// With fibers, a job on a worker that waits suspends instead and its worker moves on.
+	class JobSystem
+	{
+	public:
+		explicit JobSystem(const JobSystemSpecification& spec = {});
+		virtual ~JobSystem();
+		JobSystem(const JobSystem&)				= delete;
+		JobSystem& operator=(const JobSystem&)	= delete;
+
+		void Schedule(std::function<void()> function, JobCounter* counter = nullptr);
+
+		// Starts once dependency is back to zero
+		void Schedule(std::function<void()> function, JobCounter& dependency, JobCounter* counter = nullptr);
+
+		void ScheduleOnMainThread(std::function<void()> function, JobCounter* counter = nullptr);
+
+		// function(first, last) over [0, count) in chunks of grainSize.
+		// Without a counter it returns once every chunk is done, the calling thread takes part.
+		template<typename F>
+		void ParallelFor(uint32_t count, uint32_t grainSize, F&& function, JobCounter* counter = nullptr);
+
+		// Suspends the calling job on a fiber, otherwise runs other jobs, and on a worker resumes its
+		// suspended fibers, until the wait is over
+		void Wait(JobCounter& counter);
+		void WaitUntil(const std::function<bool()>& condition);
+
+		// Until a timeline semaphore reaches value, e.g. VulkanRenderer::GetFrameTimeline
+		void Wait(VkDevice device, VkSemaphore timelineSemaphore, uint64_t value);
+
+		// Main thread only
+		void RunMainThreadJobs();
+
+		// Finishes every queued job and joins the workers
+		void Shutdown();
+
+		uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Queues.size()); }
+		bool	 UsesFibers()	  const { return m_Fibers != nullptr; }
+
+		// 0 for the main thread, GetThreadCount() on the render thread, kExternalThread outside the system
+		static uint32_t GetThreadIndex() { return s_ThreadIndex; }
+		static bool		IsMainThread() { return s_ThreadIndex == 0; }
+
+		// Calling thread only. The render thread gets the slot after the workers' in per-thread recording state
+		// (CommandBucket, ThreadCommandPools), any other thread outside the system has none.
+		void RegisterRenderThread() const { s_ThreadIndex = GetThreadCount(); }
+
+		static constexpr uint32_t kExternalThread = ~0u;
+
+	private:
+		friend class FiberScheduler;
+
+		void Submit(Job* job);
+		void Execute(Job* job);
+
+		// Own deque first, then the external queue, then the other deques
+		Job* FindJob(uint32_t threadIndex);
+		bool RunMainThreadJob();
+
+		void WorkerLoop(uint32_t threadIndex);
+		void WakeWorker();
+
+	private:
+		static constexpr uint32_t kQueueCapacity = 4096;
+
+		using JobQueue = WorkStealingDeque<Job*, kQueueCapacity>;
+
+		std::vector<std::unique_ptr<JobQueue>>	m_Queues; // index 0 is the main thread
+		std::vector<std::thread>				m_Workers;
+		std::unique_ptr<FiberScheduler>			m_Fibers;
+
+		std::mutex								m_ExternalMutex;
+		std::deque<Job*>						m_ExternalJobs;	// from threads outside the system and full deques
+
+		std::mutex								m_MainThreadMutex;
+		std::deque<Job*>						m_MainThreadJobs;
+
+		// Workers with nothing to steal sleep until a job is scheduled
+		std::mutex								m_SleepMutex;
+		std::condition_variable					m_SleepCondition;
+		std::atomic<int32_t>					m_QueuedJobs{ 0 }; // briefly negative when a job is taken before Submit counts it
+		std::atomic<uint32_t>					m_SleepingWorkers{ 0 };
+		std::atomic<bool>						m_Stop{ false };
+
+		static inline thread_local uint32_t		s_ThreadIndex{ kExternalThread };
+	};
+
+	template<typename F>
+	void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, F&& function, JobCounter* counter)
+	{
+		if (count == 0)
+			return;
+
+		grainSize = std::max(1u, grainSize);
+
+		if (counter)
+		{
+			for (uint32_t first = 0; first < count; first += grainSize)
+			{
+				uint32_t last = std::min(count, first + grainSize);
+				Schedule([function, first, last]() { function(first, last); }, counter);
+			}
+			return;
+		}
+
+		// The caller's function outlives the jobs, which only reference it
+		JobCounter localCounter;
+		for (uint32_t first = grainSize; first < count; first += grainSize)
+		{
+			uint32_t last = std::min(count, first + grainSize);
+			Schedule([&function, first, last]() { function(first, last); }, &localCounter);
+		}
+
+		function(0u, std::min(count, grainSize));
+		Wait(localCounter);
+	}
+
+}
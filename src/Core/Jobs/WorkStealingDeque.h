@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+
+namespace VulkanEngine {
+
+	// Fixed capacity Chase-Lev deque (Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models").
+	// The owning thread pushes and pops at the bottom, any other thread steals from the top, all without locks.
+	// T is a pointer, nullptr means empty or a lost race.
+	template<typename T, uint32_t Capacity>
+	class WorkStealingDeque
+	{
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	public:
+		WorkStealingDeque() = default;
+		WorkStealingDeque(const WorkStealingDeque&)				= delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&)	= delete;
+
+		// Owner only, false when full
+		bool Push(T item)
+		{
+			int64_t bottom	= m_Bottom.load(std::memory_order_relaxed);
+			int64_t top		= m_Top.load(std::memory_order_acquire);
+			if (bottom - top >= static_cast<int64_t>(Capacity))
+				return false;
+
+			m_Items[bottom & kMask].store(item, std::memory_order_relaxed);
+			m_Bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Owner only, newest first
+		T Pop()
+		{
+			int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+			m_Bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t top = m_Top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T item = m_Items[bottom & kMask].load(std::memory_order_relaxed);
+
+			// Last item, race the thieves for it
+			if (top == bottom)
+			{
+				if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					item = nullptr;
+
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+
+			return item;
+		}
+
+		// Any thread, oldest first
+		T Steal()
+		{
+			int64_t top = m_Top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+			if (top >= bottom)
+				return nullptr;
+
+			T item = m_Items[top & kMask].load(std::memory_order_relaxed);
+			if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+
+			return item;
+		}
+
+		bool IsEmpty() const
+		{
+			return m_Bottom.load(std::memory_order_relaxed) <= m_Top.load(std::memory_order_relaxed);
+		}
+
+	private:
+		static constexpr int64_t kMask = Capacity - 1;
+
+		// Apart so the owner and the thieves don't share a cache line
+		alignas(64) std::atomic<int64_t>	m_Top{ 0 };
+		alignas(64) std::atomic<int64_t>	m_Bottom{ 0 };
+		alignas(64) std::array<std::atomic<T>, Capacity> m_Items{};
+	};
+
+}
@@ -24,12 +24,27 @@ namespace VulkanEngine {
 		VulkanEngine_INFO(fmt::runtime("Layer: {0} detached!"), m_Name);
 	}
 
-	void Layer::OnUpdate()
+	void Layer::OnEvent()
 	{
 
 	}
 
-	void Layer::OnEvent()
+	void Layer::OnSimulate()
+	{
+
+	}
+
+	void Layer::OnPrepareRender(FramePacket& packet)
+	{
+
+	}
+
+	void Layer::OnRecord(const FramePacket& packet)
+	{
+
+	}
+
+	void Layer::OnImGuiRender()
 	{
 
 	}
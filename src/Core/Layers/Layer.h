@@ -1,10 +1,26 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 
 namespace VulkanEngine {
 
+	class FramePacket;
+
+	// Per frame, in this order. Every phase ends before the next one starts, BeginFrame runs between
+	// PrepareRender and Record.
+	enum class LayerPhase : uint8_t
+	{
+		Simulate		= 1 << 0,
+		PrepareRender	= 1 << 1,
+		Record			= 1 << 2
+	};
+
+	// Layers run by LayerScheduler: within a phase, layers that don't depend on each other run in parallel
+	// on the job system. In Record, layers using the render targets record one after another in stack order.
+	// A layer only gets the phases it declares. OnImGuiRender always runs on the main thread.
 	class Layer
 	{
 	public:
@@ -13,13 +29,52 @@ namespace VulkanEngine {
 
 		virtual void OnAttach();
 		virtual void OnDetach();
-		virtual void OnUpdate();
 		virtual void OnEvent();
 
+		virtual void OnSimulate();
+
+		// What Record needs goes into the packet (FramePacket::SetLayerData): with the render thread,
+		// Record runs while the next frame simulates
+		virtual void OnPrepareRender(FramePacket& packet);
+
+		// Into the layer's command stream through the VulkanRenderer render commands, raw commands go to
+		// VulkanRenderer::GetCommandBuffer(). Waits only through VulkanRenderer::RecordParallel.
+		virtual void OnRecord(const FramePacket& packet);
+
+		virtual void OnImGuiRender();
+
 		std::string GetName() const { return m_Name; }
 
+		bool HasPhase(LayerPhase phase) const { return (m_Phases & static_cast<uint8_t>(phase)) != 0; }
+		bool IsMainThreadOnly()			const { return m_MainThreadOnly; }
+		bool UsesRenderTargets()		const { return m_UsesRenderTargets; }
+		const std::vector<std::string>& GetDependencies() const { return m_Dependencies; }
+
+	protected:
+		void DeclarePhase(LayerPhase phase) { m_Phases |= static_cast<uint8_t>(phase); }
+
+		// Every phase of this layer starts after that layer's is done, e.g. when one reads what the other wrote.
+		// Ordering against the render and depth targets doesn't need it, see SetUsesRenderTargets.
+		void DependsOn(std::string layerName) { m_Dependencies.push_back(std::move(layerName)); }
+
+		// For layers calling into GLFW or anything else bound to the main thread, in Simulate and PrepareRender.
+		// Record runs on the recording thread, the render thread when Application has one: such a layer records
+		// there inline, never on a worker, and must not touch GLFW from OnRecord.
+		void SetMainThreadOnly(bool mainThreadOnly) { m_MainThreadOnly = mainThreadOnly; }
+
+		// VulkanRenderer::Clear, BeginRendering, Dispatch and DispatchIndirect track the render and depth target
+		// layouts as they record, so layers using them record serially in stack order, the order their streams
+		// execute in. Only a layer that never calls those may opt out and record in parallel.
+		void SetUsesRenderTargets(bool usesRenderTargets) { m_UsesRenderTargets = usesRenderTargets; }
+
 	protected:
 		std::string m_Name = "Unknown";
+
+	private:
+		uint8_t						m_Phases = 0;
+		bool						m_MainThreadOnly = false;
+		bool						m_UsesRenderTargets = true;
+		std::vector<std::string>	m_Dependencies;
 	};
 
-}
\ No newline at end of file
+}
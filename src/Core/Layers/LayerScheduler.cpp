@@ -0,0 +1,201 @@
+#include "Core/Layers/LayerScheduler.h"
+#include "Core/LogSystem.h"
+
+#include <algorithm>
+
+
+namespace VulkanEngine {
+
+	LayerScheduler::LayerScheduler(const LayerStack& layerStack, JobSystem& jobSystem)
+		: m_LayerStack(layerStack), m_JobSystem(jobSystem)
+	{
+
+	}
+
+	void LayerScheduler::Run(LayerPhase phase, FramePacket& packet)
+	{
+		if (phase != LayerPhase::Record)
+			Rebuild();
+
+		std::vector<uint32_t> parallel;
+		std::vector<uint32_t> mainThread;
+
+		for (const auto& level : phase == LayerPhase::Record ? m_RecordLevels : m_Levels)
+		{
+			parallel.clear();
+			mainThread.clear();
+
+			for (uint32_t index : level)
+			{
+				if (!m_Layers[index]->HasPhase(phase))
+					continue;
+
+				if (m_Layers[index]->IsMainThreadOnly())
+					mainThread.push_back(index);
+				else
+					parallel.push_back(index);
+			}
+
+			// A single layer runs inline, no point paying for a job
+			if (parallel.size() == 1 && mainThread.empty())
+			{
+				RunLayer(parallel[0], phase, packet);
+				continue;
+			}
+
+			JobCounter counter;
+			for (uint32_t index : parallel)
+			{
+				m_JobSystem.Schedule([this, index, phase, &packet]()
+					{
+						RunLayer(index, phase, packet);
+					}, &counter);
+			}
+
+			// Inline on the caller: the main thread, or for Record the recording thread (Layer::SetMainThreadOnly)
+			for (uint32_t index : mainThread)
+				RunLayer(index, phase, packet);
+
+			m_JobSystem.Wait(counter);
+		}
+
+		if (phase != LayerPhase::Record)
+			return;
+
+		// Stack order, whichever thread recorded what
+		for (size_t i = 0; i < m_Layers.size(); ++i)
+		{
+			if (m_Layers[i]->HasPhase(LayerPhase::Record))
+				VulkanRenderer::ExecuteStream(m_Streams[i]);
+		}
+	}
+
+	void LayerScheduler::RunImGui()
+	{
+		for (auto it = m_LayerStack.begin(); it != m_LayerStack.end(); it++)
+		{
+			(*it)->OnImGuiRender();
+		}
+	}
+
+	void LayerScheduler::Rebuild()
+	{
+		bool changed = m_Layers.size() != static_cast<size_t>(std::distance(m_LayerStack.begin(), m_LayerStack.end()));
+		for (size_t i = 0; !changed && i < m_Layers.size(); ++i)
+			changed = m_Layers[i] != (m_LayerStack.begin() + i)->get();
+
+		if (!changed)
+			return;
+
+		m_Layers.clear();
+		for (auto it = m_LayerStack.begin(); it != m_LayerStack.end(); it++)
+			m_Layers.push_back(it->get());
+
+		m_Streams.resize(m_Layers.size());
+
+		// Every Record layer on the render targets waits for the one below it in the stack
+		m_PreviousTargetUser.assign(m_Layers.size(), ~0u);
+		uint32_t previous = ~0u;
+		for (uint32_t i = 0; i < m_Layers.size(); ++i)
+		{
+			if (!m_Layers[i]->HasPhase(LayerPhase::Record) || !m_Layers[i]->UsesRenderTargets())
+				continue;
+
+			m_PreviousTargetUser[i] = previous;
+			previous = i;
+		}
+
+		m_Levels		= BuildLevels(false);
+		m_RecordLevels	= BuildLevels(true);
+
+		VulkanEngine_INFO(fmt::runtime("Layer scheduler: {} layers in {} levels, {} for Record"), m_Layers.size(), m_Levels.size(), m_RecordLevels.size());
+	}
+
+	std::vector<std::vector<uint32_t>> LayerScheduler::BuildLevels(bool record)
+	{
+		std::vector<uint32_t>	levels(m_Layers.size(), ~0u);
+		std::vector<bool>		visiting(m_Layers.size(), false);
+
+		std::vector<std::vector<uint32_t>> result;
+		for (uint32_t i = 0; i < m_Layers.size(); ++i)
+		{
+			uint32_t level = ResolveLevel(i, record, levels, visiting);
+			if (level >= result.size())
+				result.resize(level + 1);
+
+			result[level].push_back(i);
+		}
+
+		return result;
+	}
+
+	uint32_t LayerScheduler::ResolveLevel(uint32_t layerIndex, bool record, std::vector<uint32_t>& levels, std::vector<bool>& visiting)
+	{
+		if (levels[layerIndex] != ~0u)
+			return levels[layerIndex];
+
+		visiting[layerIndex] = true;
+
+		uint32_t level = 0;
+		for (const std::string& dependency : m_Layers[layerIndex]->GetDependencies())
+		{
+			auto it = std::find_if(m_Layers.begin(), m_Layers.end(),
+				[&dependency](const Layer* layer)
+				{
+					return layer->GetName() == dependency;
+				});
+
+			if (it == m_Layers.end())
+			{
+				VulkanEngine_WARN(fmt::runtime("Layer {} depends on {}, which is not in the stack"), m_Layers[layerIndex]->GetName(), dependency);
+				continue;
+			}
+
+			uint32_t dependencyIndex = static_cast<uint32_t>(std::distance(m_Layers.begin(), it));
+			if (visiting[dependencyIndex])
+			{
+				VulkanEngine_ERROR(fmt::runtime("Layer dependency cycle between {} and {}, ignoring it"), m_Layers[layerIndex]->GetName(), dependency);
+				continue;
+			}
+
+			level = std::max(level, ResolveLevel(dependencyIndex, record, levels, visiting) + 1);
+		}
+
+		uint32_t previousTargetUser = record ? m_PreviousTargetUser[layerIndex] : ~0u;
+		if (previousTargetUser != ~0u)
+		{
+			// Only a dependency on a layer higher in the stack can close this loop
+			if (visiting[previousTargetUser])
+				VulkanEngine_ERROR(fmt::runtime("Layer {} depends on a layer above it while both use the render targets, recording out of stack order"), m_Layers[previousTargetUser]->GetName());
+			else
+				level = std::max(level, ResolveLevel(previousTargetUser, record, levels, visiting) + 1);
+		}
+
+		visiting[layerIndex] = false;
+		levels[layerIndex] = level;
+		return level;
+	}
+
+	void LayerScheduler::RunLayer(uint32_t layerIndex, LayerPhase phase, FramePacket& packet)
+	{
+		Layer& layer = *m_Layers[layerIndex];
+
+		switch (phase)
+		{
+		case LayerPhase::Simulate:
+			layer.OnSimulate();
+			break;
+
+		case LayerPhase::PrepareRender:
+			layer.OnPrepareRender(packet);
+			break;
+
+		case LayerPhase::Record:
+			VulkanRenderer::BeginStream(m_Streams[layerIndex]);
+			layer.OnRecord(packet);
+			VulkanRenderer::EndStream();
+			break;
+		}
+	}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Core/Layers/LayerStack.h"
+#include "Core/Jobs/JobSystem.h"
+#include "Core/RenderThread/FramePacket.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+
+
+namespace VulkanEngine {
+
+	// Runs one layer phase at a time across the job system. Layers are grouped into levels by their
+	// dependencies: a level runs in parallel and only starts once the levels before it are done.
+	// For Record, every layer records its own command stream from the recording thread's pools, executed
+	// afterwards in stack order into the frame's primary, so the result doesn't depend on which thread
+	// finished first. Layers using the render targets (Layer::SetUsesRenderTargets) are chained in stack
+	// order for Record, each one's barriers picking up the target layouts the previous one left.
+	// Called from the main thread, Record from the render thread when there is one.
+	class LayerScheduler
+	{
+	public:
+		LayerScheduler(const LayerStack& layerStack, JobSystem& jobSystem);
+		virtual ~LayerScheduler() = default;
+
+		// Record needs VulkanRenderer::BeginFrame first and runs from the recording thread, main thread only
+		// layers included
+		void Run(LayerPhase phase, FramePacket& packet);
+
+		// Main thread, stack order
+		void RunImGui();
+
+	private:
+		// Main thread, the render thread is idle whenever the stack changes (Application::PushLayer)
+		void Rebuild();
+		std::vector<std::vector<uint32_t>> BuildLevels(bool record);
+		uint32_t ResolveLevel(uint32_t layerIndex, bool record, std::vector<uint32_t>& levels, std::vector<bool>& visiting);
+
+		void RunLayer(uint32_t layerIndex, LayerPhase phase, FramePacket& packet);
+
+	private:
+		const LayerStack&			m_LayerStack;
+		JobSystem&					m_JobSystem;
+
+		std::vector<Layer*>					m_Layers;		// stack order, as of the last rebuild
+		std::vector<CommandStream>			m_Streams;		// parallel to m_Layers
+		std::vector<std::vector<uint32_t>>	m_Levels;		// indices into m_Layers
+		std::vector<std::vector<uint32_t>>	m_RecordLevels;	// m_Levels plus the render target chain
+		std::vector<uint32_t>				m_PreviousTargetUser;	// parallel to m_Layers, ~0u for none
+	};
+
+}
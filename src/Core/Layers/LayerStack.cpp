@@ -67,6 +67,15 @@ namespace VulkanEngine {
 		}
 	}
 
+	void LayerStack::Clear()
+	{
+		for (auto it = m_Layers.rbegin(); it != m_Layers.rend(); ++it)
+			(*it)->OnDetach();
+
+		m_Layers.clear();
+		m_LayerInsertIndex = 0;
+	}
+
 	bool LayerStack::IsPresent(std::shared_ptr<Layer> layer)
 	{
 		return std::find_if(m_Layers.begin(), m_Layers.end(),
@@ -18,6 +18,9 @@ namespace VulkanEngine {
 		void RemoveLayer(std::string layerName);
 		void RemoveOverlay(std::string overlayName);
 
+		// Detaches everything, overlays first
+		void Clear();
+
 		auto rbegin()	const { return m_Layers.rbegin();	}
 		auto rend()		const { return m_Layers.rend();		}
 		auto begin()	const { return m_Layers.begin();	}
@@ -2,16 +2,11 @@
 
 namespace VulkanEngine {
 
-	void LifetimeManager::PushFunction(std::function<void()>&& function)
-	{
-		m_Deletors.push_back(std::move(function));
-	}
-
 	void LifetimeManager::Flush()
 	{
 		for (auto it = m_Deletors.rbegin(); it != m_Deletors.rend(); ++it) 
 		{
-			(*it)();
+			it->invoke(it->storage);
 		}
 
 		m_Deletors.clear();
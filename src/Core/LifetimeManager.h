@@ -1,12 +1,19 @@
 ﻿#pragma once
 
 #include <vector>
-#include <functional>
 #include <algorithm>
+#include <cstddef>
+#include <new>
+#include <mutex>
+#include <type_traits>
+#include <utility>
 
 
 namespace VulkanEngine {
 
+	// Shutdown teardown, in reverse push order. Deleters are stored inline, a destroy function and its
+	// handles, without a heap allocation each. Resources freed while running go through
+	// VulkanRenderer::GetDeletionQueue instead.
 	class LifetimeManager
 	{
 	public:
@@ -15,20 +22,49 @@ namespace VulkanEngine {
 		LifetimeManager& operator=(const LifetimeManager&)	= delete;
 		virtual ~LifetimeManager() = default;
 
-		void PushFunction(std::function<void()>&& function);
 		void Flush();
 
+		// A function or a lambda capturing handles and pointers only
+		template<typename F>
+		void PushFunction(F&& function)
+		{
+			using Function = std::decay_t<F>;
+			static_assert(std::is_trivially_copyable_v<Function>, "Deleters capture handles and pointers only");
+			static_assert(sizeof(Function) <= kStorageSize && alignof(Function) <= alignof(std::max_align_t),
+				"Deleter captures too much");
+
+			Deletor deletor;
+			deletor.invoke = [](const std::byte* storage)
+				{
+					(*std::launder(reinterpret_cast<const Function*>(storage)))();
+				};
+			new (deletor.storage) Function(std::forward<F>(function));
+
+			std::lock_guard lock(m_Mutex);
+			m_Deletors.push_back(deletor);
+		}
+
 		template<typename F, typename... Args>
 		void Push(F&& function, Args&&... args) 
 		{
-			PushFunction([=]() 
+			PushFunction([function, args...]() 
 				{
 					function(args...);
 				});
 		}
 
 	private:
-		std::vector<std::function<void()>> m_Deletors;
+		static constexpr size_t kStorageSize = 48; // a destroy function and three handles
+
+		struct Deletor
+		{
+			void (*invoke)(const std::byte* storage){ nullptr };
+			alignas(std::max_align_t) std::byte storage[kStorageSize];
+		};
+
+	private:
+		std::mutex				m_Mutex; // resources can be created off the main thread (hot reload)
+		std::vector<Deletor>	m_Deletors;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "Core/RenderThread/FramePacket.h"
+#include "Core/LogSystem.h"
+
+#include <algorithm>
+
+
+namespace VulkanEngine {
+
+	FramePacket::~FramePacket()
+	{
+		ReleaseImGui();
+	}
+
+	void FramePacket::Reset(uint64_t frameNumber)
+	{
+		m_FrameNumber = frameNumber;
+		timing = {};
+
+		m_LayerData.clear();
+		m_LayerEntries.clear();
+		m_Commands.clear();
+
+		ReleaseImGui();
+	}
+
+	void FramePacket::SetLayerData(const Layer& layer, const void* data, size_t size, size_t alignment)
+	{
+		std::lock_guard lock(m_Mutex);
+
+		// Offsets aligned for the type, the buffer itself comes from operator new
+		size_t offset = (m_LayerData.size() + alignment - 1) / alignment * alignment;
+
+		auto it = std::find_if(m_LayerEntries.begin(), m_LayerEntries.end(),
+			[&layer](const LayerDataEntry& entry)
+			{
+				return entry.layer == &layer;
+			});
+
+		if (it != m_LayerEntries.end() && it->size == size)
+		{
+			std::memcpy(m_LayerData.data() + it->offset, data, size);
+			return;
+		}
+
+		m_LayerData.resize(offset + size);
+		std::memcpy(m_LayerData.data() + offset, data, size);
+
+		if (it != m_LayerEntries.end())
+			*it = { &layer, offset, size };
+		else
+			m_LayerEntries.push_back({ &layer, offset, size });
+	}
+
+	const void* FramePacket::GetLayerData(const Layer& layer, size_t size) const
+	{
+		for (const LayerDataEntry& entry : m_LayerEntries)
+		{
+			if (entry.layer != &layer)
+				continue;
+
+			if (entry.size != size)
+			{
+				VulkanEngine_ERROR("Frame packet layer data read as a different type than it was written");
+				return nullptr;
+			}
+
+			return m_LayerData.data() + entry.offset;
+		}
+
+		return nullptr;
+	}
+
+	void FramePacket::Enqueue(std::function<void()> command)
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Commands.push_back(std::move(command));
+	}
+
+	void FramePacket::RunCommands()
+	{
+		for (auto& command : m_Commands)
+			command();
+
+		m_Commands.clear();
+	}
+
+	void FramePacket::CaptureImGui(ImDrawData* drawData)
+	{
+		ReleaseImGui();
+
+		if (!drawData || !drawData->Valid)
+			return;
+
+		// The context reuses its lists next frame
+		m_ImGuiDrawData = *drawData;
+		for (ImDrawList*& list : m_ImGuiDrawData.CmdLists)
+			list = list->CloneOutput();
+
+		// Shared with the context, only kept when the backend has something to upload
+		bool texturesChanged = false;
+		if (drawData->Textures)
+		{
+			for (ImTextureData* texture : *drawData->Textures)
+				texturesChanged |= texture->Status != ImTextureStatus_OK;
+		}
+
+		if (!texturesChanged)
+			m_ImGuiDrawData.Textures = nullptr;
+	}
+
+	void FramePacket::ReleaseImGui()
+	{
+		if (!m_ImGuiDrawData.Valid)
+			return;
+
+		for (ImDrawList* list : m_ImGuiDrawData.CmdLists)
+			IM_DELETE(list);
+
+		m_ImGuiDrawData.Clear();
+	}
+
+}
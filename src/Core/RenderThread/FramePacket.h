@@ -0,0 +1,104 @@
+#pragma once
+
+#include <imgui.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+
+namespace VulkanEngine {
+
+	class Layer;
+
+	// What the main thread hands to whoever records the frame: the layers' render data, commands to run
+	// before recording and the ImGui draw lists. With the render thread the main thread fills the next
+	// packet while the previous one renders, so Record reads the packet instead of the layers' own state.
+	class FramePacket
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct Timing
+		{
+			Clock::time_point begin;		// main thread starts the frame
+			Clock::time_point published;	// handed to the render thread
+			Clock::time_point recordBegin;	// render thread picks it up
+			Clock::time_point submitted;	// presented
+		};
+
+		FramePacket() = default;
+		virtual ~FramePacket();
+		FramePacket(const FramePacket&)				= delete;
+		FramePacket& operator=(const FramePacket&)	= delete;
+
+		// Main thread, before the packet is filled
+		void Reset(uint64_t frameNumber);
+
+		// PrepareRender, any thread: plain data copied into the packet, one value per layer
+		template<typename T>
+		void SetLayerData(const Layer& layer, const T& data);
+
+		// Record: null when the layer set nothing this frame
+		template<typename T>
+		const T* GetLayerData(const Layer& layer) const;
+
+		// Run on the recording thread after BeginFrame, in the order they were enqueued
+		void Enqueue(std::function<void()> command);
+		void RunCommands();
+
+		// Main thread, after ImGui::Render: a copy of the draw lists that stays valid until Reset
+		void CaptureImGui(ImDrawData* drawData);
+		ImDrawData* GetImGuiDrawData() { return m_ImGuiDrawData.Valid ? &m_ImGuiDrawData : nullptr; }
+
+		// The ImGui backend uploads these while recording, the main thread must not touch them meanwhile
+		bool HasImGuiTextureUpdates() const { return m_ImGuiDrawData.Textures != nullptr; }
+
+		uint64_t GetFrameNumber() const { return m_FrameNumber; }
+
+	public:
+		Timing timing;
+
+	private:
+		void SetLayerData(const Layer& layer, const void* data, size_t size, size_t alignment);
+		const void* GetLayerData(const Layer& layer, size_t size) const;
+
+		void ReleaseImGui();
+
+	private:
+		struct LayerDataEntry
+		{
+			const Layer*	layer{ nullptr };
+			size_t			offset{ 0 };
+			size_t			size{ 0 };
+		};
+
+		uint64_t							m_FrameNumber{ 0 };
+
+		std::mutex							m_Mutex; // layers prepare in parallel
+		std::vector<std::byte>				m_LayerData;
+		std::vector<LayerDataEntry>			m_LayerEntries;
+		std::vector<std::function<void()>>	m_Commands;
+
+		ImDrawData							m_ImGuiDrawData; // owns cloned lists
+	};
+
+	template<typename T>
+	void FramePacket::SetLayerData(const Layer& layer, const T& data)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Layer data is copied into the packet as bytes");
+		SetLayerData(layer, &data, sizeof(T), alignof(T));
+	}
+
+	template<typename T>
+	const T* FramePacket::GetLayerData(const Layer& layer) const
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Layer data is copied into the packet as bytes");
+		return static_cast<const T*>(GetLayerData(layer, sizeof(T)));
+	}
+
+}
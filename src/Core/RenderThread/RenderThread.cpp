@@ -0,0 +1,135 @@
+#include "Core/RenderThread/RenderThread.h"
+#include "Core/LogSystem.h"
+
+#include <algorithm>
+
+
+namespace VulkanEngine {
+
+	RenderThread::RenderThread(uint32_t maxQueuedFrames, RenderFunction render)
+		: m_Render(std::move(render))
+	{
+		// One more for the main thread to fill
+		uint32_t packetCount = std::max(1u, maxQueuedFrames) + 1;
+
+		for (uint32_t i = 0; i < packetCount; ++i)
+		{
+			m_Packets.push_back(std::make_unique<FramePacket>());
+			m_Free.push_back(m_Packets.back().get());
+		}
+
+		m_Thread = std::thread(&RenderThread::Loop, this);
+
+		VulkanEngine_INFO(fmt::runtime("Render thread started, up to {} queued frames"), packetCount - 1);
+	}
+
+	RenderThread::~RenderThread()
+	{
+		Stop();
+	}
+
+	FramePacket& RenderThread::AcquirePacket()
+	{
+		std::unique_lock lock(m_Mutex);
+
+		if (m_Free.empty())
+		{
+			m_Latency.stalls++;
+			m_Condition.wait(lock, [this]() { return !m_Free.empty(); });
+		}
+
+		FramePacket* packet = m_Free.front();
+		m_Free.pop_front();
+		return *packet;
+	}
+
+	void RenderThread::Publish(FramePacket& packet)
+	{
+		packet.timing.published = FramePacket::Clock::now();
+
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Queued.push_back(&packet);
+		}
+		m_Condition.notify_all();
+	}
+
+	void RenderThread::WaitIdle()
+	{
+		std::unique_lock lock(m_Mutex);
+		m_Condition.wait(lock, [this]() { return m_Queued.empty() && !m_Rendering; });
+	}
+
+	void RenderThread::Stop()
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Stop = true;
+		}
+		m_Condition.notify_all();
+
+		if (m_Thread.joinable())
+			m_Thread.join();
+	}
+
+	FrameLatency RenderThread::GetLatency() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Latency;
+	}
+
+	void RenderThread::Loop()
+	{
+		while (true)
+		{
+			FramePacket* packet = nullptr;
+			{
+				std::unique_lock lock(m_Mutex);
+				m_Condition.wait(lock, [this]() { return m_Stop || !m_Queued.empty(); });
+
+				// Stopping renders what is already published
+				if (m_Queued.empty())
+					break;
+
+				packet = m_Queued.front();
+				m_Queued.pop_front();
+				m_Rendering = true;
+			}
+
+			packet->timing.recordBegin = FramePacket::Clock::now();
+			m_Render(*packet);
+			packet->timing.submitted = FramePacket::Clock::now();
+
+			{
+				std::lock_guard lock(m_Mutex);
+				AccountLatency(*packet);
+
+				m_Free.push_back(packet);
+				m_Rendering = false;
+			}
+			m_Condition.notify_all();
+		}
+	}
+
+	void RenderThread::AccountLatency(const FramePacket& packet)
+	{
+		auto milliseconds = [](FramePacket::Clock::time_point from, FramePacket::Clock::time_point to)
+			{
+				return std::chrono::duration<double, std::milli>(to - from).count();
+			};
+
+		// Smooths over about ten frames
+		constexpr double weight = 0.1;
+		auto accumulate = [](double& average, double sample)
+			{
+				average = average == 0.0 ? sample : average + (sample - average) * weight;
+			};
+
+		const FramePacket::Timing& timing = packet.timing;
+		accumulate(m_Latency.mainThread,	milliseconds(timing.begin, timing.published));
+		accumulate(m_Latency.queued,		milliseconds(timing.published, timing.recordBegin));
+		accumulate(m_Latency.render,		milliseconds(timing.recordBegin, timing.submitted));
+		accumulate(m_Latency.total,			milliseconds(timing.begin, timing.submitted));
+	}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Core/RenderThread/FramePacket.h"
+
+
+namespace VulkanEngine {
+
+	struct RenderThreadSpecification
+	{
+		bool		enabled			= false;
+		uint32_t	maxQueuedFrames = 1; // published but not yet rendered, the one rendering included
+	};
+
+	// Moving averages in milliseconds
+	struct FrameLatency
+	{
+		double mainThread	= 0.0;	// frame begin to publish
+		double queued		= 0.0;	// publish to the render thread picking it up
+		double render		= 0.0;	// record, submit and present
+		double total		= 0.0;	// frame begin to present
+		uint64_t stalls		= 0;	// main thread waited for a free packet
+	};
+
+	// Records, submits and presents frames on its own thread, so a present blocking on vsync doesn't hold
+	// up the main thread. The main thread fills a packet, publishes it and moves on to the next frame; with
+	// maxQueuedFrames published it waits, which bounds the latency the queue can add.
+	class RenderThread
+	{
+	public:
+		using RenderFunction = std::function<void(FramePacket& packet)>;
+
+		RenderThread(uint32_t maxQueuedFrames, RenderFunction render);
+		virtual ~RenderThread();
+		RenderThread(const RenderThread&)				= delete;
+		RenderThread& operator=(const RenderThread&)	= delete;
+
+		// Main thread: the packet to fill next, blocks while maxQueuedFrames are waiting
+		FramePacket& AcquirePacket();
+		void Publish(FramePacket& packet);
+
+		// Until every published packet is rendered, e.g. before the layer stack changes
+		void WaitIdle();
+
+		// Renders what is published, then joins
+		void Stop();
+
+		FrameLatency GetLatency() const;
+
+	private:
+		void Loop();
+		void AccountLatency(const FramePacket& packet);
+
+	private:
+		RenderFunction							m_Render;
+		std::vector<std::unique_ptr<FramePacket>> m_Packets; // double-buffered with one queued frame
+
+		mutable std::mutex						m_Mutex;
+		std::condition_variable					m_Condition;
+		std::deque<FramePacket*>				m_Free;
+		std::deque<FramePacket*>				m_Queued;
+		bool									m_Rendering{ false };
+		bool									m_Stop{ false };
+
+		FrameLatency							m_Latency;
+		std::thread								m_Thread;
+	};
+
+}
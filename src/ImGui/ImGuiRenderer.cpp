@@ -35,14 +35,16 @@ namespace VulkanEngine {
 		ImGui::NewFrame();
 
 		ImGui::ShowDemoWindow();
-
-		ImGui::Render();
 	}
 
-	void ImGuiRenderer::EndImGuiFrame(VkCommandBuffer cmd, AllocatedImage& renderTarget)
+	ImDrawData* ImGuiRenderer::EndImGuiFrame()
 	{
 		ImGui::Render();
+		return ImGui::GetDrawData();
+	}
 
+	void ImGuiRenderer::RecordImGui(VkCommandBuffer cmd, AllocatedImage& renderTarget, ImDrawData* drawData)
+	{
 		VulkanUtils::InsertImageMemoryBarrier(
 			cmd,
 			renderTarget.image,
@@ -64,7 +66,7 @@ namespace VulkanEngine {
 		);
 
 		vkCmdBeginRendering(cmd, &renderingInfo);
-		ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
+		ImGui_ImplVulkan_RenderDrawData(drawData, cmd);
 		vkCmdEndRendering(cmd);
 	}
 
@@ -73,26 +75,18 @@ namespace VulkanEngine {
 		auto* ctx		 = VulkanContext::GetRaw();
 		VkDevice device  = *ctx->GetDevice();
 
-		constexpr uint32_t kPoolSize = 1000;
-
-		const std::array<VkDescriptorPoolSize, 11> poolSizes = { {
-			{.type = VK_DESCRIPTOR_TYPE_SAMPLER,                .descriptorCount = kPoolSize },
-			{.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = kPoolSize },
-			{.type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,          .descriptorCount = kPoolSize },
-			{.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          .descriptorCount = kPoolSize },
-			{.type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,   .descriptorCount = kPoolSize },
-			{.type = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER,   .descriptorCount = kPoolSize },
-			{.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,         .descriptorCount = kPoolSize },
-			{.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         .descriptorCount = kPoolSize },
-			{.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, .descriptorCount = kPoolSize },
-			{.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, .descriptorCount = kPoolSize },
-			{.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,       .descriptorCount = kPoolSize }
+		// The Vulkan backend only allocates combined image samplers: one for the font atlas
+		// and one per texture passed to ImGui::Image
+		constexpr uint32_t kMaxTextures = 16;
+
+		const std::array<VkDescriptorPoolSize, 1> poolSizes = { {
+			{.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = kMaxTextures }
 		} };
 
 		const VkDescriptorPoolCreateInfo poolInfo = {
 			.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
 			.flags			= VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
-			.maxSets		= kPoolSize * static_cast<uint32_t>(poolSizes.size()),
+			.maxSets		= kMaxTextures,
 			.poolSizeCount	= static_cast<uint32_t>(poolSizes.size()),
 			.pPoolSizes		= poolSizes.data(),
 		};
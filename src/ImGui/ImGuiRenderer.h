@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include <vulkan/vulkan.h>
+#include <imgui.h>
 #include "VulkanAbstraction/VulkanSwapchain.h"
 
 namespace VulkanEngine {
@@ -13,8 +14,11 @@ namespace VulkanEngine {
 		ImGuiRenderer(const ImGuiRenderer&)				= delete;
 		ImGuiRenderer& operator=(const ImGuiRenderer&)	= delete;
 
+		// Main thread, the ImGui calls of the frame go in between
 		void BeginImGuiFrame();
-		void EndImGuiFrame(VkCommandBuffer cmd, AllocatedImage& swapchainImage);
+		ImDrawData* EndImGuiFrame();
+
+		void RecordImGui(VkCommandBuffer cmd, AllocatedImage& renderTarget, ImDrawData* drawData);
 
 	private:
 		void InitImGuiCore();
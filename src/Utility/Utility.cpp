@@ -1,5 +1,16 @@
 ﻿#include "Utility/Utility.h"
 
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
 namespace VulkanEngine {
 
 	namespace FilesystemUtils
@@ -39,6 +50,119 @@ namespace VulkanEngine {
 				return buffer.str();
 			}
 		}
+
+		MappedFile::~MappedFile()
+		{
+			Close();
+		}
+
+		bool MappedFile::Open(const std::filesystem::path& filepath)
+		{
+			Close();
+
+#ifdef _WIN32
+			HANDLE file = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+				OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+				return false;
+
+			LARGE_INTEGER fileSize{};
+			if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+			{
+				CloseHandle(file);
+				return false;
+			}
+
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping)
+			{
+				CloseHandle(file);
+				return false;
+			}
+
+			void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (!data)
+			{
+				CloseHandle(mapping);
+				CloseHandle(file);
+				return false;
+			}
+
+			m_File		= file;
+			m_Mapping	= mapping;
+			m_Data		= static_cast<const uint8_t*>(data);
+			m_Size		= static_cast<size_t>(fileSize.QuadPart);
+#else
+			int file = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+			if (file < 0)
+				return false;
+
+			struct stat fileStat{};
+			if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+			{
+				close(file);
+				return false;
+			}
+
+			void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			close(file); // the mapping keeps its own reference
+
+			if (data == MAP_FAILED)
+				return false;
+
+			m_Data = static_cast<const uint8_t*>(data);
+			m_Size = static_cast<size_t>(fileStat.st_size);
+#endif
+			return true;
+		}
+
+		void MappedFile::Close()
+		{
+			if (!m_Data)
+				return;
+
+#ifdef _WIN32
+			UnmapViewOfFile(m_Data);
+			CloseHandle(m_Mapping);
+			CloseHandle(m_File);
+
+			m_File		= nullptr;
+			m_Mapping	= nullptr;
+#else
+			munmap(const_cast<uint8_t*>(m_Data), m_Size);
+#endif
+			m_Data = nullptr;
+			m_Size = 0;
+		}
+	}
+
+	namespace HashUtils
+	{
+		uint64_t Hash64(const void* data, size_t size, uint64_t seed)
+		{
+			constexpr uint64_t kPrime = 0x100000001b3ull;
+
+			const auto* bytes = static_cast<const uint8_t*>(data);
+			uint64_t hash = seed;
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				hash ^= bytes[i];
+				hash *= kPrime;
+			}
+
+			return hash;
+		}
+
+		uint64_t Hash64(std::string_view text, uint64_t seed)
+		{
+			return Hash64(text.data(), text.size(), seed);
+		}
+
+		std::string ToHex(uint64_t hash)
+		{
+			return fmt::format("{:016x}", hash);
+		}
 	}
 
 	namespace VulkanUtils
@@ -81,7 +205,8 @@ namespace VulkanEngine {
 			VkCommandBuffer       cmdBuffer, VkImage        image,
 			ImageState& imageState,
 			VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask,
-			VkImageLayout         newLayout)
+			VkImageLayout         newLayout,
+			VkImageAspectFlags    aspectMask)
 		{
 			VkImageMemoryBarrier2 imageBarrier{
 				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
@@ -96,11 +221,11 @@ namespace VulkanEngine {
 				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
 				.image = image,
 				.subresourceRange = {
-					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+					.aspectMask = aspectMask,
 					.baseMipLevel = 0,
-					.levelCount = 1,
+					.levelCount = VK_REMAINING_MIP_LEVELS,
 					.baseArrayLayer = 0,
-					.layerCount = 1,
+					.layerCount = VK_REMAINING_ARRAY_LAYERS,
 				}
 			};
 
@@ -118,6 +243,38 @@ namespace VulkanEngine {
 			imageState.currentLayout = newLayout;
 		}
 
+		void InsertBufferMemoryBarrier(
+			VkCommandBuffer       cmdBuffer, VkBuffer       buffer,
+			BufferState& bufferState,
+			VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask)
+		{
+			VkBufferMemoryBarrier2 bufferBarrier{
+				.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+				.pNext = nullptr,
+				.srcStageMask = bufferState.currentStage,
+				.srcAccessMask = bufferState.currentAccess,
+				.dstStageMask = dstStageMask,
+				.dstAccessMask = dstAccessMask,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.buffer = buffer,
+				.offset = 0,
+				.size = VK_WHOLE_SIZE
+			};
+
+			const VkDependencyInfo depInfo{
+				.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+				.pNext = nullptr,
+				.bufferMemoryBarrierCount = 1,
+				.pBufferMemoryBarriers = &bufferBarrier
+			};
+
+			vkCmdPipelineBarrier2(cmdBuffer, &depInfo);
+
+			bufferState.currentStage = dstStageMask;
+			bufferState.currentAccess = dstAccessMask;
+		}
+
 		// -----------------------------------------------------------------------------------------------------------
 		// COMMAND BUFFER + POOL
 		// -----------------------------------------------------------------------------------------------------------
@@ -208,6 +365,22 @@ namespace VulkanEngine {
 			};
 		}
 
+		// -----------------------------------------------------------------------------------------------------------
+		// BUFFERS
+		// -----------------------------------------------------------------------------------------------------------
+
+		VkBufferCreateInfo GetBufferCreateInfo(VkDeviceSize size, VkBufferUsageFlags usage)
+		{
+			return {
+				.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+				.pNext = nullptr,
+				.flags = 0,
+				.size = size,
+				.usage = usage,
+				.sharingMode = VK_SHARING_MODE_EXCLUSIVE
+			};
+		}
+
 		// -----------------------------------------------------------------------------------------------------------
 		// TRANSFER
 		// -----------------------------------------------------------------------------------------------------------
@@ -271,7 +444,21 @@ namespace VulkanEngine {
 			};
 		}
 
-		VkRenderingInfo GetRenderingInfo(VkRenderingAttachmentInfo colorAttachmentInfo, VkExtent3D extent)
+		VkRenderingAttachmentInfo GetDepthAttachmentInfo(VkImageView imageView, float clearDepth)
+		{
+			return {
+				.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+				.pNext = nullptr,
+				.imageView = imageView,
+				.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+				.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+				.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+				.clearValue = {.depthStencil = {.depth = clearDepth, .stencil = 0 } }
+			};
+		}
+
+		VkRenderingInfo GetRenderingInfo(const VkRenderingAttachmentInfo& colorAttachmentInfo, VkExtent3D extent,
+			const VkRenderingAttachmentInfo* depthAttachmentInfo)
 		{
 			return {
 				.sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
@@ -282,7 +469,7 @@ namespace VulkanEngine {
 				.viewMask = 0,
 				.colorAttachmentCount = 1,
 				.pColorAttachments = &colorAttachmentInfo,
-				.pDepthAttachment = nullptr,
+				.pDepthAttachment = depthAttachmentInfo,
 				.pStencilAttachment = nullptr
 			};
 		}
@@ -314,5 +501,14 @@ namespace VulkanEngine {
 				.pSignalSemaphoreInfos = signalSemaphoreInfo
 			};
 		}
+
+		VkExtent3D GetGroupCount(VkExtent3D extent, const std::array<uint32_t, 3>& workgroupSize)
+		{
+			return {
+				.width	= (extent.width  + workgroupSize[0] - 1) / workgroupSize[0],
+				.height = (extent.height + workgroupSize[1] - 1) / workgroupSize[1],
+				.depth	= (extent.depth  + workgroupSize[2] - 1) / workgroupSize[2]
+			};
+		}
 	}
 }
\ No newline at end of file
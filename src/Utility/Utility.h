@@ -30,6 +30,42 @@ namespace VulkanEngine {
 		};
 
 		std::string ReadFile(const std::filesystem::path& filepath, ReadMode mode);
+
+		// Read-only memory mapping, pages are loaded on first access
+		class MappedFile
+		{
+		public:
+			MappedFile() = default;
+			~MappedFile();
+			MappedFile(const MappedFile&)				= delete;
+			MappedFile& operator=(const MappedFile&)	= delete;
+
+			bool Open(const std::filesystem::path& filepath);
+			void Close();
+
+			const uint8_t*	GetData() const { return m_Data; }
+			size_t			GetSize() const { return m_Size; }
+			bool			IsOpen()  const { return m_Data != nullptr; }
+
+		private:
+			const uint8_t*	m_Data{ nullptr };
+			size_t			m_Size{ 0 };
+#ifdef _WIN32
+			void*			m_File{ nullptr };
+			void*			m_Mapping{ nullptr };
+#endif
+		};
+	}
+
+	namespace HashUtils
+	{
+		static constexpr uint64_t kHashSeed = 0xcbf29ce484222325ull;
+
+		// FNV-1a, chain calls by passing the previous result as seed
+		uint64_t Hash64(const void* data, size_t size, uint64_t seed = kHashSeed);
+		uint64_t Hash64(std::string_view text, uint64_t seed = kHashSeed);
+
+		std::string ToHex(uint64_t hash);
 	}
 
 	namespace VulkanUtils
@@ -43,7 +79,13 @@ namespace VulkanEngine {
 			VkCommandBuffer       cmdBuffer, VkImage        image,
 			ImageState& imageState,   // expands into srcAccess + stage
 			VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask,
-			VkImageLayout         newLayout);
+			VkImageLayout         newLayout,
+			VkImageAspectFlags    aspectMask = VK_IMAGE_ASPECT_COLOR_BIT); // all mips and layers
+
+		void InsertBufferMemoryBarrier(
+			VkCommandBuffer       cmdBuffer, VkBuffer       buffer,
+			BufferState& bufferState, // expands into srcAccess + stage
+			VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask);
 
 		// COMMAND BUFFER + POOL
 		VkCommandPoolCreateInfo GetCommandPoolInfo(VkCommandPoolCreateFlags flags = 0, uint32_t queueFamilyIndex = 0);
@@ -55,15 +97,23 @@ namespace VulkanEngine {
 		VkImageCreateInfo GetImageCreateInfo(VkFormat format, VkExtent3D extent, VkImageUsageFlags usage);
 		VkImageViewCreateInfo GetImageViewCreateInfo(VkImage image, VkFormat format, VkImageAspectFlags aspectMask);
 
+		// BUFFERS
+		VkBufferCreateInfo GetBufferCreateInfo(VkDeviceSize size, VkBufferUsageFlags usage);
+
 		// TRANSFER
 		void CopyImageToImage(VkCommandBuffer cmdBuffer, VkImage src, VkImage dst, VkExtent3D srcSize, VkExtent3D dstSize);
 
 		// DYNAMIC RENDERING
 		VkRenderingAttachmentInfo GetRenderingAttachmentInfo(VkImageView imageView, VkClearValue* clearValue, VkImageLayout imageLayout);
-		VkRenderingInfo GetRenderingInfo(VkRenderingAttachmentInfo colorAttachmentInfo, VkExtent3D extent);
+		VkRenderingAttachmentInfo GetDepthAttachmentInfo(VkImageView imageView, float clearDepth); // cleared, reverse-Z clears to 0
+		VkRenderingInfo GetRenderingInfo(const VkRenderingAttachmentInfo& colorAttachmentInfo, VkExtent3D extent,
+			const VkRenderingAttachmentInfo* depthAttachmentInfo = nullptr); // attachments must outlive the returned info
 
 		// SUBMIT + PRESENT
 		VkCommandBufferSubmitInfo GetCommandBufferSubmitInfo(VkCommandBuffer cmd);
 		VkSubmitInfo2 GetSubmitInfo(VkCommandBufferSubmitInfo* cmd, VkSemaphoreSubmitInfo* signalSemaphoreInfo, VkSemaphoreSubmitInfo* waitSemaphoreInfo);
+
+		// COMPUTE
+		VkExtent3D GetGroupCount(VkExtent3D extent, const std::array<uint32_t, 3>& workgroupSize); // rounded up
 	}
 }
\ No newline at end of file
@@ -0,0 +1,403 @@
+#include "VulkanAbstraction/Assets/AssetLoader.h"
+#include "VulkanAbstraction/Assets/TextureImporter.h"
+#include "VulkanAbstraction/Geometry/GltfImporter.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "Core/Application.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	class AssetLoader::MeshEntry final : public TypedAssetEntry<MeshAsset>
+	{
+	public:
+		MeshEntry(const std::filesystem::path& path, uint64_t key, const MeshImportOptions& options)
+			: TypedAssetEntry(path, key), m_Options(options) {}
+
+		// Last handle gone, frames in flight may still draw it
+		~MeshEntry() override { m_Asset.buffers.Release(); }
+
+	protected:
+		// Packaged meshes were imported with the cooker's options
+		bool Decode(const AssetPackage* package) override
+		{
+			MeshData& meshData = m_Asset.meshData;
+
+			if (!package || !package->LoadMesh(m_Path, meshData))
+			{
+				meshData = {};
+				if (!GltfImporter::Import(m_Path, m_Options, meshData))
+					return false;
+			}
+
+			return !meshData.vertices.empty() && !meshData.indices.empty();
+		}
+
+		VkDeviceSize GetStagingSize() const override { return MeshBuffers::GetStagingSize(m_Asset.meshData); }
+		void WriteStaging(void* staging) const override { MeshBuffers::WriteStaging(m_Asset.meshData, staging); }
+
+		void RecordUpload(VkCommandBuffer cmd, const AllocatedBuffer& staging) override
+		{
+			MeshData& meshData = m_Asset.meshData;
+			m_Asset.buffers = MeshBuffers::RecordUpload(cmd, meshData, staging);
+
+			// Already in staging, draws only read the GPU copy
+			meshData.vertices			= {};
+			meshData.indices			= {};
+			meshData.meshlets			= {};
+			meshData.meshletVertices	= {};
+			meshData.meshletTriangles	= {};
+		}
+
+	private:
+		MeshImportOptions m_Options;
+	};
+
+	class AssetLoader::TextureEntry final : public TypedAssetEntry<TextureAsset>
+	{
+	public:
+		TextureEntry(const std::filesystem::path& path, uint64_t key)
+			: TypedAssetEntry(path, key) {}
+
+		~TextureEntry() override { m_Asset.texture.Release(); }
+
+	protected:
+		// Packaged textures are used in place, source images are decoded and get their mips here
+		bool Decode(const AssetPackage* package) override
+		{
+			if (package && (m_View = package->FindTexture(m_Path)))
+				return true;
+
+			if (!TextureImporter::Import(m_Path, m_Blob))
+				return false;
+
+			m_View = TextureView::FromBlob(m_Blob);
+			return static_cast<bool>(m_View);
+		}
+
+		VkDeviceSize GetStagingSize() const override { return Texture::GetStagingSize(m_View); }
+		void WriteStaging(void* staging) const override { Texture::WriteStaging(m_View, staging); }
+
+		void RecordUpload(VkCommandBuffer cmd, const AllocatedBuffer& staging) override
+		{
+			m_Asset.texture = Texture::RecordUpload(cmd, m_View, staging);
+
+			m_View = {};
+			m_Blob = {};
+		}
+
+	private:
+		TextureView				m_View;
+		std::vector<uint8_t>	m_Blob; // decoded source image, empty when the view points into the package
+	};
+
+	void AssetLoader::MountPackage(const std::filesystem::path& packagePath)
+	{
+		std::lock_guard lock(s_Mutex);
+
+		s_Package.Close();
+		if (!s_Package.Open(packagePath))
+			VulkanEngine_WARN(fmt::runtime("Asset package {} not mounted, loading from source files"), packagePath.string());
+	}
+
+	AssetHandle<MeshAsset> AssetLoader::LoadMesh(const std::filesystem::path& path, const MeshImportOptions& options,
+		MeshCallback onComplete)
+	{
+		uint64_t key = GetKey(path, AssetType::Mesh, options.GetHash());
+
+		return Load<MeshEntry>(key, std::move(onComplete), [&]()
+			{
+				return std::make_shared<MeshEntry>(path, key, options);
+			});
+	}
+
+	AssetHandle<TextureAsset> AssetLoader::LoadTexture(const std::filesystem::path& path, TextureCallback onComplete)
+	{
+		uint64_t key = GetKey(path, AssetType::Texture);
+
+		return Load<TextureEntry>(key, std::move(onComplete), [&]()
+			{
+				return std::make_shared<TextureEntry>(path, key);
+			});
+	}
+
+	template<typename Entry, typename Create>
+	AssetHandle<typename Entry::ValueType> AssetLoader::Load(uint64_t key, typename Entry::Callback onComplete, Create&& create)
+	{
+		using T = typename Entry::ValueType;
+
+		Start();
+
+		std::lock_guard lock(s_Mutex);
+
+		if (auto it = s_Entries.find(key); it != s_Entries.end())
+		{
+			if (auto existing = std::static_pointer_cast<TypedAssetEntry<T>>(it->second.lock()))
+			{
+				if (onComplete)
+				{
+					existing->m_Callbacks.push_back(std::move(onComplete));
+					if (existing->GetStatus() != AssetStatus::Loading)
+						s_Completions.push_back(existing);
+				}
+
+				return AssetHandle<T>(std::move(existing));
+			}
+		}
+
+		std::shared_ptr<Entry> entry = create();
+		if (onComplete)
+			entry->m_Callbacks.push_back(std::move(onComplete));
+
+		s_Entries[key] = entry;
+		s_Requests.push_back(entry);
+		s_WorkerCondition.notify_one();
+
+		return AssetHandle<T>(std::move(entry));
+	}
+
+	uint64_t AssetLoader::GetKey(const std::filesystem::path& path, AssetType type, uint64_t seed)
+	{
+		uint64_t key = AssetPackage::GetKey(path);
+		key = HashUtils::Hash64(&type, sizeof(type), key);
+		return HashUtils::Hash64(&seed, sizeof(seed), key);
+	}
+
+	void AssetLoader::Update()
+	{
+		if (!s_Started)
+			return;
+
+		RetireUploads();
+		SubmitUploads();
+
+		std::vector<std::function<void()>> callbacks;
+		{
+			std::lock_guard lock(s_Mutex);
+
+			for (const auto& entry : s_Completions)
+				callbacks.push_back(entry->TakeCallbacks());
+			s_Completions.clear();
+
+			std::erase_if(s_Entries, [](const auto& entry) { return entry.second.expired(); });
+		}
+
+		for (const auto& callback : callbacks)
+			callback();
+	}
+
+	uint32_t AssetLoader::GetPendingCount()
+	{
+		std::lock_guard lock(s_Mutex);
+
+		uint32_t count = 0;
+		for (const auto& [key, weakEntry] : s_Entries)
+		{
+			auto entry = weakEntry.lock();
+			if (entry && entry->GetStatus() == AssetStatus::Loading)
+				++count;
+		}
+
+		return count;
+	}
+
+	void AssetLoader::Start()
+	{
+		std::lock_guard lock(s_Mutex);
+		if (s_Started)
+			return;
+
+		auto* app = Application::GetRaw();
+		auto* ctx = VulkanContext::GetRaw();
+		VkDevice device			= *ctx->GetDevice();
+		uint32_t queueFamily	= ctx->GetPhysicalDevice()->GetGraphicsFamily();
+
+		for (auto& batch : s_Batches)
+			batch.frame.Init(device, queueFamily);
+
+		// Pushed after the batch command pools and fences, so it runs before they are destroyed
+		app->GetLifetimeManager()->PushFunction([]() { Stop(); });
+
+		// Decoding is CPU bound, leave cores for the main thread and the driver
+		uint32_t workerCount = std::max(1u, std::thread::hardware_concurrency() / 2);
+		for (uint32_t i = 0; i < workerCount; ++i)
+			s_Workers.emplace_back(WorkerLoop);
+
+		s_Started = true;
+
+		VulkanEngine_INFO(fmt::runtime("Asset loader started with {} workers"), workerCount);
+	}
+
+	void AssetLoader::Stop()
+	{
+		{
+			std::lock_guard lock(s_Mutex);
+			s_Stop = true;
+		}
+		s_WorkerCondition.notify_all();
+
+		for (auto& worker : s_Workers)
+		{
+			if (worker.joinable())
+				worker.join();
+		}
+		s_Workers.clear();
+
+		VkDevice device = *VulkanContext::GetRaw()->GetDevice();
+		for (auto& batch : s_Batches)
+		{
+			if (batch.inFlight)
+				CHECK_VK_RES(vkWaitForFences(device, 1, &batch.frame.renderFinishedFence, VK_TRUE, UINT64_MAX));
+
+			for (auto& staging : batch.staging)
+				VulkanRenderer::DestroyStagingBuffer(staging);
+
+			batch.entries.clear();
+			batch.staging.clear();
+			batch.inFlight = false;
+		}
+
+		for (auto& decoded : s_Decoded)
+			VulkanRenderer::DestroyStagingBuffer(decoded.staging);
+
+		s_Decoded.clear();
+		s_Requests.clear();
+		s_Completions.clear();
+		s_Entries.clear();
+		s_Package.Close();
+		s_Started = false;
+	}
+
+	void AssetLoader::WorkerLoop()
+	{
+		while (true)
+		{
+			std::shared_ptr<AssetEntry> entry;
+			{
+				std::unique_lock lock(s_Mutex);
+				s_WorkerCondition.wait(lock, []() { return s_Stop || !s_Requests.empty(); });
+
+				if (s_Stop)
+					return;
+
+				entry = s_Requests.front().lock();
+				s_Requests.pop_front();
+			}
+
+			// Every handle was released before decoding started
+			if (!entry)
+				continue;
+
+			DecodedAsset decoded{ .entry = entry };
+
+			bool loaded = entry->Decode(s_Package.IsOpen() ? &s_Package : nullptr);
+			if (loaded)
+			{
+				decoded.staging = VulkanRenderer::CreateStagingBuffer(entry->GetStagingSize());
+				entry->WriteStaging(decoded.staging.mapped);
+				vmaFlushAllocation(VulkanRenderer::GetAllocator().GetRaw(), decoded.staging.allocation, 0, VK_WHOLE_SIZE);
+			}
+			else
+			{
+				VulkanEngine_ERROR(fmt::runtime("Failed to load asset {}"), entry->GetPath().string());
+			}
+
+			std::lock_guard lock(s_Mutex);
+
+			if (loaded)
+			{
+				s_Decoded.push_back(std::move(decoded));
+			}
+			else
+			{
+				entry->m_Status.store(AssetStatus::Failed, std::memory_order_release);
+				s_Completions.push_back(std::move(entry));
+			}
+		}
+	}
+
+	void AssetLoader::RetireUploads()
+	{
+		VkDevice device = *VulkanContext::GetRaw()->GetDevice();
+
+		for (auto& batch : s_Batches)
+		{
+			// Polled, the main thread never waits for an upload
+			if (!batch.inFlight || vkGetFenceStatus(device, batch.frame.renderFinishedFence) != VK_SUCCESS)
+				continue;
+
+			for (auto& staging : batch.staging)
+				VulkanRenderer::DestroyStagingBuffer(staging);
+
+			std::lock_guard lock(s_Mutex);
+			for (auto& entry : batch.entries)
+			{
+				entry->m_Status.store(AssetStatus::Ready, std::memory_order_release);
+				s_Completions.push_back(std::move(entry));
+			}
+
+			batch.entries.clear();
+			batch.staging.clear();
+			batch.inFlight = false;
+		}
+	}
+
+	void AssetLoader::SubmitUploads()
+	{
+		auto batchIt = std::find_if(s_Batches.begin(), s_Batches.end(), [](const UploadBatch& batch) { return !batch.inFlight; });
+		if (batchIt == s_Batches.end())
+			return;
+
+		UploadBatch& batch = *batchIt;
+
+		// Oldest first until the budget is spent, an asset over budget goes alone
+		{
+			std::lock_guard lock(s_Mutex);
+
+			VkDeviceSize bytes = 0;
+			while (!s_Decoded.empty() && (batch.entries.empty() || bytes + s_Decoded.front().staging.size <= s_UploadBudget))
+			{
+				DecodedAsset decoded = std::move(s_Decoded.front());
+				s_Decoded.pop_front();
+
+				auto entry = decoded.entry.lock();
+				if (!entry)
+				{
+					VulkanRenderer::DestroyStagingBuffer(decoded.staging);
+					continue;
+				}
+
+				bytes += decoded.staging.size;
+				batch.entries.push_back(std::move(entry));
+				batch.staging.push_back(decoded.staging);
+			}
+		}
+
+		if (batch.entries.empty())
+			return;
+
+		VkDevice		device	= *VulkanContext::GetRaw()->GetDevice();
+		VkCommandBuffer cmd		= batch.frame.commandBuffer;
+
+		CHECK_VK_RES(vkResetFences(device, 1, &batch.frame.renderFinishedFence));
+		CHECK_VK_RES(vkResetCommandBuffer(cmd, 0));
+
+		VkCommandBufferBeginInfo beginInfo = VulkanUtils::GetBeginCmdBufferInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		CHECK_VK_RES(vkBeginCommandBuffer(cmd, &beginInfo));
+
+		// Each copy ends in a barrier to the stages reading it, frames submitted later see the data
+		for (size_t i = 0; i < batch.entries.size(); ++i)
+			batch.entries[i]->RecordUpload(cmd, batch.staging[i]);
+
+		CHECK_VK_RES(vkEndCommandBuffer(cmd));
+
+		VkCommandBufferSubmitInfo cmdSubmitInfo = VulkanUtils::GetCommandBufferSubmitInfo(cmd);
+		VkSubmitInfo2 submitInfo = VulkanUtils::GetSubmitInfo(&cmdSubmitInfo, nullptr, nullptr);
+
+		VulkanRenderer::SubmitToGraphicsQueue(submitInfo, batch.frame.renderFinishedFence);
+
+		batch.inFlight = true;
+	}
+
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "VulkanAbstraction/VulkanTypes.h"
+#include "VulkanAbstraction/Assets/AssetPackage.h"
+#include "VulkanAbstraction/Assets/Texture.h"
+#include "VulkanAbstraction/Geometry/MeshData.h"
+
+
+namespace VulkanEngine {
+
+	enum class AssetStatus : uint8_t
+	{
+		Loading,	// queued, decoding on a worker or waiting for its upload
+		Ready,
+		Failed
+	};
+
+	// Vertices, indices and meshlets are released once uploaded, submeshes and nodes stay for GpuScene::AddMeshData
+	struct MeshAsset
+	{
+		MeshData	meshData;
+		MeshBuffers buffers;
+	};
+
+	struct TextureAsset
+	{
+		Texture texture;
+	};
+
+	// State shared by every handle to one asset, owned by its handles
+	class AssetEntry : public std::enable_shared_from_this<AssetEntry>
+	{
+	public:
+		AssetEntry(const std::filesystem::path& path, uint64_t key) : m_Path(path), m_Key(key) {}
+		virtual ~AssetEntry() = default;
+		AssetEntry(const AssetEntry&)				= delete;
+		AssetEntry& operator=(const AssetEntry&)	= delete;
+
+		const std::filesystem::path&	GetPath()	const { return m_Path; }
+		AssetStatus						GetStatus() const { return m_Status.load(std::memory_order_acquire); }
+
+	protected:
+		friend class AssetLoader;
+
+		// Worker thread: read and decode into CPU memory, package first, then the source file
+		virtual bool Decode(const AssetPackage* package) = 0;
+
+		// Worker thread, after Decode
+		virtual VkDeviceSize GetStagingSize() const = 0;
+		virtual void WriteStaging(void* staging) const = 0;
+
+		// Main thread, the staging buffer stays alive until the copies are done
+		virtual void RecordUpload(VkCommandBuffer cmd, const AllocatedBuffer& staging) = 0;
+
+		// Main thread, under the loader's mutex: takes the callbacks registered so far, the returned function
+		// runs them once the lock is released so they can request more assets
+		virtual std::function<void()> TakeCallbacks() = 0;
+
+	protected:
+		std::filesystem::path		m_Path;
+		uint64_t					m_Key{ 0 };
+		std::atomic<AssetStatus>	m_Status{ AssetStatus::Loading };
+	};
+
+	template<typename T>
+	class AssetHandle;
+
+	template<typename T>
+	class TypedAssetEntry : public AssetEntry
+	{
+	public:
+		using ValueType	= T;
+		using Callback	= std::function<void(const AssetHandle<T>& handle)>;
+
+		TypedAssetEntry(const std::filesystem::path& path, uint64_t key) : AssetEntry(path, key) {}
+
+		const T& GetAsset() const { return m_Asset; }
+
+	protected:
+		friend class AssetLoader;
+
+		std::function<void()> TakeCallbacks() override;
+
+	protected:
+		T						m_Asset;
+		std::vector<Callback>	m_Callbacks; // under AssetLoader's mutex
+	};
+
+	// Refcounted reference to an asset, copies share the asset and the last one to go away cancels
+	// the load or releases the asset: the CPU side right away, its buffers and images through the
+	// renderer's deletion queue once the frames in flight are done with them. Poll IsReady or pass
+	// a callback to the loader.
+	template<typename T>
+	class AssetHandle
+	{
+	public:
+		AssetHandle() = default;
+		explicit AssetHandle(std::shared_ptr<TypedAssetEntry<T>> entry) : m_Entry(std::move(entry)) {}
+
+		bool		IsValid()	const { return m_Entry != nullptr; }
+		AssetStatus GetStatus() const { return m_Entry ? m_Entry->GetStatus() : AssetStatus::Failed; }
+		bool		IsReady()	const { return GetStatus() == AssetStatus::Ready; }
+		bool		IsFailed()	const { return GetStatus() == AssetStatus::Failed; }
+
+		// Only once ready
+		const T& Get() const { return m_Entry->GetAsset(); }
+		const T* operator->() const { return &Get(); }
+
+		const std::filesystem::path& GetPath() const { return m_Entry->GetPath(); }
+
+		void Reset() { m_Entry.reset(); }
+
+	private:
+		std::shared_ptr<TypedAssetEntry<T>> m_Entry;
+	};
+
+	template<typename T>
+	std::function<void()> TypedAssetEntry<T>::TakeCallbacks()
+	{
+		return [handle = AssetHandle<T>(std::static_pointer_cast<TypedAssetEntry<T>>(shared_from_this())),
+			callbacks = std::exchange(m_Callbacks, {})]()
+			{
+				for (const auto& callback : callbacks)
+					callback(handle);
+			};
+	}
+
+	// Loads meshes and textures in the background so loading screens and streaming never stall a frame.
+	// Reading, decoding (glTF import, image decode and mip generation) and the copy into a staging buffer
+	// run on worker threads. Update, called by Application::Run between frames, records the copies into its
+	// own command buffer under a per-frame byte budget, submits them without waiting and completes the assets
+	// whose copies the GPU has finished: status turns Ready and the callbacks run on the main thread.
+	// Requests for a path already loading or loaded share the same asset.
+	class AssetLoader
+	{
+	public:
+		AssetLoader() = delete;
+		~AssetLoader() = delete;
+
+		using MeshCallback		= TypedAssetEntry<MeshAsset>::Callback;
+		using TextureCallback	= TypedAssetEntry<TextureAsset>::Callback;
+
+		// Looked up before the source files. Mount before the first load, workers read it without locking.
+		static void MountPackage(const std::filesystem::path& packagePath);
+
+		// Callbacks also run, at the next Update, for an asset that is already complete
+		static AssetHandle<MeshAsset>		LoadMesh(const std::filesystem::path& path, const MeshImportOptions& options = {},
+			MeshCallback onComplete = {});
+		static AssetHandle<TextureAsset>	LoadTexture(const std::filesystem::path& path, TextureCallback onComplete = {});
+
+		// Main thread, between frames
+		static void Update();
+
+		// Bytes recorded into copies per Update, an asset larger than the budget goes alone
+		static void SetUploadBudget(VkDeviceSize bytes) { s_UploadBudget = bytes; }
+
+		// Entries loading, waiting for their upload or with their copies in flight
+		static uint32_t GetPendingCount();
+
+	private:
+		class MeshEntry;
+		class TextureEntry;
+
+		// The live entry with the same key or a new one from create, queued for the workers
+		template<typename Entry, typename Create>
+		static AssetHandle<typename Entry::ValueType> Load(uint64_t key, typename Entry::Callback onComplete, Create&& create);
+
+		static uint64_t GetKey(const std::filesystem::path& path, AssetType type, uint64_t seed = 0);
+
+		static void Start();
+		static void Stop();
+		static void WorkerLoop();
+
+		static void RetireUploads();
+		static void SubmitUploads();
+
+	private:
+		// Waiting for its upload, skipped if every handle is released by then
+		struct DecodedAsset
+		{
+			std::weak_ptr<AssetEntry>	entry;
+			AllocatedBuffer				staging;
+		};
+
+		struct UploadBatch
+		{
+			Frame									frame; // command buffer and fence, the semaphore is unused
+			std::vector<std::shared_ptr<AssetEntry>> entries;
+			std::vector<AllocatedBuffer>			staging;
+			bool									inFlight{ false };
+		};
+
+		static constexpr uint32_t kUploadBatchCount = 2;
+
+		static inline std::mutex										s_Mutex;
+		static inline std::condition_variable							s_WorkerCondition;
+		static inline std::vector<std::thread>							s_Workers;
+		static inline bool												s_Stop{ false };
+		static inline std::atomic<bool>									s_Started{ false };
+
+		static inline std::unordered_map<uint64_t, std::weak_ptr<AssetEntry>> s_Entries; // dedupe by type, path and options
+		static inline std::deque<std::weak_ptr<AssetEntry>>				s_Requests;		// in request order
+		static inline std::deque<DecodedAsset>							s_Decoded;
+		static inline std::vector<std::shared_ptr<AssetEntry>>			s_Completions;	// callbacks to run at the next Update
+
+		static inline std::array<UploadBatch, kUploadBatchCount>		s_Batches;
+		static inline VkDeviceSize										s_UploadBudget{ 32ull << 20 };
+
+		static inline AssetPackage										s_Package;
+	};
+
+}
@@ -0,0 +1,207 @@
+#include "VulkanAbstraction/Assets/AssetPackage.h"
+#include "VulkanAbstraction/Geometry/MeshCache.h"
+#include "Core/LogSystem.h"
+
+
+namespace VulkanEngine {
+
+	static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	bool AssetPackage::Open(const std::filesystem::path& packagePath)
+	{
+		Close();
+
+		if (!m_File.Open(packagePath))
+		{
+			VulkanEngine_WARN(fmt::runtime("Asset package not found: {}"), packagePath.string());
+			return false;
+		}
+
+		if (!Validate(m_File))
+		{
+			VulkanEngine_ERROR(fmt::runtime("Asset package is corrupt or outdated: {}"), packagePath.string());
+			m_File.Close();
+			return false;
+		}
+
+		VulkanEngine_INFO(fmt::runtime("Opened asset package: {} ({} assets, {} KB)"), packagePath.string(),
+			GetEntryCount(), m_File.GetSize() / 1024);
+
+		return true;
+	}
+
+	void AssetPackage::Close()
+	{
+		m_File.Close();
+	}
+
+	uint32_t AssetPackage::GetEntryCount() const
+	{
+		return m_File.IsOpen() ? reinterpret_cast<const AssetPackageHeader*>(m_File.GetData())->entryCount : 0;
+	}
+
+	std::span<const uint8_t> AssetPackage::Find(const std::filesystem::path& assetPath, AssetType type) const
+	{
+		if (!m_File.IsOpen())
+			return {};
+
+		uint64_t key = GetKey(assetPath);
+
+		const auto* first	= reinterpret_cast<const AssetPackageEntry*>(m_File.GetData() + sizeof(AssetPackageHeader));
+		const auto* last	= first + GetEntryCount();
+
+		const auto* entry = std::lower_bound(first, last, key,
+			[](const AssetPackageEntry& e, uint64_t k) { return e.key < k; });
+
+		if (entry == last || entry->key != key)
+			return {};
+
+		if (entry->type != type)
+		{
+			VulkanEngine_ERROR(fmt::runtime("Asset {} is packaged as a different type"), assetPath.generic_string());
+			return {};
+		}
+
+		return { m_File.GetData() + entry->offset, entry->size };
+	}
+
+	TextureView AssetPackage::FindTexture(const std::filesystem::path& assetPath) const
+	{
+		return TextureView::FromBlob(Find(assetPath, AssetType::Texture));
+	}
+
+	TextureView TextureView::FromBlob(std::span<const uint8_t> blob)
+	{
+		if (blob.size() < sizeof(TextureBlobHeader))
+			return {};
+
+		const auto* header = reinterpret_cast<const TextureBlobHeader*>(blob.data());
+		if (header->mipCount == 0 || header->mipCount > kMaxTextureMips)
+			return {};
+
+		for (uint32_t mip = 0; mip < header->mipCount; ++mip)
+		{
+			if (header->mipOffsets[mip] < sizeof(TextureBlobHeader) || header->mipOffsets[mip] > blob.size() ||
+				header->mipSizes[mip] > blob.size() - header->mipOffsets[mip])
+				return {};
+		}
+
+		return { header, blob };
+	}
+
+	bool AssetPackage::LoadMesh(const std::filesystem::path& assetPath, MeshData& meshData) const
+	{
+		auto blob = Find(assetPath, AssetType::Mesh);
+		return !blob.empty() && MeshCache::Read(blob, meshData);
+	}
+
+	uint64_t AssetPackage::GetKey(const std::filesystem::path& relativePath)
+	{
+		return HashUtils::Hash64(relativePath.lexically_normal().generic_string());
+	}
+
+	bool AssetPackage::Write(const std::filesystem::path& packagePath, std::vector<Blob> blobs)
+	{
+		std::sort(blobs.begin(), blobs.end(), [](const Blob& a, const Blob& b) { return a.key < b.key; });
+
+		for (size_t i = 1; i < blobs.size(); ++i)
+		{
+			if (blobs[i].key == blobs[i - 1].key)
+			{
+				VulkanEngine_ERROR(fmt::runtime("Asset package key collision: {}"), HashUtils::ToHex(blobs[i].key));
+				return false;
+			}
+		}
+
+		AssetPackageHeader header{
+			.magic		= kAssetPackageMagic,
+			.version	= kAssetPackageVersion,
+			.entryCount = static_cast<uint32_t>(blobs.size())
+		};
+
+		std::vector<AssetPackageEntry> entries;
+		uint64_t offset = AlignUp(sizeof(AssetPackageHeader) + blobs.size() * sizeof(AssetPackageEntry), kAssetPackageAlignment);
+
+		for (const auto& blob : blobs)
+		{
+			entries.push_back({ .key = blob.key, .type = blob.type, .offset = offset, .size = blob.data.size() });
+			offset = AlignUp(offset + blob.data.size(), kAssetPackageAlignment);
+		}
+
+		std::filesystem::create_directories(std::filesystem::absolute(packagePath).parent_path());
+
+		// Written next to the target and renamed, a running engine never maps a half-written file
+		auto tempPath = packagePath;
+		tempPath += ".tmp";
+
+		{
+			std::ofstream packageFile(tempPath, std::ios::binary | std::ios::trunc);
+			if (!packageFile.is_open())
+			{
+				VulkanEngine_ERROR(fmt::runtime("Failed to write asset package: {}"), tempPath.string());
+				return false;
+			}
+
+			auto pad = [&](uint64_t target)
+				{
+					static constexpr char zeros[kAssetPackageAlignment]{};
+					uint64_t position = static_cast<uint64_t>(packageFile.tellp());
+					packageFile.write(zeros, static_cast<std::streamsize>(target - position));
+				};
+
+			packageFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			packageFile.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(AssetPackageEntry));
+
+			for (size_t i = 0; i < blobs.size(); ++i)
+			{
+				pad(entries[i].offset);
+				packageFile.write(reinterpret_cast<const char*>(blobs[i].data.data()), entries[i].size);
+			}
+
+			if (!packageFile.good())
+				return false;
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, packagePath, ec);
+
+		return !ec;
+	}
+
+	bool AssetPackage::Validate(const FilesystemUtils::MappedFile& file)
+	{
+		if (file.GetSize() < sizeof(AssetPackageHeader))
+			return false;
+
+		const auto* header = reinterpret_cast<const AssetPackageHeader*>(file.GetData());
+		if (header->magic != kAssetPackageMagic || header->version != kAssetPackageVersion)
+			return false;
+
+		uint64_t tocEnd = sizeof(AssetPackageHeader) + uint64_t(header->entryCount) * sizeof(AssetPackageEntry);
+		if (tocEnd > file.GetSize())
+			return false;
+
+		const auto* entries = reinterpret_cast<const AssetPackageEntry*>(file.GetData() + sizeof(AssetPackageHeader));
+		for (uint32_t i = 0; i < header->entryCount; ++i)
+		{
+			const auto& entry = entries[i];
+
+			bool valid =
+				entry.offset >= tocEnd &&
+				entry.offset <= file.GetSize() &&
+				entry.offset % kAssetPackageAlignment == 0 &&
+				entry.size <= file.GetSize() - entry.offset &&
+				entry.type <= AssetType::Texture &&
+				(i == 0 || entries[i - 1].key < entry.key);
+
+			if (!valid)
+				return false;
+		}
+
+		return true;
+	}
+
+}
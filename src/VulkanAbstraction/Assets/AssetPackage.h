@@ -0,0 +1,112 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "VulkanAbstraction/Geometry/MeshData.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	enum class AssetType : uint32_t
+	{
+		Mesh,		// MeshCache layout (MeshCache::Read)
+		Texture		// TextureBlobHeader + mip chain, shaders go through ShaderArchive
+	};
+
+	// On-disk layout, little endian:
+	//   AssetPackageHeader
+	//   AssetPackageEntry[entryCount]	sorted by key
+	//   blobs							each aligned to kAssetPackageAlignment
+	struct AssetPackageHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t padding;
+	};
+
+	struct AssetPackageEntry
+	{
+		uint64_t	key;	// AssetPackage::GetKey of the path relative to the cooked directory
+		AssetType	type;
+		uint32_t	padding;
+		uint64_t	offset; // from the start of the file
+		uint64_t	size;	// in bytes
+	};
+
+	static constexpr uint32_t kAssetPackageMagic		= 0x4b415041; // "APAK"
+	static constexpr uint32_t kAssetPackageVersion		= 2;
+	static constexpr uint64_t kAssetPackageAlignment	= 256; // covers optimalBufferCopyOffsetAlignment and every texel block
+
+	static constexpr uint32_t kMaxTextureMips = 16;
+
+	// Mips follow the header, full resolution first, each tightly packed and aligned to 16 bytes.
+	// Offsets are from the start of the blob.
+	struct TextureBlobHeader
+	{
+		uint32_t	format;		// VkFormat
+		uint32_t	width;
+		uint32_t	height;
+		uint32_t	mipCount;
+		uint64_t	mipOffsets[kMaxTextureMips];
+		uint64_t	mipSizes[kMaxTextureMips];
+	};
+
+	struct TextureView
+	{
+		const TextureBlobHeader*	header{ nullptr };
+		std::span<const uint8_t>	blob; // header included, mipOffsets index into it
+
+		explicit operator bool() const { return header != nullptr; }
+
+		// Empty when the header or a mip does not fit in the blob
+		static TextureView FromBlob(std::span<const uint8_t> blob);
+	};
+
+	// Read-only package of cooked assets, produced offline by the AssetCooker tool.
+	// The file is memory mapped and every lookup is a binary search over the TOC returning a view
+	// into the mapping: blobs are already in their GPU layout and go to staging memory as they are,
+	// so loading is bounded by how fast the pages come in from disk.
+	class AssetPackage
+	{
+	public:
+		AssetPackage() = default;
+		virtual ~AssetPackage() = default;
+		AssetPackage(const AssetPackage&)				= delete;
+		AssetPackage& operator=(const AssetPackage&)	= delete;
+
+		bool Open(const std::filesystem::path& packagePath);
+		void Close();
+		bool IsOpen() const { return m_File.IsOpen(); }
+
+		// Empty span on a miss or a type mismatch, valid until Close
+		std::span<const uint8_t> Find(const std::filesystem::path& assetPath, AssetType type) const;
+
+		TextureView	FindTexture(const std::filesystem::path& assetPath) const;
+		bool		LoadMesh(const std::filesystem::path& assetPath, MeshData& meshData) const;
+
+		uint32_t GetEntryCount() const;
+
+		// Forward slashes, so keys match across platforms
+		static uint64_t GetKey(const std::filesystem::path& relativePath);
+
+		struct Blob
+		{
+			uint64_t				key{ 0 };
+			AssetType				type{ AssetType::Mesh };
+			std::vector<uint8_t>	data;
+		};
+
+		static bool Write(const std::filesystem::path& packagePath, std::vector<Blob> blobs);
+
+	private:
+		static bool Validate(const FilesystemUtils::MappedFile& file);
+
+	private:
+		FilesystemUtils::MappedFile m_File;
+	};
+
+}
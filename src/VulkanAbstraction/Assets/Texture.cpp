@@ -0,0 +1,94 @@
+#include "VulkanAbstraction/Assets/Texture.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "Core/Application.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	Texture Texture::Upload(const TextureView& view)
+	{
+		if (!view)
+		{
+			VulkanEngine_ERROR("Uploading a missing texture");
+			return {};
+		}
+
+		AllocatedBuffer staging = VulkanRenderer::CreateStagingBuffer(GetStagingSize(view));
+		WriteStaging(view, staging.mapped);
+		vmaFlushAllocation(VulkanRenderer::GetAllocator().GetRaw(), staging.allocation, 0, VK_WHOLE_SIZE);
+
+		Texture texture;
+		VulkanRenderer::ImmediateSubmit([&](VkCommandBuffer cmd)
+			{
+				texture = RecordUpload(cmd, view, staging);
+			});
+
+		VulkanRenderer::DestroyStagingBuffer(staging);
+
+		// Lifetime management
+		auto* app = Application::GetRaw();
+		VkDevice device = *VulkanContext::GetRaw()->GetDevice();
+
+		app->GetLifetimeManager()->Push(vmaDestroyImage, VulkanRenderer::GetAllocator().GetRaw(), texture.image.image, texture.image.allocation);
+		app->GetLifetimeManager()->Push(vkDestroyImageView, device, texture.image.imageView, nullptr);
+
+		return texture;
+	}
+
+	VkDeviceSize Texture::GetStagingSize(const TextureView& view)
+	{
+		// Mips are contiguous after the header, one copy into staging covers all of them
+		const TextureBlobHeader& header = *view.header;
+		return header.mipOffsets[header.mipCount - 1] + header.mipSizes[header.mipCount - 1] - header.mipOffsets[0];
+	}
+
+	void Texture::WriteStaging(const TextureView& view, void* staging)
+	{
+		std::memcpy(staging, view.blob.data() + view.header->mipOffsets[0], GetStagingSize(view));
+	}
+
+	Texture Texture::RecordUpload(VkCommandBuffer cmd, const TextureView& view, const AllocatedBuffer& staging)
+	{
+		const TextureBlobHeader& header = *view.header;
+
+		Texture texture;
+		texture.mipCount	= header.mipCount;
+		texture.image		= VulkanRenderer::CreateUnmanagedImage(static_cast<VkFormat>(header.format), { header.width, header.height, 1 },
+			VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, header.mipCount);
+
+		std::vector<VkBufferImageCopy> regions(header.mipCount);
+		for (uint32_t mip = 0; mip < header.mipCount; ++mip)
+		{
+			regions[mip] = {
+				.bufferOffset		= header.mipOffsets[mip] - header.mipOffsets[0],
+				.imageSubresource	= { VK_IMAGE_ASPECT_COLOR_BIT, mip, 0, 1 },
+				.imageExtent		= { std::max(1u, header.width >> mip), std::max(1u, header.height >> mip), 1 }
+			};
+		}
+
+		VulkanUtils::InsertImageMemoryBarrier(cmd, texture.image.image, texture.image.imageState,
+			VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+		vkCmdCopyBufferToImage(cmd, staging.buffer, texture.image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			static_cast<uint32_t>(regions.size()), regions.data());
+
+		// Read-only from here on
+		VulkanUtils::InsertImageMemoryBarrier(cmd, texture.image.image, texture.image.imageState,
+			VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+		VulkanEngine_DEBUG(fmt::runtime("Uploaded texture: {}x{}, {} mips ({} KB)"), header.width, header.height, header.mipCount,
+			GetStagingSize(view) / 1024);
+
+		return texture;
+	}
+
+	void Texture::Release()
+	{
+		VulkanRenderer::GetDeletionQueue().Release(image);
+		mipCount = 0;
+	}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanAbstraction/VulkanTypes.h"
+#include "VulkanAbstraction/Assets/AssetPackage.h"
+
+
+namespace VulkanEngine {
+
+	// Sampled 2D image with the mip chain cooked by AssetCooker (or TextureImporter)
+	struct Texture
+	{
+		AllocatedImage	image{};
+		uint32_t		mipCount{ 0 };
+
+		// The mips are copied from the mapped package into staging as they are, no decoding.
+		// Blocks until the copy is done, destroyed on shutdown.
+		static Texture Upload(const TextureView& view);
+
+		// The same upload split for the asynchronous path (AssetLoader), see MeshBuffers.
+		// The image is owned by the caller, it goes with Release.
+		static VkDeviceSize GetStagingSize(const TextureView& view);
+		static void WriteStaging(const TextureView& view, void* staging);
+		static Texture RecordUpload(VkCommandBuffer cmd, const TextureView& view, const AllocatedBuffer& staging);
+
+		// Through the deletion queue, once the frames in flight are done with it
+		void Release();
+	};
+
+}
@@ -0,0 +1,107 @@
+#include "VulkanAbstraction/Assets/TextureImporter.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+
+namespace VulkanEngine {
+
+	bool TextureImporter::Import(const std::filesystem::path& imagePath, std::vector<uint8_t>& blob)
+	{
+		int width = 0, height = 0, channels = 0;
+		stbi_uc* pixels = stbi_load(imagePath.string().c_str(), &width, &height, &channels, 4);
+		if (!pixels)
+		{
+			VulkanEngine_ERROR(fmt::runtime("Failed to decode {}: {}"), imagePath.string(), stbi_failure_reason());
+			return false;
+		}
+
+		std::vector<std::vector<uint8_t>> mips;
+		mips.emplace_back(pixels, pixels + size_t(width) * height * 4);
+		stbi_image_free(pixels);
+
+		uint32_t mipWidth	= static_cast<uint32_t>(width);
+		uint32_t mipHeight	= static_cast<uint32_t>(height);
+		while ((mipWidth > 1 || mipHeight > 1) && mips.size() < kMaxTextureMips)
+		{
+			mips.push_back(Downsample(mips.back(), mipWidth, mipHeight));
+			mipWidth	= std::max(1u, mipWidth / 2);
+			mipHeight	= std::max(1u, mipHeight / 2);
+		}
+
+		TextureBlobHeader header{
+			.format		= VK_FORMAT_R8G8B8A8_SRGB,
+			.width		= static_cast<uint32_t>(width),
+			.height		= static_cast<uint32_t>(height),
+			.mipCount	= static_cast<uint32_t>(mips.size())
+		};
+
+		uint64_t offset = sizeof(TextureBlobHeader);
+		for (size_t mip = 0; mip < mips.size(); ++mip)
+		{
+			offset = (offset + 15) & ~uint64_t(15);
+			header.mipOffsets[mip]	= offset;
+			header.mipSizes[mip]	= mips[mip].size();
+			offset += mips[mip].size();
+		}
+
+		blob.assign(offset, 0);
+		std::memcpy(blob.data(), &header, sizeof(header));
+		for (size_t mip = 0; mip < mips.size(); ++mip)
+			std::memcpy(blob.data() + header.mipOffsets[mip], mips[mip].data(), mips[mip].size());
+
+		return true;
+	}
+
+	std::vector<uint8_t> TextureImporter::Downsample(const std::vector<uint8_t>& source, uint32_t width, uint32_t height)
+	{
+		uint32_t mipWidth	= std::max(1u, width / 2);
+		uint32_t mipHeight	= std::max(1u, height / 2);
+
+		std::vector<uint8_t> mip(size_t(mipWidth) * mipHeight * 4);
+
+		for (uint32_t y = 0; y < mipHeight; ++y)
+		{
+			for (uint32_t x = 0; x < mipWidth; ++x)
+			{
+				uint32_t x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+				uint32_t y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+
+				const uint8_t* texels[4] = {
+					&source[(size_t(y0) * width + x0) * 4], &source[(size_t(y0) * width + x1) * 4],
+					&source[(size_t(y1) * width + x0) * 4], &source[(size_t(y1) * width + x1) * 4]
+				};
+
+				uint8_t* destination = &mip[(size_t(y) * mipWidth + x) * 4];
+				for (int channel = 0; channel < 3; ++channel)
+				{
+					float sum = 0.0f;
+					for (const uint8_t* texel : texels)
+						sum += SrgbToLinear(texel[channel]);
+
+					destination[channel] = LinearToSrgb(sum * 0.25f);
+				}
+
+				uint32_t alpha = texels[0][3] + texels[1][3] + texels[2][3] + texels[3][3];
+				destination[3] = static_cast<uint8_t>((alpha + 2) / 4);
+			}
+		}
+
+		return mip;
+	}
+
+	float TextureImporter::SrgbToLinear(uint8_t value)
+	{
+		float c = value / 255.0f;
+		return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+	}
+
+	uint8_t TextureImporter::LinearToSrgb(float value)
+	{
+		float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+		return static_cast<uint8_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+
+}
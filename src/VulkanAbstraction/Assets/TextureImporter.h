@@ -0,0 +1,30 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "VulkanAbstraction/Assets/AssetPackage.h"
+
+
+namespace VulkanEngine {
+
+	// Source images (.png, .jpg, .tga, .bmp) decoded to RGBA8 sRGB with a full mip chain filtered in
+	// linear space, laid out as a texture blob (TextureBlobHeader + mips) ready for Texture::Upload.
+	// Shared by AssetCooker and the AssetLoader fallback for textures missing from the mounted package.
+	class TextureImporter
+	{
+	public:
+		TextureImporter()	= delete;
+		~TextureImporter()	= delete;
+
+		static bool Import(const std::filesystem::path& imagePath, std::vector<uint8_t>& blob);
+
+	private:
+		// 2x2 box filter, color in linear space, alpha as is. Odd edges reuse their last row or column.
+		static std::vector<uint8_t> Downsample(const std::vector<uint8_t>& source, uint32_t width, uint32_t height);
+
+		static float	SrgbToLinear(uint8_t value);
+		static uint8_t	LinearToSrgb(float value);
+	};
+
+}
@@ -0,0 +1,244 @@
+#include "VulkanAbstraction/Commands/CommandBucket.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "Core/Application.h"
+#include "Core/LogSystem.h"
+
+#include <algorithm>
+#include <chrono>
+
+
+namespace VulkanEngine {
+
+	uint32_t SortKey::Depth(float distance, bool backToFront)
+	{
+		constexpr uint32_t maxDepth = (1u << kDepthBits) - 1;
+
+		uint32_t depth = static_cast<uint32_t>(std::clamp(distance, 0.0f, 1.0f) * maxDepth);
+		return backToFront ? maxDepth - depth : depth;
+	}
+
+	CommandBucket::CommandBucket()
+		: m_Threads(Application::GetRaw()->GetJobSystem()->GetThreadCount() + 1)
+	{
+	}
+
+	void CommandBucket::Submit(uint64_t key, const RenderCommand& command)
+	{
+		// The last one is the render thread's (JobSystem::RegisterRenderThread)
+		uint32_t threadIndex = JobSystem::GetThreadIndex();
+		if (threadIndex >= m_Threads.size())
+		{
+			VulkanEngine_ERROR("Command bucket: submitted from a thread outside the job system, dropped");
+			return;
+		}
+
+		ThreadCommands& thread = m_Threads[threadIndex];
+
+		if (thread.commands.size() > kIndexMask)
+		{
+			VulkanEngine_ERROR("Command bucket: too many commands from one thread, dropped");
+			return;
+		}
+
+		thread.entries.push_back({ key, (threadIndex << kThreadShift) | static_cast<uint32_t>(thread.commands.size()) });
+		thread.commands.push_back(command);
+	}
+
+	void CommandBucket::Sort()
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		m_Sorted.clear();
+		for (const ThreadCommands& thread : m_Threads)
+			m_Sorted.insert(m_Sorted.end(), thread.entries.begin(), thread.entries.end());
+
+		uint32_t count = static_cast<uint32_t>(m_Sorted.size());
+		m_Scratch.resize(count);
+
+		// Bytes every key shares don't need a pass, usually the pass byte and most of the pipeline one
+		uint64_t anyBits = 0;
+		uint64_t allBits = ~0ull;
+		for (const Entry& entry : m_Sorted)
+		{
+			anyBits |= entry.key;
+			allBits &= entry.key;
+		}
+		uint64_t varyingBits = anyBits ^ allBits;
+
+		JobSystem* jobSystem = Application::GetRaw()->GetJobSystem();
+		uint32_t chunkCount = (count + kSortGrain - 1) / kSortGrain;
+		m_Histograms.resize(chunkCount);
+
+		// Least significant byte first, each pass stable
+		for (uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			if (((varyingBits >> shift) & 0xFF) == 0)
+				continue;
+
+			jobSystem->ParallelFor(chunkCount, 1,
+				[&](uint32_t firstChunk, uint32_t lastChunk)
+				{
+					for (uint32_t chunk = firstChunk; chunk < lastChunk; ++chunk)
+					{
+						auto& histogram = m_Histograms[chunk];
+						histogram.fill(0);
+
+						uint32_t last = std::min(count, (chunk + 1) * kSortGrain);
+						for (uint32_t i = chunk * kSortGrain; i < last; ++i)
+							histogram[(m_Sorted[i].key >> shift) & 0xFF]++;
+					}
+				});
+
+			// Digit major, so every chunk scatters into its own slice of each digit's range
+			uint32_t offset = 0;
+			for (uint32_t digit = 0; digit < 256; ++digit)
+			{
+				for (auto& histogram : m_Histograms)
+				{
+					uint32_t digitCount = histogram[digit];
+					histogram[digit] = offset;
+					offset += digitCount;
+				}
+			}
+
+			jobSystem->ParallelFor(chunkCount, 1,
+				[&](uint32_t firstChunk, uint32_t lastChunk)
+				{
+					for (uint32_t chunk = firstChunk; chunk < lastChunk; ++chunk)
+					{
+						auto& histogram = m_Histograms[chunk];
+
+						uint32_t last = std::min(count, (chunk + 1) * kSortGrain);
+						for (uint32_t i = chunk * kSortGrain; i < last; ++i)
+							m_Scratch[histogram[(m_Sorted[i].key >> shift) & 0xFF]++] = m_Sorted[i];
+					}
+				});
+
+			std::swap(m_Sorted, m_Scratch);
+		}
+
+		m_Stats = {};
+		m_Stats.commands			= count;
+		m_Stats.sortMilliseconds	= std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void CommandBucket::Record(uint32_t grainSize)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		uint32_t count = static_cast<uint32_t>(m_Sorted.size());
+		grainSize = std::max(1u, grainSize);
+
+		std::vector<CommandBucketStats> chunkStats((count + grainSize - 1) / grainSize);
+
+		VulkanRenderer::RecordParallel(count, grainSize,
+			[&](VkCommandBuffer cmd, uint32_t first, uint32_t last)
+			{
+				RecordRange(cmd, first, last, chunkStats[first / grainSize]);
+			});
+
+		for (const CommandBucketStats& stats : chunkStats)
+		{
+			m_Stats.pipelineBinds		+= stats.pipelineBinds;
+			m_Stats.materialBinds		+= stats.materialBinds;
+			m_Stats.indexBufferBinds	+= stats.indexBufferBinds;
+			m_Stats.elidedBinds			+= stats.elidedBinds;
+		}
+
+		m_Stats.recordMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void CommandBucket::RecordRange(VkCommandBuffer cmd, uint32_t first, uint32_t last, CommandBucketStats& stats) const
+	{
+		VkPipeline			pipeline	= VK_NULL_HANDLE;
+		VkPipelineLayout	layout		= VK_NULL_HANDLE;
+		VkDescriptorSet		material	= VK_NULL_HANDLE;
+		VkBuffer			indexBuffer = VK_NULL_HANDLE;
+		VkIndexType			indexType	= VK_INDEX_TYPE_UINT32;
+
+		for (uint32_t i = first; i < last; ++i)
+		{
+			const RenderCommand& command = GetCommand(m_Sorted[i].command);
+
+			if (command.pipeline != pipeline)
+			{
+				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, command.pipeline);
+				pipeline = command.pipeline;
+				stats.pipelineBinds++;
+			}
+			else
+			{
+				stats.elidedBinds++;
+			}
+
+			// A different layout may not be compatible with the bound set, rebind then too
+			if (command.material != VK_NULL_HANDLE)
+			{
+				if (command.material != material || command.layout != layout)
+				{
+					vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, command.layout, 0, 1, &command.material, 0, nullptr);
+					material	= command.material;
+					layout		= command.layout;
+					stats.materialBinds++;
+				}
+				else
+				{
+					stats.elidedBinds++;
+				}
+			}
+
+			if (command.type == RenderCommand::Type::DrawIndexed)
+			{
+				if (command.indexBuffer != indexBuffer || command.indexType != indexType)
+				{
+					vkCmdBindIndexBuffer(cmd, command.indexBuffer, 0, command.indexType);
+					indexBuffer = command.indexBuffer;
+					indexType	= command.indexType;
+					stats.indexBufferBinds++;
+				}
+				else
+				{
+					stats.elidedBinds++;
+				}
+			}
+
+			if (command.pushConstantSize > 0)
+			{
+				uint32_t size = std::min<uint32_t>(command.pushConstantSize, sizeof(command.pushConstants));
+				vkCmdPushConstants(cmd, command.layout, command.pushConstantStages, 0, size, command.pushConstants.data());
+			}
+
+			switch (command.type)
+			{
+			case RenderCommand::Type::Draw:
+				vkCmdDraw(cmd, command.count, command.instanceCount, command.first, command.firstInstance);
+				break;
+
+			case RenderCommand::Type::DrawIndexed:
+				vkCmdDrawIndexed(cmd, command.count, command.instanceCount, command.first, command.vertexOffset, command.firstInstance);
+				break;
+			}
+		}
+	}
+
+	void CommandBucket::Clear()
+	{
+		for (ThreadCommands& thread : m_Threads)
+		{
+			thread.entries.clear();
+			thread.commands.clear();
+		}
+
+		m_Sorted.clear();
+	}
+
+	uint32_t CommandBucket::GetCount() const
+	{
+		uint32_t count = 0;
+		for (const ThreadCommands& thread : m_Threads)
+			count += static_cast<uint32_t>(thread.entries.size());
+
+		return count;
+	}
+
+}
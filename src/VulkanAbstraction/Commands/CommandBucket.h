@@ -0,0 +1,156 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+
+namespace VulkanEngine {
+
+	// Draw order, most significant first: pass (8 bits), pipeline (16), material (16), depth (24).
+	// Commands of a pass end up grouped by pipeline, then by material, then ordered by depth.
+	struct SortKey
+	{
+		static constexpr uint32_t kDepthBits	= 24;
+		static constexpr uint32_t kMaterialBits = 16;
+		static constexpr uint32_t kPipelineBits = 16;
+		static constexpr uint32_t kPassBits		= 8;
+
+		static constexpr uint64_t Make(uint8_t pass, uint16_t pipeline, uint16_t material, uint32_t depth)
+		{
+			return (uint64_t(pass) << (kPipelineBits + kMaterialBits + kDepthBits))
+				| (uint64_t(pipeline) << (kMaterialBits + kDepthBits))
+				| (uint64_t(material) << kDepthBits)
+				| (depth & ((1u << kDepthBits) - 1));
+		}
+
+		// Handles folded to 16 bits: a collision only interleaves two groups, binds compare the real handles
+		template<typename Handle>
+		static uint64_t Make(uint8_t pass, Handle pipeline, VkDescriptorSet material, uint32_t depth)
+		{
+			return Make(pass, Fold(pipeline), Fold(material), depth);
+		}
+
+		// distance in [0, 1] from the near plane; opaque passes sort front to back, blended ones back to front
+		static uint32_t Depth(float distance, bool backToFront = false);
+
+		template<typename Handle>
+		static uint16_t Fold(Handle handle)
+		{
+			uint64_t value;
+			if constexpr (std::is_pointer_v<Handle>)
+				value = reinterpret_cast<uintptr_t>(handle);
+			else
+				value = static_cast<uint64_t>(handle);
+
+			value ^= value >> 32;
+			value ^= value >> 16;
+			return static_cast<uint16_t>(value);
+		}
+	};
+
+	// A draw as plain data, recorded later in key order
+	struct RenderCommand
+	{
+		enum class Type : uint8_t
+		{
+			Draw,
+			DrawIndexed
+		};
+
+		Type					type{ Type::Draw };
+		VkIndexType				indexType{ VK_INDEX_TYPE_UINT32 };
+
+		VkPipeline				pipeline{ VK_NULL_HANDLE };
+		VkPipelineLayout		layout{ VK_NULL_HANDLE };
+		VkDescriptorSet			material{ VK_NULL_HANDLE };		// set 0, optional
+		VkBuffer				indexBuffer{ VK_NULL_HANDLE };	// DrawIndexed
+
+		uint32_t				count{ 0 };			// vertices or indices
+		uint32_t				instanceCount{ 1 };
+		uint32_t				first{ 0 };			// first vertex or index
+		int32_t					vertexOffset{ 0 };	// DrawIndexed
+		uint32_t				firstInstance{ 0 };	// object index for per-draw data in a storage buffer
+
+		// Small per-draw push constants at offset 0, e.g. a buffer address and an index
+		VkShaderStageFlags		pushConstantStages{ 0 };
+		uint32_t				pushConstantSize{ 0 }; // bytes, 0 for none
+		std::array<uint32_t, 4> pushConstants{};
+	};
+
+	struct CommandBucketStats
+	{
+		uint32_t commands			= 0;
+		uint32_t pipelineBinds		= 0;
+		uint32_t materialBinds		= 0;
+		uint32_t indexBufferBinds	= 0;
+		uint32_t elidedBinds		= 0; // skipped since the state was already bound
+		double	 sortMilliseconds	= 0.0;
+		double	 recordMilliseconds = 0.0;
+	};
+
+	// Collects draws from any job system thread or the render thread without locking, radix sorts them by key in parallel and
+	// records them with redundant pipeline, descriptor set and index buffer binds left out.
+	// Submit, Sort and Record belong to one frame: with the render thread on, either fill the bucket in
+	// OnRecord or keep one per queued frame packet, since OnPrepareRender already runs for the next frame.
+	// Commands with equal keys keep their submission order per thread only.
+	class CommandBucket
+	{
+	public:
+		CommandBucket();
+		virtual ~CommandBucket() = default;
+		CommandBucket(const CommandBucket&)				= delete;
+		CommandBucket& operator=(const CommandBucket&)	= delete;
+
+		// Any job system thread, or the render thread. Dropped from any other thread, two of them would share a slot.
+		void Submit(uint64_t key, const RenderCommand& command);
+
+		void Sort();
+
+		// Inside the caller's rendering scope. In a stream, chunks of grainSize record in parallel and
+		// each starts from unbound state.
+		void Record(uint32_t grainSize = 512);
+
+		// Keeps the capacity for next frame
+		void Clear();
+
+		uint32_t GetCount() const;
+		const CommandBucketStats& GetStats() const { return m_Stats; }
+
+	private:
+		struct Entry
+		{
+			uint64_t key{ 0 };
+			uint32_t command{ 0 }; // thread << kThreadShift | index in the thread's list
+		};
+
+		// Own cache line, neighbouring threads submit at the same time
+		struct alignas(64) ThreadCommands
+		{
+			std::vector<Entry>			entries;
+			std::vector<RenderCommand>	commands;
+		};
+
+		const RenderCommand& GetCommand(uint32_t command) const
+		{
+			return m_Threads[command >> kThreadShift].commands[command & kIndexMask];
+		}
+
+		void RecordRange(VkCommandBuffer cmd, uint32_t first, uint32_t last, CommandBucketStats& stats) const;
+
+	private:
+		static constexpr uint32_t kThreadShift	= 24;
+		static constexpr uint32_t kIndexMask	= (1u << kThreadShift) - 1;
+		static constexpr uint32_t kSortGrain	= 4096; // entries per histogram chunk
+
+		std::vector<ThreadCommands>				m_Threads; // job system threads, then the render thread
+		std::vector<Entry>						m_Sorted;
+		std::vector<Entry>						m_Scratch;
+		std::vector<std::array<uint32_t, 256>>	m_Histograms; // per chunk, per digit
+
+		CommandBucketStats						m_Stats;
+	};
+
+}
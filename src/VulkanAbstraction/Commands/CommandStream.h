@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+
+namespace VulkanEngine {
+
+	// What one recorder produced for a frame, in order: secondaries, and the rendering scopes around them,
+	// which have to begin and end in the primary for secondaries to draw inside. Filled between
+	// VulkanRenderer::BeginStream and EndStream, replayed into the primary by ExecuteStream.
+	struct CommandStream
+	{
+		enum class EntryType : uint8_t
+		{
+			Execute,
+			BeginRendering,
+			EndRendering
+		};
+
+		struct Entry
+		{
+			EntryType		type{ EntryType::Execute };
+			VkCommandBuffer cmd{ VK_NULL_HANDLE };	// Execute
+			bool			withDepth{ false };		// BeginRendering
+		};
+
+		std::vector<Entry> entries;
+
+		void Clear() { entries.clear(); }
+	};
+
+}
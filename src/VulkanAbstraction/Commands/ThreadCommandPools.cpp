@@ -0,0 +1,70 @@
+#include "VulkanAbstraction/Commands/ThreadCommandPools.h"
+#include "Core/Application.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+#include <algorithm>
+
+
+namespace VulkanEngine {
+
+	ThreadCommandPools::ThreadCommandPools(VkDevice device, uint32_t queueFamily, uint32_t threadCount, uint32_t framesInFlight)
+		: m_Device(device), m_Pools(framesInFlight)
+	{
+		auto* app = Application::GetRaw();
+
+		for (auto& framePools : m_Pools)
+		{
+			framePools.resize(threadCount + 1);
+
+			for (ThreadPool& threadPool : framePools)
+			{
+				// Reset as a whole every frame
+				VkCommandPoolCreateInfo poolInfo = VulkanUtils::GetCommandPoolInfo(VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, queueFamily);
+
+				CHECK_VK_RES(vkCreateCommandPool(device, &poolInfo, nullptr, &threadPool.pool));
+				app->GetLifetimeManager()->Push(vkDestroyCommandPool, device, threadPool.pool, nullptr);
+			}
+		}
+	}
+
+	void ThreadCommandPools::Reset(uint32_t frameIndex)
+	{
+		for (ThreadPool& threadPool : m_Pools[frameIndex])
+		{
+			if (threadPool.used == 0)
+				continue;
+
+			CHECK_VK_RES(vkResetCommandPool(m_Device, threadPool.pool, 0));
+			threadPool.used = 0;
+		}
+	}
+
+	VkCommandBuffer ThreadCommandPools::AcquireSecondary(uint32_t frameIndex)
+	{
+		auto& framePools = m_Pools[frameIndex];
+
+		// The last one is the render thread's (JobSystem::RegisterRenderThread)
+		uint32_t threadIndex = JobSystem::GetThreadIndex();
+		if (threadIndex >= framePools.size())
+		{
+			VulkanEngine_CRITICAL("Secondary command buffer acquired outside the job system and the render thread");
+			abort();
+		}
+
+		ThreadPool& threadPool = framePools[threadIndex];
+
+		if (threadPool.used == threadPool.secondaries.size())
+		{
+			VkCommandBufferAllocateInfo allocInfo = VulkanUtils::GetCmdBufferAllocateInfo(threadPool.pool, 1);
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+
+			VkCommandBuffer cmd = VK_NULL_HANDLE;
+			CHECK_VK_RES(vkAllocateCommandBuffers(m_Device, &allocInfo, &cmd));
+			threadPool.secondaries.push_back(cmd);
+		}
+
+		return threadPool.secondaries[threadPool.used++];
+	}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+
+namespace VulkanEngine {
+
+	// A command pool per job system thread per frame in flight, so threads allocate and record secondaries
+	// without locking, plus one for the render thread, the only thread outside the job system that records.
+	// Pools are reset as a whole once their frame's fence is signaled, the buffers they handed out are
+	// reused from then on.
+	class ThreadCommandPools
+	{
+	public:
+		ThreadCommandPools(VkDevice device, uint32_t queueFamily, uint32_t threadCount, uint32_t framesInFlight);
+		virtual ~ThreadCommandPools() = default;
+		ThreadCommandPools(const ThreadCommandPools&)				= delete;
+		ThreadCommandPools& operator=(const ThreadCommandPools&)	= delete;
+
+		// After the frame's fence wait, before anything records for it
+		void Reset(uint32_t frameIndex);
+
+		// From the calling thread's pool, not begun. Job system threads and the render thread only.
+		VkCommandBuffer AcquireSecondary(uint32_t frameIndex);
+
+	private:
+		// Own cache line, neighbouring threads allocate at the same time
+		struct alignas(64) ThreadPool
+		{
+			VkCommandPool					pool{ VK_NULL_HANDLE };
+			std::vector<VkCommandBuffer>	secondaries;
+			uint32_t						used{ 0 };
+		};
+
+	private:
+		VkDevice								m_Device{ VK_NULL_HANDLE };
+		std::vector<std::vector<ThreadPool>>	m_Pools; // [frame][thread]
+	};
+
+}
@@ -0,0 +1,87 @@
+#include "VulkanAbstraction/Compute/ComputePassSequence.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	static constexpr VkAccessFlags2 kShaderReadWrite = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+	ComputePassSequence& ComputePassSequence::AddPass(ComputePass pass)
+	{
+		m_Passes.push_back(std::move(pass));
+		return *this;
+	}
+
+	void ComputePassSequence::Record(VkCommandBuffer cmd)
+	{
+		// Counts start at zero every frame
+		std::vector<IndirectArgumentBuffer*> argumentBuffers;
+		for (auto& pass : m_Passes)
+		{
+			for (auto* arguments : pass.arguments)
+			{
+				if (std::find(argumentBuffers.begin(), argumentBuffers.end(), arguments) == argumentBuffers.end())
+				{
+					arguments->Reset(cmd);
+					argumentBuffers.push_back(arguments);
+				}
+			}
+		}
+
+		for (auto& pass : m_Passes)
+		{
+			for (auto* buffer : pass.reads)
+			{
+				VulkanUtils::InsertBufferMemoryBarrier(cmd, buffer->buffer, buffer->bufferState,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+			}
+
+			for (auto* buffer : pass.writes)
+			{
+				VulkanUtils::InsertBufferMemoryBarrier(cmd, buffer->buffer, buffer->bufferState,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, kShaderReadWrite);
+			}
+
+			for (auto* arguments : pass.arguments)
+			{
+				AllocatedBuffer& buffer = arguments->GetBuffer();
+				VulkanUtils::InsertBufferMemoryBarrier(cmd, buffer.buffer, buffer.bufferState,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, kShaderReadWrite);
+			}
+
+			if (pass.indirectArguments)
+			{
+				AllocatedBuffer& buffer = pass.indirectArguments->GetBuffer();
+				VulkanUtils::InsertBufferMemoryBarrier(cmd, buffer.buffer, buffer.bufferState,
+					VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+			}
+
+			vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass.pipeline->GetRaw());
+
+			if (pass.bind)
+				pass.bind(cmd, pass.layout);
+
+			if (pass.indirectArguments)
+			{
+				VkDeviceSize offset = IndirectArgumentBuffer::kCommandsOffset +
+					VkDeviceSize(pass.indirectCommand) * pass.indirectArguments->GetStride();
+
+				vkCmdDispatchIndirect(cmd, pass.indirectArguments->GetBuffer().buffer, offset);
+			}
+			else
+			{
+				vkCmdDispatch(cmd, pass.groupCount.width, pass.groupCount.height, pass.groupCount.depth);
+			}
+		}
+
+		// Consumed by indirect commands later in the frame
+		for (auto* arguments : argumentBuffers)
+		{
+			AllocatedBuffer& buffer = arguments->GetBuffer();
+			VulkanUtils::InsertBufferMemoryBarrier(cmd, buffer.buffer, buffer.bufferState,
+				VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+		}
+	}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "VulkanAbstraction/Compute/IndirectArgumentBuffer.h"
+#include "VulkanAbstraction/Pipelines/VulkanPipeline.h"
+
+
+namespace VulkanEngine {
+
+	struct ComputePass
+	{
+		using BindCallback = std::function<void(VkCommandBuffer cmd, VkPipelineLayout layout)>;
+
+		std::string							name;
+		std::shared_ptr<VulkanPipeline>		pipeline;
+		VkPipelineLayout					layout{ VK_NULL_HANDLE };
+		BindCallback						bind; // descriptor sets + push constants
+
+		// Fixed group count, or a VkDispatchIndirectCommand written by an earlier pass
+		VkExtent3D							groupCount{ 1, 1, 1 };
+		IndirectArgumentBuffer*				indirectArguments{ nullptr };
+		uint32_t							indirectCommand{ 0 };
+
+		// Storage buffers the shader accesses, barriers are derived from these
+		std::vector<AllocatedBuffer*>		reads;
+		std::vector<AllocatedBuffer*>		writes;
+		std::vector<IndirectArgumentBuffer*> arguments; // appended to, reset at the start of the sequence
+	};
+
+	// Ordered compute passes that produce GPU-decided workloads (culling, compaction, adaptive work).
+	// Record() resets every argument buffer, orders each pass after the passes whose outputs it uses
+	// and leaves the argument buffers ready for indirect draws and dispatches later in the frame,
+	// without any CPU readback.
+	class ComputePassSequence
+	{
+	public:
+		ComputePassSequence() = default;
+		virtual ~ComputePassSequence() = default;
+
+		ComputePassSequence& AddPass(ComputePass pass);
+
+		// Must be recorded outside rendering
+		void Record(VkCommandBuffer cmd);
+
+		const std::vector<ComputePass>& GetPasses() const { return m_Passes; }
+		ComputePass& GetPass(size_t index) { return m_Passes[index]; } // group counts may change between frames
+
+	private:
+		std::vector<ComputePass> m_Passes;
+	};
+
+}
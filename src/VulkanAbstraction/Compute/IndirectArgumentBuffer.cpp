@@ -0,0 +1,29 @@
+#include "VulkanAbstraction/Compute/IndirectArgumentBuffer.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	IndirectArgumentBuffer::IndirectArgumentBuffer(uint32_t maxCommands, uint32_t commandStride)
+		: m_MaxCommands(maxCommands), m_Stride(commandStride)
+	{
+		VkBufferUsageFlags usage =
+			VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+			VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+		m_Buffer = VulkanRenderer::CreateBuffer(kCommandsOffset + VkDeviceSize(maxCommands) * commandStride, usage);
+	}
+
+	void IndirectArgumentBuffer::Reset(VkCommandBuffer cmd)
+	{
+		VulkanUtils::InsertBufferMemoryBarrier(
+			cmd, m_Buffer.buffer, m_Buffer.bufferState,
+			VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT
+		);
+
+		vkCmdFillBuffer(cmd, m_Buffer.buffer, kCountOffset, sizeof(uint32_t), 0);
+	}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanAbstraction/VulkanTypes.h"
+
+
+namespace VulkanEngine {
+
+	// Argument buffer filled on the GPU and consumed by indirect commands later in the same frame.
+	// Layout: a uint32 command count, padding, then up to maxCommands commands of commandStride bytes.
+	// Shaders reach both through the buffer device address (GetCountAddress, GetCommandsAddress)
+	// and append with atomicAdd on the count.
+	class IndirectArgumentBuffer
+	{
+	public:
+		static constexpr VkDeviceSize kCountOffset		= 0;
+		static constexpr VkDeviceSize kCommandsOffset	= 16;
+
+		IndirectArgumentBuffer(uint32_t maxCommands, uint32_t commandStride);
+		virtual ~IndirectArgumentBuffer() = default;
+
+		// Zeroes the count, ordered after last frame's indirect reads
+		void Reset(VkCommandBuffer cmd);
+
+		AllocatedBuffer&	GetBuffer()				{ return m_Buffer; }
+		uint32_t			GetMaxCommands() const	{ return m_MaxCommands; }
+		uint32_t			GetStride()		const	{ return m_Stride; }
+		VkDeviceAddress		GetCountAddress()		const { return m_Buffer.address + kCountOffset; }
+		VkDeviceAddress		GetCommandsAddress()	const { return m_Buffer.address + kCommandsOffset; }
+
+	private:
+		AllocatedBuffer m_Buffer;
+		uint32_t		m_MaxCommands{ 0 };
+		uint32_t		m_Stride{ 0 };
+	};
+
+}
@@ -36,7 +36,9 @@ namespace VulkanEngine {
 		VkPhysicalDeviceVulkan12Features features12 = {
 			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
 			.pNext = nullptr,
+			.drawIndirectCount   = VK_TRUE,
 			.descriptorIndexing  = VK_TRUE,
+			.timelineSemaphore   = VK_TRUE,
 			.bufferDeviceAddress = VK_TRUE
 		};
 
@@ -50,12 +52,89 @@ namespace VulkanEngine {
 		VkPhysicalDeviceFeatures2 features2 = {
 			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
 			.pNext = &features13,
+			.features = {
+				.multiDrawIndirect			= VK_TRUE,
+				.drawIndirectFirstInstance	= VK_TRUE
+			}
 		};
 
-		const std::vector<const char*> deviceExtensions = {
+		std::vector<const char*> deviceExtensions = {
 			VK_KHR_SWAPCHAIN_EXTENSION_NAME
 		};
 
+		// Optional: VK_EXT_shader_object
+		VkPhysicalDeviceShaderObjectFeaturesEXT shaderObjectFeatures = {
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT,
+			.pNext = nullptr
+		};
+
+		if (physDevice.IsExtensionSupported(VK_EXT_SHADER_OBJECT_EXTENSION_NAME))
+		{
+			VkPhysicalDeviceFeatures2 query = {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+				.pNext = &shaderObjectFeatures
+			};
+			vkGetPhysicalDeviceFeatures2(physDevice.GetRaw(), &query);
+
+			if (shaderObjectFeatures.shaderObject)
+			{
+				shaderObjectFeatures.pNext	= features2.pNext;
+				features2.pNext				= &shaderObjectFeatures;
+				deviceExtensions.push_back(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+			}
+		}
+
+		// Optional: VK_EXT_graphics_pipeline_library
+		VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT gplFeatures = {
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+			.pNext = nullptr
+		};
+
+		if (physDevice.IsExtensionSupported(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+			physDevice.IsExtensionSupported(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME))
+		{
+			VkPhysicalDeviceFeatures2 query = {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+				.pNext = &gplFeatures
+			};
+			vkGetPhysicalDeviceFeatures2(physDevice.GetRaw(), &query);
+
+			if (gplFeatures.graphicsPipelineLibrary)
+			{
+				gplFeatures.pNext	= features2.pNext;
+				features2.pNext		= &gplFeatures;
+				deviceExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+				deviceExtensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+			}
+		}
+
+		// Optional: VK_EXT_mesh_shader, task and mesh stages only
+		VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures = {
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT,
+			.pNext = nullptr
+		};
+
+		if (physDevice.IsExtensionSupported(VK_EXT_MESH_SHADER_EXTENSION_NAME))
+		{
+			VkPhysicalDeviceFeatures2 query = {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+				.pNext = &meshShaderFeatures
+			};
+			vkGetPhysicalDeviceFeatures2(physDevice.GetRaw(), &query);
+
+			if (meshShaderFeatures.taskShader && meshShaderFeatures.meshShader)
+			{
+				// These depend on features that are never enabled (multiview, shading rate, queries)
+				meshShaderFeatures.multiviewMeshShader						= VK_FALSE;
+				meshShaderFeatures.primitiveFragmentShadingRateMeshShader	= VK_FALSE;
+				meshShaderFeatures.meshShaderQueries						= VK_FALSE;
+
+				meshShaderFeatures.pNext	= features2.pNext;
+				features2.pNext				= &meshShaderFeatures;
+				deviceExtensions.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+			}
+		}
+
 		// Create Logical Device
 		VkDeviceCreateInfo createInfo = {
 			.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
@@ -69,6 +148,25 @@ namespace VulkanEngine {
 
 		CHECK_VK_RES(vkCreateDevice(physDevice.GetRaw(), &createInfo, nullptr, &m_Device));
 
+		m_EnabledExtensions.insert(deviceExtensions.begin(), deviceExtensions.end());
+
+		if (IsExtensionEnabled(VK_EXT_SHADER_OBJECT_EXTENSION_NAME))
+		{
+			m_ExtensionFunctions.LoadShaderObject(m_Device);
+			VulkanEngine_INFO("VK_EXT_shader_object enabled");
+		}
+
+		if (IsExtensionEnabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME))
+		{
+			VulkanEngine_INFO("VK_EXT_graphics_pipeline_library enabled");
+		}
+
+		if (IsExtensionEnabled(VK_EXT_MESH_SHADER_EXTENSION_NAME))
+		{
+			m_ExtensionFunctions.LoadMeshShader(m_Device);
+			VulkanEngine_INFO("VK_EXT_mesh_shader enabled");
+		}
+
 		// Retrieve Queues
 		vkGetDeviceQueue(m_Device, physDevice.GetGraphicsFamily(), 0, &m_GraphicsQueue);
 		vkGetDeviceQueue(m_Device, physDevice.GetPresentationFamily(), 0, &m_PresentationQueue);
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <set>
+#include <string>
+
+#include "VulkanAbstraction/Core/VulkanExtensions.h"
 
 
 namespace VulkanEngine {
@@ -15,12 +19,18 @@ namespace VulkanEngine {
         VkQueue  GetGraphicsQueue()      const { return m_GraphicsQueue;        }
         VkQueue  GetPresentationQueue()  const { return m_PresentationQueue;    }
 
+        bool IsExtensionEnabled(const char* extensionName)  const { return m_EnabledExtensions.contains(extensionName); }
+        const ExtensionFunctions& GetExtensionFunctions()   const { return m_ExtensionFunctions; }
+
         operator VkDevice() const { return m_Device; }
 
     private:
         VkDevice m_Device               = VK_NULL_HANDLE;
         VkQueue  m_GraphicsQueue        = VK_NULL_HANDLE;
         VkQueue  m_PresentationQueue    = VK_NULL_HANDLE;
+
+        std::set<std::string, std::less<>>  m_EnabledExtensions;
+        ExtensionFunctions                  m_ExtensionFunctions;
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,39 @@
+#include "VulkanAbstraction/Core/VulkanExtensions.h"
+#include "Core/LogSystem.h"
+
+
+namespace VulkanEngine {
+
+    template<typename PFN>
+    static void LoadDeviceFunction(VkDevice device, PFN& function, const char* name)
+    {
+        function = reinterpret_cast<PFN>(vkGetDeviceProcAddr(device, name));
+
+        if (function == nullptr)
+            VulkanEngine_ERROR(fmt::runtime("Failed to load device function: {}"), name);
+    }
+
+    void ExtensionFunctions::LoadShaderObject(VkDevice device)
+    {
+        LoadDeviceFunction(device, vkCreateShadersEXT,                  "vkCreateShadersEXT");
+        LoadDeviceFunction(device, vkDestroyShaderEXT,                  "vkDestroyShaderEXT");
+        LoadDeviceFunction(device, vkGetShaderBinaryDataEXT,            "vkGetShaderBinaryDataEXT");
+        LoadDeviceFunction(device, vkCmdBindShadersEXT,                 "vkCmdBindShadersEXT");
+        LoadDeviceFunction(device, vkCmdSetPolygonModeEXT,              "vkCmdSetPolygonModeEXT");
+        LoadDeviceFunction(device, vkCmdSetRasterizationSamplesEXT,     "vkCmdSetRasterizationSamplesEXT");
+        LoadDeviceFunction(device, vkCmdSetSampleMaskEXT,               "vkCmdSetSampleMaskEXT");
+        LoadDeviceFunction(device, vkCmdSetAlphaToCoverageEnableEXT,    "vkCmdSetAlphaToCoverageEnableEXT");
+        LoadDeviceFunction(device, vkCmdSetColorBlendEnableEXT,         "vkCmdSetColorBlendEnableEXT");
+        LoadDeviceFunction(device, vkCmdSetColorBlendEquationEXT,       "vkCmdSetColorBlendEquationEXT");
+        LoadDeviceFunction(device, vkCmdSetColorWriteMaskEXT,           "vkCmdSetColorWriteMaskEXT");
+        LoadDeviceFunction(device, vkCmdSetVertexInputEXT,              "vkCmdSetVertexInputEXT");
+    }
+
+    void ExtensionFunctions::LoadMeshShader(VkDevice device)
+    {
+        LoadDeviceFunction(device, vkCmdDrawMeshTasksEXT,               "vkCmdDrawMeshTasksEXT");
+        LoadDeviceFunction(device, vkCmdDrawMeshTasksIndirectEXT,       "vkCmdDrawMeshTasksIndirectEXT");
+        LoadDeviceFunction(device, vkCmdDrawMeshTasksIndirectCountEXT,  "vkCmdDrawMeshTasksIndirectCountEXT");
+    }
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+
+namespace VulkanEngine {
+
+    // Device-level entry points of optional extensions.
+    // The loader does not export them, so they are resolved with vkGetDeviceProcAddr
+    // and stay nullptr when the extension is not enabled.
+    struct ExtensionFunctions
+    {
+        // VK_EXT_shader_object
+        PFN_vkCreateShadersEXT                      vkCreateShadersEXT                      = nullptr;
+        PFN_vkDestroyShaderEXT                      vkDestroyShaderEXT                      = nullptr;
+        PFN_vkGetShaderBinaryDataEXT                vkGetShaderBinaryDataEXT                = nullptr;
+        PFN_vkCmdBindShadersEXT                     vkCmdBindShadersEXT                     = nullptr;
+        PFN_vkCmdSetPolygonModeEXT                  vkCmdSetPolygonModeEXT                  = nullptr;
+        PFN_vkCmdSetRasterizationSamplesEXT         vkCmdSetRasterizationSamplesEXT         = nullptr;
+        PFN_vkCmdSetSampleMaskEXT                   vkCmdSetSampleMaskEXT                   = nullptr;
+        PFN_vkCmdSetAlphaToCoverageEnableEXT        vkCmdSetAlphaToCoverageEnableEXT        = nullptr;
+        PFN_vkCmdSetColorBlendEnableEXT             vkCmdSetColorBlendEnableEXT             = nullptr;
+        PFN_vkCmdSetColorBlendEquationEXT           vkCmdSetColorBlendEquationEXT           = nullptr;
+        PFN_vkCmdSetColorWriteMaskEXT               vkCmdSetColorWriteMaskEXT               = nullptr;
+        PFN_vkCmdSetVertexInputEXT                  vkCmdSetVertexInputEXT                  = nullptr;
+
+        // VK_EXT_mesh_shader
+        PFN_vkCmdDrawMeshTasksEXT                   vkCmdDrawMeshTasksEXT                   = nullptr;
+        PFN_vkCmdDrawMeshTasksIndirectEXT           vkCmdDrawMeshTasksIndirectEXT           = nullptr;
+        PFN_vkCmdDrawMeshTasksIndirectCountEXT      vkCmdDrawMeshTasksIndirectCountEXT      = nullptr;
+
+        void LoadShaderObject(VkDevice device);
+        void LoadMeshShader(VkDevice device);
+    };
+
+}
@@ -32,6 +32,15 @@ namespace VulkanEngine {
         // Store indices
         m_Indices = FindQueueFamilies(m_PhysicalDevice);
 
+        // Store extensions, optional features are enabled from this list
+        uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &extensionCount, extensions.data());
+
+        for (const auto& extension : extensions)
+            m_AvailableExtensions.insert(extension.extensionName);
+
         VulkanEngine_INFO(fmt::runtime("Selected GPU: {}"), GetName());
     }
 
@@ -75,7 +84,11 @@ namespace VulkanEngine {
             features13.dynamicRendering     && 
             features13.synchronization2     &&
             features12.bufferDeviceAddress  && 
-            features12.descriptorIndexing;
+            features12.timelineSemaphore    &&
+            features12.descriptorIndexing   &&
+            features12.drawIndirectCount    &&
+            features2.features.multiDrawIndirect &&
+            features2.features.drawIndirectFirstInstance;
 
         if (!extensionsSupported || !queuesSupported || !featuresSupported)
             return 0;
@@ -3,6 +3,7 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <string>
+#include <set>
 
 
 namespace VulkanEngine {
@@ -30,6 +31,8 @@ namespace VulkanEngine {
         uint32_t GetGraphicsFamily()     const { return static_cast<uint32_t>(m_Indices.graphics); }
         uint32_t GetPresentationFamily() const { return static_cast<uint32_t>(m_Indices.presentation); }
 
+        bool IsExtensionSupported(const char* extensionName) const { return m_AvailableExtensions.contains(extensionName); }
+
         operator VkPhysicalDevice() const { return m_PhysicalDevice; }
 
     private:
@@ -41,6 +44,8 @@ namespace VulkanEngine {
     private:
         VkPhysicalDevice    m_PhysicalDevice = VK_NULL_HANDLE;
         QueueFamilyIndices  m_Indices;
+
+        std::set<std::string, std::less<>> m_AvailableExtensions;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "VulkanAbstraction/DeletionQueue.h"
+#include "VulkanAbstraction/Core/VulkanContext.h"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace VulkanEngine {
+
+	template<typename Handle>
+	static Handle ToHandle(uint64_t handle)
+	{
+		return reinterpret_cast<Handle>(handle);
+	}
+
+	DeletionQueue::DeletionQueue(VkDevice device, VmaAllocator allocator)
+		: m_Device(device), m_Allocator(allocator)
+	{
+	}
+
+	void DeletionQueue::BeginFrame(uint64_t frameNumber)
+	{
+		std::lock_guard lock(m_Mutex);
+		m_RetireValue = std::max(m_RetireValue, frameNumber + 1);
+	}
+
+	void DeletionQueue::Release(VkBuffer buffer, VmaAllocation allocation)
+	{
+		Push(DeletionType::Buffer, buffer, allocation);
+	}
+
+	void DeletionQueue::Release(VkImage image, VmaAllocation allocation)
+	{
+		Push(DeletionType::Image, image, allocation);
+	}
+
+	void DeletionQueue::Release(AllocatedBuffer& buffer)
+	{
+		Release(buffer.buffer, buffer.allocation);
+		buffer = {};
+	}
+
+	void DeletionQueue::Release(AllocatedImage& image)
+	{
+		Release(image.imageView);
+		Release(image.image, image.allocation);
+
+		image.image			= VK_NULL_HANDLE;
+		image.imageView		= VK_NULL_HANDLE;
+		image.allocation	= VK_NULL_HANDLE;
+		image.imageState	= {};
+	}
+
+	void DeletionQueue::Collect(uint64_t completedValue)
+	{
+		std::vector<Record> retired;
+		{
+			std::lock_guard lock(m_Mutex);
+
+			while (!m_Records.empty() && m_Records.front().retireValue <= completedValue)
+			{
+				retired.push_back(m_Records.front());
+				m_Records.pop_front();
+			}
+		}
+
+		// Outside the lock, releases from other threads don't wait on the driver
+		for (const Record& record : retired)
+			Destroy(record);
+	}
+
+	void DeletionQueue::Flush()
+	{
+		std::lock_guard lock(m_Mutex);
+
+		for (const Record& record : m_Records)
+			Destroy(record);
+
+		m_Records.clear();
+	}
+
+	size_t DeletionQueue::GetPendingCount() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Records.size();
+	}
+
+	uint64_t DeletionQueue::GetRetireValue() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_RetireValue;
+	}
+
+	void DeletionQueue::Destroy(const Record& record) const
+	{
+		switch (record.type)
+		{
+		case DeletionType::Buffer:
+			vmaDestroyBuffer(m_Allocator, ToHandle<VkBuffer>(record.handle), record.allocation);
+			break;
+
+		case DeletionType::Image:
+			vmaDestroyImage(m_Allocator, ToHandle<VkImage>(record.handle), record.allocation);
+			break;
+
+		case DeletionType::ImageView:
+			vkDestroyImageView(m_Device, ToHandle<VkImageView>(record.handle), nullptr);
+			break;
+
+		case DeletionType::Sampler:
+			vkDestroySampler(m_Device, ToHandle<VkSampler>(record.handle), nullptr);
+			break;
+
+		case DeletionType::Pipeline:
+			vkDestroyPipeline(m_Device, ToHandle<VkPipeline>(record.handle), nullptr);
+			break;
+
+		case DeletionType::PipelineLayout:
+			vkDestroyPipelineLayout(m_Device, ToHandle<VkPipelineLayout>(record.handle), nullptr);
+			break;
+
+		case DeletionType::ShaderModule:
+			vkDestroyShaderModule(m_Device, ToHandle<VkShaderModule>(record.handle), nullptr);
+			break;
+
+		case DeletionType::ShaderObject:
+			VulkanContext::GetRaw()->GetDevice()->GetExtensionFunctions().vkDestroyShaderEXT(
+				m_Device, ToHandle<VkShaderEXT>(record.handle), nullptr);
+			break;
+
+		case DeletionType::DescriptorPool:
+			vkDestroyDescriptorPool(m_Device, ToHandle<VkDescriptorPool>(record.handle), nullptr);
+			break;
+
+		case DeletionType::CommandPool:
+			vkDestroyCommandPool(m_Device, ToHandle<VkCommandPool>(record.handle), nullptr);
+			break;
+
+		case DeletionType::QueryPool:
+			vkDestroyQueryPool(m_Device, ToHandle<VkQueryPool>(record.handle), nullptr);
+			break;
+		}
+	}
+
+}
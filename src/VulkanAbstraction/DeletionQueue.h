@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+#include "VulkanAbstraction/VulkanTypes.h"
+
+
+namespace VulkanEngine {
+
+	enum class DeletionType : uint8_t
+	{
+		Buffer,
+		Image,
+		ImageView,
+		Sampler,
+		Pipeline,
+		PipelineLayout,
+		ShaderModule,
+		ShaderObject,
+		DescriptorPool,
+		CommandPool,
+		QueryPool
+	};
+
+	// Resources released while frames are in flight, destroyed once the GPU has retired every frame that
+	// may still use them. Records are keyed by frame timeline value (VulkanRenderer::GetFrameTimeline): a
+	// release waits for the newest frame begun so far, frame number + 1 on the timeline. Collect runs once
+	// per frame after the fence wait, so streaming and hot reload free memory without a device idle.
+	// Release is safe from any thread. Only for resources the caller owns (VulkanRenderer::CreateUnmanagedBuffer,
+	// CreateUnmanagedImage, Texture and MeshBuffers::RecordUpload, shader modules and objects), not lifetime managed ones. What is released
+	// during shutdown is destroyed by Flush, after the device idle.
+	class DeletionQueue
+	{
+	public:
+		DeletionQueue(VkDevice device, VmaAllocator allocator);
+		virtual ~DeletionQueue() = default;
+		DeletionQueue(const DeletionQueue&)				= delete;
+		DeletionQueue& operator=(const DeletionQueue&)	= delete;
+
+		// Main thread, before anything of the frame is built, numbered like VulkanRenderer::GetFrameNumber
+		void BeginFrame(uint64_t frameNumber);
+
+		void Release(VkBuffer buffer, VmaAllocation allocation);
+		void Release(VkImage image, VmaAllocation allocation);
+		void Release(VkImageView imageView)				{ Push(DeletionType::ImageView, imageView); }
+		void Release(VkSampler sampler)					{ Push(DeletionType::Sampler, sampler); }
+		void Release(VkPipeline pipeline)				{ Push(DeletionType::Pipeline, pipeline); }
+		void Release(VkPipelineLayout pipelineLayout)	{ Push(DeletionType::PipelineLayout, pipelineLayout); }
+		void Release(VkShaderModule shaderModule)		{ Push(DeletionType::ShaderModule, shaderModule); }
+		void Release(VkShaderEXT shader)				{ Push(DeletionType::ShaderObject, shader); }
+		void Release(VkDescriptorPool descriptorPool)	{ Push(DeletionType::DescriptorPool, descriptorPool); }
+		void Release(VkCommandPool commandPool)			{ Push(DeletionType::CommandPool, commandPool); }
+		void Release(VkQueryPool queryPool)				{ Push(DeletionType::QueryPool, queryPool); }
+
+		// Resets the handles, the image view goes too
+		void Release(AllocatedBuffer& buffer);
+		void Release(AllocatedImage& image);
+
+		// Destroys what the timeline has reached
+		void Collect(uint64_t completedValue);
+
+		// Everything, once the device is idle
+		void Flush();
+
+		size_t GetPendingCount() const;
+
+		// What a release now waits for, for owners that defer their own frees alongside
+		uint64_t GetRetireValue() const;
+
+	private:
+		struct Record
+		{
+			uint64_t		retireValue{ 0 };
+			uint64_t		handle{ 0 };
+			VmaAllocation	allocation{ VK_NULL_HANDLE };
+			DeletionType	type{ DeletionType::Buffer };
+		};
+
+		template<typename Handle>
+		void Push(DeletionType type, Handle handle, VmaAllocation allocation = VK_NULL_HANDLE)
+		{
+			if (handle == VK_NULL_HANDLE)
+				return;
+
+			std::lock_guard lock(m_Mutex);
+			m_Records.push_back({ m_RetireValue, reinterpret_cast<uint64_t>(handle), allocation, type });
+		}
+
+		void Destroy(const Record& record) const;
+
+	private:
+		VkDevice			m_Device{ VK_NULL_HANDLE };
+		VmaAllocator		m_Allocator{ VK_NULL_HANDLE };
+
+		mutable std::mutex	m_Mutex;
+		std::deque<Record>	m_Records;		// retire values never decrease
+		uint64_t			m_RetireValue{ 1 };
+	};
+
+}
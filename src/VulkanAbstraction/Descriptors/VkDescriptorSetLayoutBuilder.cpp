@@ -8,13 +8,13 @@
 namespace VulkanEngine {
 
 	VkDescriptorSetLayoutBuilder& VkDescriptorSetLayoutBuilder::AddBinding(
-		uint32_t binding, VkDescriptorType descriptorType, uint32_t descriptorCount)
+		uint32_t binding, VkDescriptorType descriptorType, uint32_t descriptorCount, VkShaderStageFlags stageFlags)
 	{
 		m_Bindings.push_back(VkDescriptorSetLayoutBinding{
 			.binding			= binding,
 			.descriptorType		= descriptorType,
 			.descriptorCount	= descriptorCount,
-			.stageFlags			= VK_SHADER_STAGE_ALL,
+			.stageFlags			= stageFlags,
 			.pImmutableSamplers = nullptr
 			});
 
@@ -40,7 +40,29 @@ namespace VulkanEngine {
 
 		app->GetLifetimeManager()->Push(vkDestroyDescriptorSetLayout, device, descriptorSetLayout, nullptr);
 
+		uint64_t hash = HashUtils::kHashSeed;
+		for (const auto& binding : m_Bindings)
+		{
+			hash = HashUtils::Hash64(&binding.binding,			sizeof(binding.binding),			hash);
+			hash = HashUtils::Hash64(&binding.descriptorType,	sizeof(binding.descriptorType),		hash);
+			hash = HashUtils::Hash64(&binding.descriptorCount,	sizeof(binding.descriptorCount),	hash);
+			hash = HashUtils::Hash64(&binding.stageFlags,		sizeof(binding.stageFlags),			hash);
+		}
+
+		{
+			std::lock_guard lock(s_Mutex);
+			s_BindingsHashes[descriptorSetLayout] = hash;
+		}
+
 		return descriptorSetLayout;
 	}
 
+	uint64_t VkDescriptorSetLayoutBuilder::GetBindingsHash(VkDescriptorSetLayout layout)
+	{
+		std::lock_guard lock(s_Mutex);
+
+		auto it = s_BindingsHashes.find(layout);
+		return it != s_BindingsHashes.end() ? it->second : 0;
+	}
+
 }
\ No newline at end of file
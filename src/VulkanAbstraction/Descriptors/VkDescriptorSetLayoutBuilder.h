@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <vulkan/vulkan.h>
 
@@ -13,11 +15,19 @@ namespace VulkanEngine {
 		VkDescriptorSetLayoutBuilder()			= default;
 		virtual ~VkDescriptorSetLayoutBuilder() = default;
 
-		VkDescriptorSetLayoutBuilder& AddBinding(uint32_t binding, VkDescriptorType descriptorType, uint32_t descriptorCount);
+		VkDescriptorSetLayoutBuilder& AddBinding(uint32_t binding, VkDescriptorType descriptorType, uint32_t descriptorCount,
+			VkShaderStageFlags stageFlags = VK_SHADER_STAGE_ALL);
 		VkDescriptorSetLayout Build();
 
+		// Hash of the bindings a layout was built from (binding, type, count, stages), stable across runs.
+		// 0 for layouts this builder didn't create
+		static uint64_t GetBindingsHash(VkDescriptorSetLayout layout);
+
 	private:
 		std::vector<VkDescriptorSetLayoutBinding> m_Bindings;
+
+		static inline std::mutex										s_Mutex;
+		static inline std::unordered_map<VkDescriptorSetLayout, uint64_t>	s_BindingsHashes;
 	};
 
 }
\ No newline at end of file
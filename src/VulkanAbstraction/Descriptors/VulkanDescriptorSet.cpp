@@ -30,4 +30,26 @@ namespace VulkanEngine {
 		auto* ctx = VulkanContext::GetRaw();
 		vkUpdateDescriptorSets(*ctx->GetDevice(), 1, &imageWrite, 0, nullptr);
 	}
+
+	void VulkanDescriptorSet::WriteSampledImage(VkImageView imageView, VkSampler sampler, VkImageLayout imageLayout, uint32_t dstBinding)
+	{
+		VkDescriptorImageInfo imageInfo{
+			.sampler		= sampler,
+			.imageView		= imageView,
+			.imageLayout	= imageLayout
+		};
+
+		VkWriteDescriptorSet imageWrite{
+			.sType				= VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			.pNext				= nullptr,
+			.dstSet				= m_Set,
+			.dstBinding			= dstBinding,
+			.descriptorCount	= 1,
+			.descriptorType		= VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+			.pImageInfo			= &imageInfo
+		};
+
+		auto* ctx = VulkanContext::GetRaw();
+		vkUpdateDescriptorSets(*ctx->GetDevice(), 1, &imageWrite, 0, nullptr);
+	}
 }
\ No newline at end of file
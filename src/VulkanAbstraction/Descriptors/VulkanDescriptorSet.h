@@ -12,6 +12,7 @@ namespace VulkanEngine {
 		virtual ~VulkanDescriptorSet() = default;
 
 		void WriteImage(VkImageView imageView, VkImageLayout imageLayout, uint32_t dstBinding);
+		void WriteSampledImage(VkImageView imageView, VkSampler sampler, VkImageLayout imageLayout, uint32_t dstBinding);
 
 		VkDescriptorSet GetRaw() { return m_Set; }
 
@@ -0,0 +1,476 @@
+#include "VulkanAbstraction/Geometry/GltfImporter.h"
+#include "VulkanAbstraction/Geometry/MeshCache.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+#define CGLTF_IMPLEMENTATION
+#include <cgltf.h>
+#include <meshoptimizer.h>
+
+
+namespace VulkanEngine {
+
+	// Post-transform cache size the analysis assumes, meshoptimizer's own optimization is cache size agnostic
+	static constexpr unsigned kAnalysisCacheSize = 16;
+
+	struct OptimizationStats
+	{
+		double transformedBefore{ 0.0 }; // ACMR * triangles
+		double transformedAfter{ 0.0 };
+		double triangles{ 0.0 };
+		double coarsestTriangles{ 0.0 };
+	};
+
+	// A LOD that keeps more than this fraction of the previous one's indices isn't worth storing
+	static constexpr float kMinLodReduction = 0.9f;
+
+	static uint64_t HashFileStamp(const std::filesystem::path& path, uint64_t seed)
+	{
+		std::error_code ec;
+		uint64_t size = std::filesystem::file_size(path, ec);
+		int64_t time = ec ? 0 : std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+
+		uint64_t hash = HashUtils::Hash64(path.generic_string(), seed);
+		hash = HashUtils::Hash64(&size, sizeof(size), hash);
+		return HashUtils::Hash64(&time, sizeof(time), hash);
+	}
+
+	static glm::vec2 EncodeOctahedral(glm::vec3 n)
+	{
+		n /= std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+
+		glm::vec2 e(n.x, n.y);
+		if (n.z < 0.0f)
+		{
+			e = glm::vec2(
+				(1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+				(1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+		}
+
+		return e;
+	}
+
+	bool GltfImporter::Import(const std::filesystem::path& gltfPath, const MeshImportOptions& options, MeshData& meshData)
+	{
+		uint64_t key = GetCacheKey(gltfPath, options);
+
+		if (MeshCache::Load(key, meshData))
+		{
+			VulkanEngine_DEBUG(fmt::runtime("Loading cached mesh: {}"), gltfPath.string());
+			return true;
+		}
+
+		meshData = {};
+		if (!Load(gltfPath, options, meshData))
+			return false;
+
+		MeshCache::Store(key, meshData);
+		return true;
+	}
+
+	uint64_t GltfImporter::GetCacheKey(const std::filesystem::path& gltfPath, const MeshImportOptions& options)
+	{
+		uint64_t hash = HashUtils::Hash64(&kMeshCacheVersion, sizeof(kMeshCacheVersion), options.GetHash());
+		hash = HashFileStamp(std::filesystem::absolute(gltfPath).lexically_normal(), hash);
+
+		// .bin files can change without touching the .gltf
+		cgltf_options gltfOptions = {};
+		cgltf_data* data = nullptr;
+		if (cgltf_parse_file(&gltfOptions, gltfPath.string().c_str(), &data) == cgltf_result_success)
+		{
+			for (cgltf_size i = 0; i < data->buffers_count; ++i)
+			{
+				const char* uri = data->buffers[i].uri;
+				if (uri && std::strncmp(uri, "data:", 5) != 0)
+					hash = HashFileStamp(std::filesystem::absolute(gltfPath.parent_path() / uri).lexically_normal(), hash);
+			}
+
+			cgltf_free(data);
+		}
+
+		return hash;
+	}
+
+	bool GltfImporter::Load(const std::filesystem::path& gltfPath, const MeshImportOptions& options, MeshData& meshData)
+	{
+		cgltf_options gltfOptions = {};
+		cgltf_data* data = nullptr;
+
+		std::string path = gltfPath.string();
+		cgltf_result result = cgltf_parse_file(&gltfOptions, path.c_str(), &data);
+
+		if (result == cgltf_result_success)
+			result = cgltf_load_buffers(&gltfOptions, data, path.c_str());
+
+		if (result == cgltf_result_success)
+			result = cgltf_validate(data);
+
+		if (result != cgltf_result_success)
+		{
+			VulkanEngine_ERROR(fmt::runtime("Failed to load glTF {} (cgltf error {})"), path, static_cast<int>(result));
+			cgltf_free(data);
+			return false;
+		}
+
+		meshData.quantized		= options.quantize;
+		meshData.vertexStride	= options.quantize ? sizeof(QuantizedVertex) : sizeof(Vertex);
+
+		OptimizationStats stats;
+
+		// glTF mesh -> its submeshes, only triangle primitives are kept
+		std::vector<std::vector<uint32_t>> meshSubmeshes(data->meshes_count);
+
+		for (cgltf_size meshIndex = 0; meshIndex < data->meshes_count; ++meshIndex)
+		{
+			const cgltf_mesh& mesh = data->meshes[meshIndex];
+
+			for (cgltf_size primitiveIndex = 0; primitiveIndex < mesh.primitives_count; ++primitiveIndex)
+			{
+				const cgltf_primitive& primitive = mesh.primitives[primitiveIndex];
+				if (primitive.type != cgltf_primitive_type_triangles)
+					continue;
+
+				const cgltf_accessor* positions = nullptr;
+				const cgltf_accessor* normals	= nullptr;
+				const cgltf_accessor* uvs		= nullptr;
+
+				for (cgltf_size i = 0; i < primitive.attributes_count; ++i)
+				{
+					const cgltf_attribute& attribute = primitive.attributes[i];
+
+					if (attribute.type == cgltf_attribute_type_position)
+						positions = attribute.data;
+					else if (attribute.type == cgltf_attribute_type_normal)
+						normals = attribute.data;
+					else if (attribute.type == cgltf_attribute_type_texcoord && attribute.index == 0)
+						uvs = attribute.data;
+				}
+
+				if (!positions || positions->count == 0)
+					continue;
+
+				std::vector<Vertex> vertices(positions->count);
+				std::vector<float> scratch;
+
+				auto unpack = [&scratch](const cgltf_accessor* accessor, size_t components)
+					{
+						scratch.resize(accessor->count * components);
+						cgltf_accessor_unpack_floats(accessor, scratch.data(), scratch.size());
+					};
+
+				unpack(positions, 3);
+				for (size_t i = 0; i < vertices.size(); ++i)
+					vertices[i].position = glm::vec3(scratch[i * 3 + 0], scratch[i * 3 + 1], scratch[i * 3 + 2]);
+
+				if (normals)
+				{
+					unpack(normals, 3);
+					for (size_t i = 0; i < vertices.size(); ++i)
+						vertices[i].normal = glm::vec3(scratch[i * 3 + 0], scratch[i * 3 + 1], scratch[i * 3 + 2]);
+				}
+
+				if (uvs)
+				{
+					unpack(uvs, 2);
+					for (size_t i = 0; i < vertices.size(); ++i)
+					{
+						vertices[i].uvX = scratch[i * 2 + 0];
+						vertices[i].uvY = scratch[i * 2 + 1];
+					}
+				}
+
+				std::vector<uint32_t> indices;
+				if (primitive.indices)
+				{
+					indices.resize(primitive.indices->count);
+					for (size_t i = 0; i < indices.size(); ++i)
+						indices[i] = static_cast<uint32_t>(cgltf_accessor_read_index(primitive.indices, i));
+				}
+				else
+				{
+					indices.resize(vertices.size());
+					for (size_t i = 0; i < indices.size(); ++i)
+						indices[i] = static_cast<uint32_t>(i);
+				}
+
+				indices.resize(indices.size() - indices.size() % 3);
+				if (indices.empty())
+					continue;
+
+				// Smooth normals from the faces when the file has none
+				if (!normals)
+				{
+					for (auto& vertex : vertices)
+						vertex.normal = glm::vec3(0.0f);
+
+					for (size_t i = 0; i < indices.size(); i += 3)
+					{
+						Vertex& a = vertices[indices[i + 0]];
+						Vertex& b = vertices[indices[i + 1]];
+						Vertex& c = vertices[indices[i + 2]];
+
+						glm::vec3 faceNormal = glm::cross(b.position - a.position, c.position - a.position);
+						a.normal += faceNormal;
+						b.normal += faceNormal;
+						c.normal += faceNormal;
+					}
+
+					for (auto& vertex : vertices)
+					{
+						float length = glm::length(vertex.normal);
+						vertex.normal = length > 0.0f ? vertex.normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+					}
+				}
+
+				double triangles = static_cast<double>(indices.size() / 3);
+				stats.triangles			+= triangles;
+				stats.transformedBefore	+= triangles * meshopt_analyzeVertexCache(indices.data(), indices.size(), vertices.size(), kAnalysisCacheSize, 0, 0).acmr;
+
+				Optimize(vertices, indices, options);
+
+				stats.transformedAfter	+= triangles * meshopt_analyzeVertexCache(indices.data(), indices.size(), vertices.size(), kAnalysisCacheSize, 0, 0).acmr;
+
+				auto lods = GenerateLods(vertices, std::move(indices), options);
+				stats.coarsestTriangles += static_cast<double>(lods.back().indices.size() / 3);
+
+				meshSubmeshes[meshIndex].push_back(static_cast<uint32_t>(meshData.submeshes.size()));
+				Append(vertices, lods, options, meshData);
+			}
+		}
+
+		// Nodes of the default scene, every primitive of a node's mesh becomes one MeshNode
+		const cgltf_scene* scene = data->scene ? data->scene : (data->scenes_count > 0 ? &data->scenes[0] : nullptr);
+
+		std::function<void(const cgltf_node*)> addNode = [&](const cgltf_node* node)
+			{
+				if (node->mesh)
+				{
+					MeshNode meshNode;
+					cgltf_node_transform_world(node, &meshNode.transform[0][0]);
+
+					for (uint32_t submesh : meshSubmeshes[node->mesh - data->meshes])
+					{
+						meshNode.submesh = submesh;
+						meshData.nodes.push_back(meshNode);
+					}
+				}
+
+				for (cgltf_size i = 0; i < node->children_count; ++i)
+					addNode(node->children[i]);
+			};
+
+		if (scene)
+		{
+			for (cgltf_size i = 0; i < scene->nodes_count; ++i)
+				addNode(scene->nodes[i]);
+		}
+
+		cgltf_free(data);
+
+		if (meshData.submeshes.empty())
+		{
+			VulkanEngine_ERROR(fmt::runtime("glTF {} has no triangle meshes"), path);
+			return false;
+		}
+
+		VulkanEngine_INFO(fmt::runtime("Imported {}: {} submeshes, {} nodes, {} vertices, {} -> {} triangles (LOD 0 -> coarsest), {} meshlets, ACMR {:.3f} -> {:.3f}{}"),
+			path, meshData.submeshes.size(), meshData.nodes.size(), meshData.GetVertexCount(), stats.triangles, stats.coarsestTriangles,
+			meshData.meshlets.size(), stats.transformedBefore / stats.triangles, stats.transformedAfter / stats.triangles, meshData.quantized ? ", quantized" : "");
+
+		return true;
+	}
+
+	void GltfImporter::Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const MeshImportOptions& options)
+	{
+		// Weld identical vertices, glTF exporters often duplicate them per face
+		std::vector<uint32_t> remap(vertices.size());
+		size_t uniqueCount = meshopt_generateVertexRemap(remap.data(), indices.data(), indices.size(),
+			vertices.data(), vertices.size(), sizeof(Vertex));
+
+		meshopt_remapIndexBuffer(indices.data(), indices.data(), indices.size(), remap.data());
+		meshopt_remapVertexBuffer(vertices.data(), vertices.data(), vertices.size(), sizeof(Vertex), remap.data());
+		vertices.resize(uniqueCount);
+
+		// Cache first, overdraw may trade a little of it, fetch order last since it renumbers vertices
+		meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+		meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(),
+			&vertices[0].position.x, vertices.size(), sizeof(Vertex), options.overdrawThreshold);
+		meshopt_optimizeVertexFetch(vertices.data(), indices.data(), indices.size(),
+			vertices.data(), vertices.size(), sizeof(Vertex));
+	}
+
+	std::vector<GltfImporter::LodIndices> GltfImporter::GenerateLods(const std::vector<Vertex>& vertices, std::vector<uint32_t> indices,
+		const MeshImportOptions& options)
+	{
+		// Simplifier errors are relative to the mesh extent
+		float errorScale = meshopt_simplifyScale(&vertices[0].position.x, vertices.size(), sizeof(Vertex));
+
+		uint32_t maxLods = std::clamp(options.maxLods, 1u, kMaxMeshLods);
+
+		// Reserved, fullDetail must stay valid while LODs are appended
+		std::vector<LodIndices> lods;
+		lods.reserve(maxLods);
+		lods.push_back({ .indices = std::move(indices), .error = 0.0f });
+
+		const std::vector<uint32_t>& fullDetail = lods.front().indices;
+
+		while (lods.size() < maxLods)
+		{
+			size_t previousCount	= lods.back().indices.size();
+			size_t targetCount		= static_cast<size_t>(previousCount * options.lodRatio) / 3 * 3;
+			if (targetCount < 3)
+				break;
+
+			// Always from full detail so every error is measured against the same surface.
+			// Borders stay locked, neighbouring primitives share them and would crack apart otherwise.
+			std::vector<uint32_t> lodIndices(fullDetail.size());
+			float error = 0.0f;
+
+			size_t count = meshopt_simplify(lodIndices.data(), fullDetail.data(), fullDetail.size(),
+				&vertices[0].position.x, vertices.size(), sizeof(Vertex), targetCount, options.maxLodError,
+				meshopt_SimplifyLockBorder, &error);
+
+			if (count == 0 || count > previousCount * kMinLodReduction)
+				break;
+
+			lodIndices.resize(count);
+			meshopt_optimizeVertexCache(lodIndices.data(), lodIndices.data(), count, vertices.size());
+
+			// Errors only grow along the chain, selection relies on it
+			lods.push_back({ .indices = std::move(lodIndices), .error = std::max(error * errorScale, lods.back().error) });
+		}
+
+		return lods;
+	}
+
+	void GltfImporter::Append(const std::vector<Vertex>& vertices, const std::vector<LodIndices>& lods,
+		const MeshImportOptions& options, MeshData& meshData)
+	{
+		Submesh submesh{
+			.vertexOffset	= static_cast<int32_t>(meshData.GetVertexCount()),
+			.vertexCount	= static_cast<uint32_t>(vertices.size()),
+			.boundingSphere = ComputeBoundingSphere(vertices),
+			.lodCount		= static_cast<uint32_t>(lods.size())
+		};
+
+		for (size_t i = 0; i < lods.size(); ++i)
+		{
+			submesh.lods[i] = {
+				.firstIndex = static_cast<uint32_t>(meshData.indices.size()),
+				.indexCount = static_cast<uint32_t>(lods[i].indices.size()),
+				.error		= lods[i].error
+			};
+
+			meshData.indices.insert(meshData.indices.end(), lods[i].indices.begin(), lods[i].indices.end());
+		}
+
+		if (options.buildMeshlets)
+			BuildMeshlets(vertices, lods.front().indices, options, meshData, submesh);
+
+		meshData.submeshes.push_back(submesh);
+
+		size_t offset = meshData.vertices.size();
+		meshData.vertices.resize(offset + vertices.size() * meshData.vertexStride);
+
+		if (meshData.quantized)
+		{
+			auto* destination = reinterpret_cast<QuantizedVertex*>(meshData.vertices.data() + offset);
+			for (size_t i = 0; i < vertices.size(); ++i)
+				destination[i] = Quantize(vertices[i]);
+		}
+		else
+		{
+			std::memcpy(meshData.vertices.data() + offset, vertices.data(), vertices.size() * sizeof(Vertex));
+		}
+	}
+
+	void GltfImporter::BuildMeshlets(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+		const MeshImportOptions& options, MeshData& meshData, Submesh& submesh)
+	{
+		size_t maxMeshlets = meshopt_buildMeshletsBound(indices.size(), kMeshletMaxVertices, kMeshletMaxTriangles);
+
+		std::vector<meshopt_Meshlet>	meshlets(maxMeshlets);
+		std::vector<uint32_t>			meshletVertices(maxMeshlets * kMeshletMaxVertices);
+		std::vector<uint8_t>			meshletTriangles(maxMeshlets * kMeshletMaxTriangles * 3);
+
+		size_t meshletCount = meshopt_buildMeshlets(meshlets.data(), meshletVertices.data(), meshletTriangles.data(),
+			indices.data(), indices.size(), &vertices[0].position.x, vertices.size(), sizeof(Vertex),
+			kMeshletMaxVertices, kMeshletMaxTriangles, options.meshletConeWeight);
+
+		submesh.firstMeshlet = static_cast<uint32_t>(meshData.meshlets.size());
+		submesh.meshletCount = static_cast<uint32_t>(meshletCount);
+
+		for (size_t i = 0; i < meshletCount; ++i)
+		{
+			const meshopt_Meshlet& meshlet = meshlets[i];
+
+			uint32_t*	localVertices	= &meshletVertices[meshlet.vertex_offset];
+			uint8_t*	localTriangles	= &meshletTriangles[meshlet.triangle_offset];
+
+			// Vertex order within the meshlet follows the triangles, better locality for the mesh shader's fetches
+			meshopt_optimizeMeshlet(localVertices, localTriangles, meshlet.triangle_count, meshlet.vertex_count);
+
+			meshopt_Bounds bounds = meshopt_computeMeshletBounds(localVertices, localTriangles, meshlet.triangle_count,
+				&vertices[0].position.x, vertices.size(), sizeof(Vertex));
+
+			meshData.meshlets.push_back({
+				.boundingSphere = glm::vec4(bounds.center[0], bounds.center[1], bounds.center[2], bounds.radius),
+				.coneApex		= glm::vec3(bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]),
+				.coneCutoff		= bounds.cone_cutoff,
+				.coneAxis		= glm::vec3(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]),
+				.vertexOffset	= static_cast<uint32_t>(meshData.meshletVertices.size()),
+				.triangleOffset = static_cast<uint32_t>(meshData.meshletTriangles.size()),
+				.vertexCount	= meshlet.vertex_count,
+				.triangleCount	= meshlet.triangle_count
+			});
+
+			meshData.meshletVertices.insert(meshData.meshletVertices.end(), localVertices, localVertices + meshlet.vertex_count);
+
+			// One word per triangle, the mesh shader reads it with a single load
+			for (uint32_t triangle = 0; triangle < meshlet.triangle_count; ++triangle)
+			{
+				const uint8_t* corners = &localTriangles[triangle * 3];
+				meshData.meshletTriangles.push_back(uint32_t(corners[0]) | uint32_t(corners[1]) << 8 | uint32_t(corners[2]) << 16);
+			}
+		}
+	}
+
+	QuantizedVertex GltfImporter::Quantize(const Vertex& vertex)
+	{
+		glm::vec2 octahedral = EncodeOctahedral(vertex.normal);
+
+		return {
+			.position	= {
+				meshopt_quantizeHalf(vertex.position.x),
+				meshopt_quantizeHalf(vertex.position.y),
+				meshopt_quantizeHalf(vertex.position.z) },
+			.normal		= {
+				static_cast<int8_t>(meshopt_quantizeSnorm(octahedral.x, 8)),
+				static_cast<int8_t>(meshopt_quantizeSnorm(octahedral.y, 8)) },
+			.uv			= {
+				meshopt_quantizeHalf(vertex.uvX),
+				meshopt_quantizeHalf(vertex.uvY) }
+		};
+	}
+
+	glm::vec4 GltfImporter::ComputeBoundingSphere(const std::vector<Vertex>& vertices)
+	{
+		glm::vec3 min(std::numeric_limits<float>::max());
+		glm::vec3 max(std::numeric_limits<float>::lowest());
+
+		for (const auto& vertex : vertices)
+		{
+			min = glm::min(min, vertex.position);
+			max = glm::max(max, vertex.position);
+		}
+
+		glm::vec3 center = (min + max) * 0.5f;
+
+		float radius = 0.0f;
+		for (const auto& vertex : vertices)
+			radius = std::max(radius, glm::length(vertex.position - center));
+
+		return glm::vec4(center, radius);
+	}
+
+}
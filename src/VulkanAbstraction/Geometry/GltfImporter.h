@@ -0,0 +1,54 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "VulkanAbstraction/Geometry/MeshData.h"
+
+
+namespace VulkanEngine {
+
+	// glTF 2.0 (.gltf + .bin or .glb) triangle meshes.
+	// Every primitive is welded and reordered with meshoptimizer for the post-transform vertex cache,
+	// overdraw and vertex fetch, gets a chain of simplified LODs and meshlets with culling bounds,
+	// then is optionally quantized.
+	// Results go through the MeshCache, later imports of an unchanged file read the optimized data
+	// back directly.
+	class GltfImporter
+	{
+	public:
+		GltfImporter()	= delete;
+		~GltfImporter()	= delete;
+
+		static bool Import(const std::filesystem::path& gltfPath, const MeshImportOptions& options, MeshData& meshData);
+
+	private:
+		// Source file and the external buffers it references, by size and write time
+		static uint64_t GetCacheKey(const std::filesystem::path& gltfPath, const MeshImportOptions& options);
+
+		static bool Load(const std::filesystem::path& gltfPath, const MeshImportOptions& options, MeshData& meshData);
+
+		struct LodIndices
+		{
+			std::vector<uint32_t>	indices;
+			float					error{ 0.0f }; // mesh space
+		};
+
+		static void Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const MeshImportOptions& options);
+
+		// Simplified from the optimized full detail indices, LOD 0 first
+		static std::vector<LodIndices> GenerateLods(const std::vector<Vertex>& vertices, std::vector<uint32_t> indices,
+			const MeshImportOptions& options);
+
+		static void Append(const std::vector<Vertex>& vertices, const std::vector<LodIndices>& lods,
+			const MeshImportOptions& options, MeshData& meshData);
+
+		// Full detail only, appended to the meshlet arrays of meshData
+		static void BuildMeshlets(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+			const MeshImportOptions& options, MeshData& meshData, Submesh& submesh);
+
+		static QuantizedVertex	Quantize(const Vertex& vertex);
+		static glm::vec4		ComputeBoundingSphere(const std::vector<Vertex>& vertices);
+	};
+
+}
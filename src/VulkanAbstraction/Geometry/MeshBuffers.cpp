@@ -0,0 +1,133 @@
+#include "VulkanAbstraction/Geometry/MeshData.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "Core/Application.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	MeshBuffers MeshBuffers::Upload(const MeshData& meshData)
+	{
+		if (meshData.vertices.empty() || meshData.indices.empty())
+		{
+			VulkanEngine_ERROR("Uploading empty mesh data");
+			return {};
+		}
+
+		// Staging only lives for the copy
+		AllocatedBuffer staging = VulkanRenderer::CreateStagingBuffer(GetStagingSize(meshData));
+		WriteStaging(meshData, staging.mapped);
+		vmaFlushAllocation(VulkanRenderer::GetAllocator().GetRaw(), staging.allocation, 0, VK_WHOLE_SIZE);
+
+		MeshBuffers buffers;
+		VulkanRenderer::ImmediateSubmit([&](VkCommandBuffer cmd)
+			{
+				buffers = RecordUpload(cmd, meshData, staging);
+			});
+
+		VulkanRenderer::DestroyStagingBuffer(staging);
+
+		// Lifetime management
+		auto* app = Application::GetRaw();
+		for (const auto& region : GetRegions(meshData))
+		{
+			const AllocatedBuffer& buffer = buffers.*region.buffer;
+			app->GetLifetimeManager()->Push(vmaDestroyBuffer, VulkanRenderer::GetAllocator().GetRaw(), buffer.buffer, buffer.allocation);
+		}
+
+		return buffers;
+	}
+
+	VkDeviceSize MeshBuffers::GetStagingSize(const MeshData& meshData)
+	{
+		VkDeviceSize size = 0;
+		for (const auto& region : GetRegions(meshData))
+			size += region.size;
+
+		return size;
+	}
+
+	void MeshBuffers::WriteStaging(const MeshData& meshData, void* staging)
+	{
+		auto* mapped = static_cast<std::byte*>(staging);
+		for (const auto& region : GetRegions(meshData))
+			std::memcpy(mapped + region.stagingOffset, region.data, region.size);
+	}
+
+	MeshBuffers MeshBuffers::RecordUpload(VkCommandBuffer cmd, const MeshData& meshData, const AllocatedBuffer& staging)
+	{
+		MeshBuffers buffers;
+		std::vector<Region> regions = GetRegions(meshData);
+
+		for (const auto& region : regions)
+		{
+			AllocatedBuffer& buffer = buffers.*region.buffer;
+			buffer = VulkanRenderer::CreateUnmanagedBuffer(region.size, region.usage);
+
+			VkBufferCopy copy{ .srcOffset = region.stagingOffset, .dstOffset = 0, .size = region.size };
+			vkCmdCopyBuffer(cmd, staging.buffer, buffer.buffer, 1, &copy);
+
+			buffer.bufferState = { VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT };
+
+			// Read-only from here on, draws never need another barrier
+			VulkanUtils::InsertBufferMemoryBarrier(cmd, buffer.buffer, buffer.bufferState, region.readStages, region.readAccess);
+		}
+
+		VulkanEngine_DEBUG(fmt::runtime("Uploaded mesh data: {} vertices ({} KB), {} indices ({} KB), {} meshlets"),
+			meshData.GetVertexCount(), meshData.vertices.size() / 1024, meshData.indices.size(), meshData.indices.size() * sizeof(uint32_t) / 1024,
+			buffers.HasMeshlets() ? meshData.meshlets.size() : 0);
+
+		return buffers;
+	}
+
+	void MeshBuffers::Release()
+	{
+		DeletionQueue& deletionQueue = VulkanRenderer::GetDeletionQueue();
+
+		deletionQueue.Release(vertexBuffer);
+		deletionQueue.Release(indexBuffer);
+		deletionQueue.Release(meshletBuffer);
+		deletionQueue.Release(meshletVertexBuffer);
+		deletionQueue.Release(meshletTriangleBuffer);
+	}
+
+	std::vector<MeshBuffers::Region> MeshBuffers::GetRegions(const MeshData& meshData)
+	{
+		VkBufferUsageFlags storageUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+		VkPipelineStageFlags2 meshletStages = VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT;
+		VkPipelineStageFlags2 vertexStages	= VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT;
+
+		bool meshlets = !meshData.meshlets.empty() && VulkanRenderer::IsMeshShadingSupported();
+		if (meshlets)
+			vertexStages |= meshletStages;
+
+		std::vector<Region> regions;
+		regions.push_back({ &MeshBuffers::vertexBuffer, storageUsage, meshData.vertices.data(), meshData.vertices.size(),
+			vertexStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT });
+		regions.push_back({ &MeshBuffers::indexBuffer, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			meshData.indices.data(), meshData.indices.size() * sizeof(uint32_t), VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT });
+
+		// Without mesh shader support nothing could read them
+		if (meshlets)
+		{
+			regions.push_back({ &MeshBuffers::meshletBuffer, storageUsage, meshData.meshlets.data(), meshData.meshlets.size() * sizeof(Meshlet),
+				meshletStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT });
+			regions.push_back({ &MeshBuffers::meshletVertexBuffer, storageUsage, meshData.meshletVertices.data(),
+				meshData.meshletVertices.size() * sizeof(uint32_t), meshletStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT });
+			regions.push_back({ &MeshBuffers::meshletTriangleBuffer, storageUsage, meshData.meshletTriangles.data(),
+				meshData.meshletTriangles.size() * sizeof(uint32_t), meshletStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT });
+		}
+
+		VkDeviceSize stagingOffset = 0;
+		for (auto& region : regions)
+		{
+			region.stagingOffset = stagingOffset;
+			stagingOffset += region.size;
+		}
+
+		return regions;
+	}
+
+}
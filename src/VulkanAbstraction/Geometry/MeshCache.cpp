@@ -0,0 +1,140 @@
+#include "VulkanAbstraction/Geometry/MeshCache.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	std::filesystem::path MeshCache::GetCacheDir()
+	{
+		return std::filesystem::current_path() / "Cache" / "Meshes";
+	}
+
+	std::filesystem::path MeshCache::GetBinaryPath(uint64_t key)
+	{
+		return GetCacheDir() / (HashUtils::ToHex(key) + ".mesh");
+	}
+
+	bool MeshCache::Load(uint64_t key, MeshData& meshData)
+	{
+		FilesystemUtils::MappedFile cacheFile;
+		if (!cacheFile.Open(GetBinaryPath(key)))
+			return false;
+
+		if (!Read({ cacheFile.GetData(), cacheFile.GetSize() }, meshData))
+		{
+			VulkanEngine_WARN(fmt::runtime("Corrupted or outdated mesh cache file: {}"), GetBinaryPath(key).string());
+			return false;
+		}
+
+		return true;
+	}
+
+	void MeshCache::Store(uint64_t key, const MeshData& meshData)
+	{
+		std::lock_guard lock(s_Mutex);
+
+		std::filesystem::create_directories(GetCacheDir());
+
+		// Write to a temp file first so a crash never leaves a truncated mesh behind
+		auto binaryPath = GetBinaryPath(key);
+		auto tempPath = binaryPath;
+		tempPath += ".tmp";
+
+		bool written = false;
+		{
+			std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+			if (cacheFile.is_open())
+				written = Write(cacheFile, meshData);
+		}
+
+		// Closed by now, a failed write leaves no temporary behind
+		std::error_code ec;
+		if (!written)
+		{
+			VulkanEngine_WARN(fmt::runtime("Failed to write mesh cache: {}"), binaryPath.string());
+			std::filesystem::remove(tempPath, ec);
+			return;
+		}
+
+		std::filesystem::rename(tempPath, binaryPath, ec);
+		if (ec)
+		{
+			VulkanEngine_WARN(fmt::runtime("Failed to finalize mesh cache {}: {}"), binaryPath.string(), ec.message());
+			std::filesystem::remove(tempPath, ec);
+		}
+	}
+
+	bool MeshCache::Read(std::span<const uint8_t> data, MeshData& meshData)
+	{
+		if (data.size() < sizeof(MeshCacheHeader))
+			return false;
+
+		const auto* header = reinterpret_cast<const MeshCacheHeader*>(data.data());
+		if (header->magic != kMeshCacheMagic || header->version != kMeshCacheVersion || header->vertexStride == 0)
+			return false;
+
+		uint64_t submeshBytes			= uint64_t(header->submeshCount) * sizeof(Submesh);
+		uint64_t nodeBytes				= uint64_t(header->nodeCount) * sizeof(MeshNode);
+		uint64_t indexBytes				= header->indexCount * sizeof(uint32_t);
+		uint64_t meshletBytes			= uint64_t(header->meshletCount) * sizeof(Meshlet);
+		uint64_t meshletVertexBytes		= uint64_t(header->meshletVertexCount) * sizeof(uint32_t);
+		uint64_t meshletTriangleBytes	= uint64_t(header->meshletTriangleCount) * sizeof(uint32_t);
+
+		uint64_t expectedSize = sizeof(MeshCacheHeader) + submeshBytes + nodeBytes + header->vertexBytes + indexBytes +
+			meshletBytes + meshletVertexBytes + meshletTriangleBytes;
+
+		if (expectedSize != data.size())
+			return false;
+
+		const uint8_t* cursor = data.data() + sizeof(MeshCacheHeader);
+		auto read = [&cursor](auto& destination, uint64_t bytes)
+			{
+				destination.resize(bytes / sizeof(destination[0]));
+				std::memcpy(destination.data(), cursor, bytes);
+				cursor += bytes;
+			};
+
+		meshData.quantized		= header->quantized != 0;
+		meshData.vertexStride	= header->vertexStride;
+
+		read(meshData.submeshes, submeshBytes);
+		read(meshData.nodes, nodeBytes);
+		read(meshData.vertices, header->vertexBytes);
+		read(meshData.indices, indexBytes);
+		read(meshData.meshlets, meshletBytes);
+		read(meshData.meshletVertices, meshletVertexBytes);
+		read(meshData.meshletTriangles, meshletTriangleBytes);
+
+		return true;
+	}
+
+	bool MeshCache::Write(std::ostream& stream, const MeshData& meshData)
+	{
+		MeshCacheHeader header{
+			.magic					= kMeshCacheMagic,
+			.version				= kMeshCacheVersion,
+			.quantized				= meshData.quantized ? 1u : 0u,
+			.vertexStride			= meshData.vertexStride,
+			.vertexBytes			= meshData.vertices.size(),
+			.indexCount				= meshData.indices.size(),
+			.submeshCount			= static_cast<uint32_t>(meshData.submeshes.size()),
+			.nodeCount				= static_cast<uint32_t>(meshData.nodes.size()),
+			.meshletCount			= static_cast<uint32_t>(meshData.meshlets.size()),
+			.meshletVertexCount		= static_cast<uint32_t>(meshData.meshletVertices.size()),
+			.meshletTriangleCount	= static_cast<uint32_t>(meshData.meshletTriangles.size())
+		};
+
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(reinterpret_cast<const char*>(meshData.submeshes.data()), meshData.submeshes.size() * sizeof(Submesh));
+		stream.write(reinterpret_cast<const char*>(meshData.nodes.data()), meshData.nodes.size() * sizeof(MeshNode));
+		stream.write(reinterpret_cast<const char*>(meshData.vertices.data()), meshData.vertices.size());
+		stream.write(reinterpret_cast<const char*>(meshData.indices.data()), meshData.indices.size() * sizeof(uint32_t));
+		stream.write(reinterpret_cast<const char*>(meshData.meshlets.data()), meshData.meshlets.size() * sizeof(Meshlet));
+		stream.write(reinterpret_cast<const char*>(meshData.meshletVertices.data()), meshData.meshletVertices.size() * sizeof(uint32_t));
+		stream.write(reinterpret_cast<const char*>(meshData.meshletTriangles.data()), meshData.meshletTriangles.size() * sizeof(uint32_t));
+
+		return stream.good();
+	}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <ostream>
+#include <span>
+
+#include "VulkanAbstraction/Geometry/MeshData.h"
+
+
+namespace VulkanEngine {
+
+	// On-disk layout, little endian:
+	//   MeshCacheHeader
+	//   Submesh[submeshCount]
+	//   MeshNode[nodeCount]
+	//   vertex bytes, index uint32s
+	//   Meshlet[meshletCount], meshlet vertex uint32s, meshlet triangle uint32s
+	struct MeshCacheHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t quantized;
+		uint32_t vertexStride;
+		uint64_t vertexBytes;
+		uint64_t indexCount;
+		uint32_t submeshCount;
+		uint32_t nodeCount;
+		uint32_t meshletCount;
+		uint32_t meshletVertexCount;
+		uint32_t meshletTriangleCount;
+		uint32_t padding;
+	};
+
+	static constexpr uint32_t kMeshCacheMagic	= 0x4853454d; // "MESH"
+	static constexpr uint32_t kMeshCacheVersion	= 3;
+
+	// Imported and optimized meshes, stored as <key>.mesh and read back with a single file read.
+	// The key hashes the source file and its options (MeshImportOptions), so a changed source or
+	// different options never match a stale entry.
+	class MeshCache
+	{
+	public:
+		MeshCache()		= delete;
+		~MeshCache()	= delete;
+
+		static std::filesystem::path GetCacheDir();
+
+		static bool Load(uint64_t key, MeshData& meshData);
+		static void Store(uint64_t key, const MeshData& meshData);
+
+		// The on-disk layout without the file, shared with AssetPackage mesh blobs
+		static bool Read(std::span<const uint8_t> data, MeshData& meshData);
+		static bool Write(std::ostream& stream, const MeshData& meshData);
+
+	private:
+		static std::filesystem::path GetBinaryPath(uint64_t key);
+
+	private:
+		static inline std::mutex s_Mutex;
+	};
+
+}
@@ -0,0 +1,44 @@
+#include "VulkanAbstraction/Geometry/MeshData.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	uint64_t MeshImportOptions::GetHash() const
+	{
+		uint64_t hash = HashUtils::Hash64(&quantize, sizeof(quantize));
+		hash = HashUtils::Hash64(&overdrawThreshold, sizeof(overdrawThreshold), hash);
+		hash = HashUtils::Hash64(&maxLods, sizeof(maxLods), hash);
+		hash = HashUtils::Hash64(&lodRatio, sizeof(lodRatio), hash);
+		hash = HashUtils::Hash64(&maxLodError, sizeof(maxLodError), hash);
+		hash = HashUtils::Hash64(&buildMeshlets, sizeof(buildMeshlets), hash);
+		return HashUtils::Hash64(&meshletConeWeight, sizeof(meshletConeWeight), hash);
+	}
+
+	float LodSelection::GetProjectionScale(const glm::mat4& projection, float viewportHeight)
+	{
+		// projection[1][1] is 1 / tan(fovY / 2), negative when Y is flipped
+		return std::abs(projection[1][1]) * viewportHeight * 0.5f;
+	}
+
+	uint32_t LodSelection::Select(const Submesh& submesh, const glm::mat4& transform) const
+	{
+		float scale = std::max({
+			glm::length(glm::vec3(transform[0])),
+			glm::length(glm::vec3(transform[1])),
+			glm::length(glm::vec3(transform[2])) });
+
+		glm::vec3 center = glm::vec3(transform * glm::vec4(glm::vec3(submesh.boundingSphere), 1.0f));
+		float distance = std::max(glm::length(center - cameraPosition) - submesh.boundingSphere.w * scale, 0.0f);
+
+		float factor = GetDistanceFactor();
+		for (uint32_t lod = submesh.lodCount; lod-- > 1;)
+		{
+			if (submesh.lods[lod].error * scale * factor <= distance)
+				return lod;
+		}
+
+		return 0;
+	}
+
+}
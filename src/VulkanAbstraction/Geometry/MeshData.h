@@ -0,0 +1,183 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "VulkanAbstraction/VulkanTypes.h"
+
+
+namespace VulkanEngine {
+
+	// Vertex shaders declare constant_id = 3 to pick the quantized layout
+	static constexpr uint32_t QUANTIZED_VERTICES_ID = 3;
+
+	// Mirrors Assets/Shaders/Include/Vertex.glsl, vertices are pulled through a buffer device address
+	struct Vertex
+	{
+		glm::vec3	position{ 0.0f };
+		float		uvX{ 0.0f };
+		glm::vec3	normal{ 0.0f, 0.0f, 1.0f };
+		float		uvY{ 0.0f };
+	};
+	static_assert(sizeof(Vertex) == 32);
+
+	// Half float position and uv, octahedral snorm8 normal
+	struct QuantizedVertex
+	{
+		uint16_t	position[3];
+		int8_t		normal[2];
+		uint16_t	uv[2];
+	};
+	static_assert(sizeof(QuantizedVertex) == 12);
+
+	static constexpr uint32_t kMaxMeshLods = 8;
+
+	// One level of detail, an index range over the submesh's vertices
+	struct MeshLod
+	{
+		uint32_t	firstIndex{ 0 };
+		uint32_t	indexCount{ 0 };
+		float		error{ 0.0f }; // mesh space distance to the full detail surface, 0 for LOD 0
+	};
+
+	// Limits of one mesh shader workgroup, Assets/Shaders/Include/Meshlet.glsl declares the same
+	static constexpr uint32_t kMeshletMaxVertices	= 64;
+	static constexpr uint32_t kMeshletMaxTriangles	= 124;
+
+	// Mirrors Assets/Shaders/Include/Meshlet.glsl (std430).
+	// vertexOffset indexes MeshData::meshletVertices, whose entries are local to the submesh like its indices.
+	// triangleOffset indexes MeshData::meshletTriangles, one packed triangle per entry.
+	struct Meshlet
+	{
+		glm::vec4	boundingSphere{ 0.0f };	// mesh space, xyz center + w radius
+		glm::vec3	coneApex{ 0.0f };
+		float		coneCutoff{ 1.0f };		// backfacing from every view when dot(normalize(apex - eye), axis) >= cutoff
+		glm::vec3	coneAxis{ 0.0f };
+		uint32_t	vertexOffset{ 0 };
+		uint32_t	triangleOffset{ 0 };
+		uint32_t	vertexCount{ 0 };
+		uint32_t	triangleCount{ 0 };
+		uint32_t	padding{ 0 };
+	};
+	static_assert(sizeof(Meshlet) == 64);
+
+	// One glTF primitive. Indices are local to the submesh, drawn with vertexOffset.
+	// LODs go from full detail to coarsest, all of them index the same vertices.
+	// Meshlets cover LOD 0 only.
+	struct Submesh
+	{
+		int32_t							vertexOffset{ 0 };
+		uint32_t						vertexCount{ 0 };
+		glm::vec4						boundingSphere{ 0.0f }; // mesh space, xyz center + w radius
+		uint32_t						lodCount{ 0 };
+		std::array<MeshLod, kMaxMeshLods> lods{};
+		uint32_t						firstMeshlet{ 0 };
+		uint32_t						meshletCount{ 0 };
+	};
+
+	// Placement of a submesh in the imported scene
+	struct MeshNode
+	{
+		uint32_t	submesh{ 0 };
+		glm::mat4	transform{ 1.0f };
+	};
+
+	struct MeshImportOptions
+	{
+		bool	quantize			= false;
+		float	overdrawThreshold	= 1.05f; // allowed vertex cache degradation when reordering for overdraw
+
+		// Each LOD targets lodRatio of the previous one's triangles, generation stops at maxLods,
+		// at maxLodError (relative to the mesh extent) or when simplification stops making progress
+		uint32_t	maxLods		= kMaxMeshLods;
+		float		lodRatio	= 0.5f;
+		float		maxLodError	= 0.05f;
+
+		// Meshlets for the mesh shader path, coneWeight trades spatial compactness for tighter
+		// backface cones
+		bool	buildMeshlets		= true;
+		float	meshletConeWeight	= 0.25f;
+
+		uint64_t GetHash() const;
+	};
+
+	// Every submesh of a file packed into one vertex and one index array
+	struct MeshData
+	{
+		bool					quantized{ false };
+		uint32_t				vertexStride{ sizeof(Vertex) };
+		std::vector<uint8_t>	vertices;
+		std::vector<uint32_t>	indices;
+		std::vector<Submesh>	submeshes;
+		std::vector<MeshNode>	nodes;
+
+		std::vector<Meshlet>	meshlets;
+		std::vector<uint32_t>	meshletVertices;
+		std::vector<uint32_t>	meshletTriangles; // 8 bits per corner, top byte unused
+
+		uint32_t GetVertexCount() const { return static_cast<uint32_t>(vertices.size() / vertexStride); }
+	};
+
+	// Picks the coarsest LOD whose error projects to at most errorThreshold pixels.
+	// Shared by CPU submission and GPU culling (GpuCullData), so both choose the same LOD.
+	struct LodSelection
+	{
+		glm::vec3	cameraPosition{ 0.0f };
+		float		projectionScale{ 1.0f }; // pixels per unit at distance 1, see GetProjectionScale
+		float		errorThreshold{ 1.0f };	 // pixels
+
+		// Vertical scale of a perspective projection for a viewport of the given height
+		static float GetProjectionScale(const glm::mat4& projection, float viewportHeight);
+
+		// Distance to the sphere's surface over error, LOD i is used while error_i * scale * factor <= distance
+		float GetDistanceFactor() const { return projectionScale / errorThreshold; }
+
+		uint32_t Select(const Submesh& submesh, const glm::mat4& transform) const;
+	};
+
+	// Device local, the vertex and meshlet buffers are read through their addresses.
+	// Meshlet buffers stay empty when the data has no meshlets.
+	struct MeshBuffers
+	{
+		AllocatedBuffer vertexBuffer;
+		AllocatedBuffer indexBuffer;
+		AllocatedBuffer meshletBuffer;
+		AllocatedBuffer meshletVertexBuffer;
+		AllocatedBuffer meshletTriangleBuffer;
+
+		bool HasMeshlets() const { return meshletBuffer.buffer != VK_NULL_HANDLE; }
+
+		// Blocks until the copy is done, buffers are destroyed on shutdown
+		static MeshBuffers Upload(const MeshData& meshData);
+
+		// The same upload split for the asynchronous path (AssetLoader): the staging buffer is filled on any
+		// thread, the copies are recorded later into a command buffer the caller submits.
+		// Staging must be GetStagingSize bytes and outlive the command buffer. The buffers are owned by
+		// the caller, they go with Release.
+		static VkDeviceSize GetStagingSize(const MeshData& meshData);
+		static void WriteStaging(const MeshData& meshData, void* staging);
+		static MeshBuffers RecordUpload(VkCommandBuffer cmd, const MeshData& meshData, const AllocatedBuffer& staging);
+
+		// Through the deletion queue, once the frames in flight are done with them
+		void Release();
+
+	private:
+		// Destination, source and the stages that read it afterwards
+		struct Region
+		{
+			AllocatedBuffer MeshBuffers::*	buffer;
+			VkBufferUsageFlags				usage;
+			const void*						data;
+			VkDeviceSize					size;
+			VkPipelineStageFlags2			readStages;
+			VkAccessFlags2					readAccess;
+			VkDeviceSize					stagingOffset{ 0 };
+		};
+
+		// Same order and offsets for every call with the same data
+		static std::vector<Region> GetRegions(const MeshData& meshData);
+	};
+
+}
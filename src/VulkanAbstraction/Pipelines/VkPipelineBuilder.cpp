@@ -1,4 +1,7 @@
 #include "VulkanAbstraction/Pipelines/VkPipelineBuilder.h"
+#include "VulkanAbstraction/Pipelines/VulkanPipelineLibrary.h"
+#include "VulkanAbstraction/Pipelines/VulkanLayoutCache.h"
+#include "VulkanAbstraction/Shaders/ShaderHotReloader.h"
 #include "VulkanAbstraction/Core/VulkanContext.h"
 #include "Core/Application.h"
 #include "Core/LogSystem.h"
@@ -9,41 +12,168 @@ namespace VulkanEngine {
 
 	VkPipelineBuilder& VkPipelineBuilder::AddPipelineShader(std::shared_ptr<VulkanShader> shader)
 	{
-		m_Shader = shader;
+		m_Shaders.push_back(shader);
 		return *this;
 	}
 
+	VkPipelineBuilder& VkPipelineBuilder::ReplaceShader(std::shared_ptr<VulkanShader> shader)
+	{
+		for (auto& existing : m_Shaders)
+		{
+			if (existing->GetStage() == shader->GetStage())
+			{
+				existing = shader;
+				return *this;
+			}
+		}
+
+		return AddPipelineShader(shader);
+	}
+
 	VkPipelineBuilder& VkPipelineBuilder::AddPipelineLayout(VkPipelineLayout pipelineLayout)
 	{
 		m_Layout = pipelineLayout;
 		return *this;
 	}
 
+	VkPipelineBuilder& VkPipelineBuilder::SetSpecializationConstant(uint32_t constantID, uint32_t value)
+	{
+		m_Specialization.Set(constantID, value);
+		return *this;
+	}
+
+	VkPipelineBuilder& VkPipelineBuilder::SetWorkgroupSize(const std::array<uint32_t, 3>& size)
+	{
+		m_Specialization.Set(WORKGROUP_SIZE_X_ID, size[0]);
+		m_Specialization.Set(WORKGROUP_SIZE_Y_ID, size[1]);
+		m_Specialization.Set(WORKGROUP_SIZE_Z_ID, size[2]);
+
+		m_WorkgroupSize = size;
+		return *this;
+	}
+
+	VkPipelineBuilder& VkPipelineBuilder::SetGraphicsState(const GraphicsState& state)
+	{
+		m_GraphicsState = state;
+		return *this;
+	}
+
+	VkPipelineBuilder& VkPipelineBuilder::SetColorFormat(VkFormat format)
+	{
+		m_ColorFormat = format;
+		return *this;
+	}
+
+	VkPipelineBuilder& VkPipelineBuilder::SetDepthFormat(VkFormat format)
+	{
+		m_DepthFormat = format;
+		return *this;
+	}
+
 	VkPipeline VkPipelineBuilder::Build(PipelineType pipelineType)
 	{
 		switch (pipelineType)
 		{
-		case PipelineType::Compute: return BuildCompute();
+		case PipelineType::Compute:  return BuildCompute();
+		case PipelineType::Graphics: return BuildGraphics();
+		case PipelineType::Mesh:	 return BuildMonolithicGraphics(GetMeshDescription());
+		default:
+			VulkanEngine_ERROR("Unknown pipeline type");
+			std::unreachable();
+		}
+	}
+
+	std::shared_ptr<VulkanPipeline> VkPipelineBuilder::BuildShared(PipelineType pipelineType)
+	{
+		if (pipelineType == PipelineType::Graphics && VulkanPipelineLibrary::IsSupported())
+		{
+			return VulkanRenderer::GetPipelineLibrary().Link(GetGraphicsDescription());
+		}
+
+		VkPipelineBindPoint bindPoint = pipelineType == PipelineType::Compute
+			? VK_PIPELINE_BIND_POINT_COMPUTE
+			: VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+		auto pipeline = std::make_shared<VulkanPipeline>(Build(pipelineType), bindPoint);
+		pipeline->SetWorkgroupSize(GetWorkgroupSize());
+
+		return pipeline;
+	}
+
+	VkPipeline VkPipelineBuilder::BuildUnmanaged(PipelineType pipelineType) const
+	{
+		VkPipelineBuilder builder = *this;
+		builder.m_Unmanaged = true;
+
+		switch (pipelineType)
+		{
+		case PipelineType::Compute:  return builder.BuildCompute();
+		case PipelineType::Graphics: return builder.BuildMonolithicGraphics(builder.GetGraphicsDescription());
+		case PipelineType::Mesh:	 return builder.BuildMonolithicGraphics(builder.GetMeshDescription());
 		default:
 			VulkanEngine_ERROR("Unknown pipeline type");
 			std::unreachable();
 		}
 	}
 
+	std::shared_ptr<VulkanPipeline> VkPipelineBuilder::BuildReloadable(PipelineType pipelineType)
+	{
+		VkPipeline pipeline = BuildUnmanaged(pipelineType);
+
+		VkPipelineBindPoint bindPoint = pipelineType == PipelineType::Compute
+			? VK_PIPELINE_BIND_POINT_COMPUTE
+			: VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+		auto reloadable = std::make_shared<VulkanPipeline>(pipeline, bindPoint);
+		reloadable->SetWorkgroupSize(GetWorkgroupSize());
+		ShaderHotReloader::Register(reloadable, *this, pipelineType);
+
+		return reloadable;
+	}
+
+	PipelineHandle VkPipelineBuilder::BuildHandle(PipelineType pipelineType)
+	{
+		PipelineResource resource;
+		resource.pipeline		= BuildUnmanaged(pipelineType);
+		resource.bindPoint		= pipelineType == PipelineType::Compute ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS;
+		resource.workgroupSize	= GetWorkgroupSize();
+
+		PipelineHandle handle = VulkanRenderer::GetResources().AddPipeline(resource);
+		if (!handle)
+		{
+			VulkanRenderer::GetDeletionQueue().Release(resource.pipeline);
+			return handle;
+		}
+
+		ShaderHotReloader::Register(handle, *this, pipelineType);
+
+		return handle;
+	}
+
 	VkPipeline VkPipelineBuilder::BuildCompute()
 	{
 		auto*		app		= Application::GetRaw();
 		auto*		ctx		= VulkanContext::GetRaw();
 		VkDevice	device	= *ctx->GetDevice();
 
+		auto shader = FindShader(VK_SHADER_STAGE_COMPUTE_BIT);
+		if (!shader)
+		{
+			VulkanEngine_CRITICAL("Compute pipeline requires a compute shader");
+			return VK_NULL_HANDLE;
+		}
+
 		// Stage info
+		VkSpecializationInfo specializationInfo = m_Specialization.GetInfo();
+
 		VkPipelineShaderStageCreateInfo stageInfo{
-			.sType	= VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-			.pNext	= nullptr,
-			.flags	= 0,
-			.stage	= VK_SHADER_STAGE_COMPUTE_BIT,
-			.module = m_Shader->GetRaw(),
-			.pName	= "main"
+			.sType					= VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+			.pNext					= nullptr,
+			.flags					= 0,
+			.stage					= VK_SHADER_STAGE_COMPUTE_BIT,
+			.module					= shader->GetRaw(),
+			.pName					= "main",
+			.pSpecializationInfo	= m_Specialization.IsEmpty() ? nullptr : &specializationInfo
 		};
 
 		// Pipeline
@@ -52,7 +182,7 @@ namespace VulkanEngine {
 			.pNext				= nullptr,
 			.flags				= 0,
 			.stage				= stageInfo,
-			.layout				= m_Layout,
+			.layout				= GetLayout(),
 			.basePipelineHandle = VK_NULL_HANDLE,
 			.basePipelineIndex	= -1
 		};
@@ -60,9 +190,174 @@ namespace VulkanEngine {
 		VkPipeline pipeline{ VK_NULL_HANDLE };
 		CHECK_VK_RES(vkCreateComputePipelines(*ctx->GetDevice(), VK_NULL_HANDLE, 1, &computePipelineCreateInfo, nullptr, &pipeline));
 
-		app->GetLifetimeManager()->Push(vkDestroyPipeline, device, pipeline, nullptr);
+		if (!m_Unmanaged)
+			app->GetLifetimeManager()->Push(vkDestroyPipeline, device, pipeline, nullptr);
+
+		return pipeline;
+	}
+
+	VkPipeline VkPipelineBuilder::BuildGraphics()
+	{
+		GraphicsPipelineDescription desc = GetGraphicsDescription();
+
+		// Pipeline library path, no background optimization since the raw handle can't be swapped
+		if (VulkanPipelineLibrary::IsSupported())
+		{
+			return VulkanRenderer::GetPipelineLibrary().Link(desc, false)->GetRaw();
+		}
+
+		return BuildMonolithicGraphics(desc);
+	}
+
+	VkPipeline VkPipelineBuilder::BuildMonolithicGraphics(const GraphicsPipelineDescription& desc)
+	{
+		auto*		app		= Application::GetRaw();
+		auto*		ctx		= VulkanContext::GetRaw();
+		VkDevice	device	= *ctx->GetDevice();
+
+		GraphicsPipelineStateInfos states(desc);
+		VkSpecializationInfo specializationInfo = desc.specialization.GetInfo();
+		const VkSpecializationInfo* pSpecializationInfo = desc.specialization.IsEmpty() ? nullptr : &specializationInfo;
+
+		// Mesh pipelines replace the vertex stage with task (optional) + mesh and have no vertex input
+		bool meshPipeline = desc.meshShader != VK_NULL_HANDLE;
+
+		std::array<VkPipelineShaderStageCreateInfo, 3> stages{};
+		uint32_t stageCount = 0;
+
+		auto addStage = [&](VkShaderStageFlagBits stage, VkShaderModule module)
+			{
+				stages[stageCount++] = {
+					.sType					= VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+					.stage					= stage,
+					.module					= module,
+					.pName					= "main",
+					.pSpecializationInfo	= pSpecializationInfo
+				};
+			};
+
+		if (meshPipeline)
+		{
+			if (desc.taskShader != VK_NULL_HANDLE)
+				addStage(VK_SHADER_STAGE_TASK_BIT_EXT, desc.taskShader);
+			addStage(VK_SHADER_STAGE_MESH_BIT_EXT, desc.meshShader);
+		}
+		else
+		{
+			addStage(VK_SHADER_STAGE_VERTEX_BIT, desc.vertexShader);
+		}
+		addStage(VK_SHADER_STAGE_FRAGMENT_BIT, desc.fragmentShader);
+
+		VkGraphicsPipelineCreateInfo createInfo{
+			.sType					= VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+			.pNext					= &states.rendering,
+			.flags					= 0,
+			.stageCount				= stageCount,
+			.pStages				= stages.data(),
+			.pVertexInputState		= meshPipeline ? nullptr : &states.vertexInput,
+			.pInputAssemblyState	= meshPipeline ? nullptr : &states.inputAssembly,
+			.pViewportState			= &states.viewport,
+			.pRasterizationState	= &states.rasterization,
+			.pMultisampleState		= &states.multisample,
+			.pDepthStencilState		= &states.depthStencil,
+			.pColorBlendState		= &states.colorBlend,
+			.pDynamicState			= &states.dynamicState,
+			.layout					= desc.layout,
+			.basePipelineHandle		= VK_NULL_HANDLE,
+			.basePipelineIndex		= -1
+		};
+
+		VkPipeline pipeline{ VK_NULL_HANDLE };
+		CHECK_VK_RES(vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline));
+
+		if (!m_Unmanaged)
+			app->GetLifetimeManager()->Push(vkDestroyPipeline, device, pipeline, nullptr);
 
 		return pipeline;
 	}
 
-}
\ No newline at end of file
+	GraphicsPipelineDescription VkPipelineBuilder::GetGraphicsDescription() const
+	{
+		auto vertexShader	= FindShader(VK_SHADER_STAGE_VERTEX_BIT);
+		auto fragmentShader = FindShader(VK_SHADER_STAGE_FRAGMENT_BIT);
+
+		if (!vertexShader || !fragmentShader)
+		{
+			VulkanEngine_CRITICAL("Graphics pipeline requires a vertex and a fragment shader");
+			return {};
+		}
+
+		return GraphicsPipelineDescription{
+			.vertexShader		= vertexShader->GetRaw(),
+			.fragmentShader		= fragmentShader->GetRaw(),
+			.vertexShaderHash	= vertexShader->GetHash(),
+			.fragmentShaderHash = fragmentShader->GetHash(),
+			.layout				= GetLayout(),
+			.state				= m_GraphicsState,
+			.colorFormat		= m_ColorFormat,
+			.depthFormat		= m_DepthFormat,
+			.specialization		= m_Specialization
+		};
+	}
+
+	GraphicsPipelineDescription VkPipelineBuilder::GetMeshDescription() const
+	{
+		auto taskShader		= FindShader(VK_SHADER_STAGE_TASK_BIT_EXT);
+		auto meshShader		= FindShader(VK_SHADER_STAGE_MESH_BIT_EXT);
+		auto fragmentShader = FindShader(VK_SHADER_STAGE_FRAGMENT_BIT);
+
+		if (!VulkanRenderer::IsMeshShadingSupported())
+		{
+			VulkanEngine_CRITICAL("Mesh pipeline requires VK_EXT_mesh_shader");
+			return {};
+		}
+
+		if (!meshShader || !fragmentShader)
+		{
+			VulkanEngine_CRITICAL("Mesh pipeline requires a mesh and a fragment shader");
+			return {};
+		}
+
+		return GraphicsPipelineDescription{
+			.fragmentShader		= fragmentShader->GetRaw(),
+			.taskShader			= taskShader ? taskShader->GetRaw() : VK_NULL_HANDLE,
+			.meshShader			= meshShader->GetRaw(),
+			.fragmentShaderHash = fragmentShader->GetHash(),
+			.layout				= GetLayout(),
+			.state				= m_GraphicsState,
+			.colorFormat		= m_ColorFormat,
+			.depthFormat		= m_DepthFormat,
+			.specialization		= m_Specialization
+		};
+	}
+
+	std::array<uint32_t, 3> VkPipelineBuilder::GetWorkgroupSize() const
+	{
+		if (m_WorkgroupSize)
+			return *m_WorkgroupSize;
+
+		auto shader = FindShader(VK_SHADER_STAGE_COMPUTE_BIT);
+		return shader ? shader->GetReflection().localSize : std::array<uint32_t, 3>{ 1, 1, 1 };
+	}
+
+	VkPipelineLayout VkPipelineBuilder::GetLayout() const
+	{
+		if (m_Layout != VK_NULL_HANDLE)
+			return m_Layout;
+
+		// No explicit layout, derive it from the shaders
+		return VulkanLayoutCache::GetLayout(m_Shaders).pipelineLayout;
+	}
+
+	std::shared_ptr<VulkanShader> VkPipelineBuilder::FindShader(VkShaderStageFlagBits stage) const
+	{
+		auto it = std::find_if(m_Shaders.begin(), m_Shaders.end(),
+			[stage](const std::shared_ptr<VulkanShader>& shader)
+			{
+				return shader->GetStage() == stage;
+			});
+
+		return it != m_Shaders.end() ? *it : nullptr;
+	}
+
+}
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <array>
+#include <optional>
 #include "VulkanAbstraction/Shaders/VulkanShader.h"
+#include "VulkanAbstraction/Pipelines/VulkanPipeline.h"
+#include "VulkanAbstraction/Resources/ResourceHandle.h"
 
 
 namespace VulkanEngine {
@@ -9,7 +13,8 @@ namespace VulkanEngine {
 	enum class PipelineType : uint8_t
 	{
 		Graphics,
-		Compute
+		Compute,
+		Mesh	// VK_EXT_mesh_shader: optional task, mesh and fragment stages, graphics bind point
 	};
 
 	class VkPipelineBuilder
@@ -19,15 +24,67 @@ namespace VulkanEngine {
 		virtual ~VkPipelineBuilder()	= default;
 
 		VkPipelineBuilder& AddPipelineShader(std::shared_ptr<VulkanShader> shader);
-		VkPipelineBuilder& AddPipelineLayout(VkPipelineLayout pipelineLayout);
+		VkPipelineBuilder& ReplaceShader(std::shared_ptr<VulkanShader> shader); // same stage
+		VkPipelineBuilder& AddPipelineLayout(VkPipelineLayout pipelineLayout); // optional, reflected when omitted
+
+		// Applied to every stage
+		VkPipelineBuilder& SetSpecializationConstant(uint32_t constantID, uint32_t value);
+
+		// Compute only, the shader must declare local_size_*_id matching WORKGROUP_SIZE_*_ID
+		VkPipelineBuilder& SetWorkgroupSize(const std::array<uint32_t, 3>& size);
+
+		// Graphics and mesh only
+		VkPipelineBuilder& SetGraphicsState(const GraphicsState& state);
+		VkPipelineBuilder& SetColorFormat(VkFormat format);
+		VkPipelineBuilder& SetDepthFormat(VkFormat format);
+
 		VkPipeline Build(PipelineType pipelineType);
 
+		// Graphics pipelines built through VK_EXT_graphics_pipeline_library get their
+		// link-time optimized version swapped into the returned object later.
+		// Mesh pipelines have no vertex input library to share and are always monolithic.
+		std::shared_ptr<VulkanPipeline> BuildShared(PipelineType pipelineType);
+
+		// Not registered with the LifetimeManager, the caller destroys it.
+		// Graphics pipelines always take the monolithic path.
+		VkPipeline BuildUnmanaged(PipelineType pipelineType) const;
+
+		// Rebuilt by ShaderHotReloader whenever one of the shader sources changes on disk.
+		// Always a monolithic pipeline owned by the reloader.
+		std::shared_ptr<VulkanPipeline> BuildReloadable(PipelineType pipelineType);
+
+		// Same, as a handle owned by VulkanRenderer::GetResources; reloads rebind it in place
+		PipelineHandle BuildHandle(PipelineType pipelineType);
+
+		const std::vector<std::shared_ptr<VulkanShader>>& GetShaders() const { return m_Shaders; }
+
+		// Explicit size, otherwise the one declared in the compute shader
+		std::array<uint32_t, 3> GetWorkgroupSize() const;
+
+		// Explicit layout, otherwise reflected from the shaders
+		VkPipelineLayout GetLayout() const;
+
 	private:
 		VkPipeline BuildCompute();
+		VkPipeline BuildGraphics();
+		VkPipeline BuildMonolithicGraphics(const GraphicsPipelineDescription& desc);
+
+		GraphicsPipelineDescription		GetGraphicsDescription() const;
+		GraphicsPipelineDescription		GetMeshDescription() const;
+		std::shared_ptr<VulkanShader>	FindShader(VkShaderStageFlagBits stage) const;
 
 	private:
-		std::shared_ptr<VulkanShader> m_Shader;
-		VkPipelineLayout m_Layout{ VK_NULL_HANDLE };
+		std::vector<std::shared_ptr<VulkanShader>>	m_Shaders;
+		VkPipelineLayout							m_Layout{ VK_NULL_HANDLE };
+
+		SpecializationConstants					m_Specialization;
+		std::optional<std::array<uint32_t, 3>>	m_WorkgroupSize;
+
+		GraphicsState	m_GraphicsState;
+		VkFormat		m_ColorFormat{ VK_FORMAT_R16G16B16A16_SFLOAT };
+		VkFormat		m_DepthFormat{ VK_FORMAT_UNDEFINED };
+
+		bool			m_Unmanaged{ false };
 	};
 
-}
\ No newline at end of file
+}
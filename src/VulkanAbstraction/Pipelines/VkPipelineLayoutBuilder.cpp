@@ -9,7 +9,13 @@ namespace VulkanEngine {
 
 	VkPipelineLayoutBuilder& VkPipelineLayoutBuilder::AddDescriptorSetLayout(VkDescriptorSetLayout layout)
 	{
-		m_Layout = layout;
+		m_Layouts.push_back(layout);
+		return *this;
+	}
+
+	VkPipelineLayoutBuilder& VkPipelineLayoutBuilder::AddPushConstantRange(const VkPushConstantRange& range)
+	{
+		m_PushConstantRanges.push_back(range);
 		return *this;
 	}
 
@@ -23,10 +29,10 @@ namespace VulkanEngine {
 			.sType					= VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
 			.pNext					= nullptr,
 			.flags					= 0,
-			.setLayoutCount			= 1,
-			.pSetLayouts			= &m_Layout,
-			.pushConstantRangeCount = 0,
-			.pPushConstantRanges	= nullptr
+			.setLayoutCount			= static_cast<uint32_t>(m_Layouts.size()),
+			.pSetLayouts			= m_Layouts.data(),
+			.pushConstantRangeCount = static_cast<uint32_t>(m_PushConstantRanges.size()),
+			.pPushConstantRanges	= m_PushConstantRanges.data()
 		};
 
 		VkPipelineLayout pipelineLayout{ VK_NULL_HANDLE };
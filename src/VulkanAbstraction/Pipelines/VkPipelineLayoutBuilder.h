@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <vector>
 
 
 namespace VulkanEngine {
@@ -11,11 +12,14 @@ namespace VulkanEngine {
 		VkPipelineLayoutBuilder()			= default;
 		virtual ~VkPipelineLayoutBuilder()	= default;
 
+		// Set index is the order of the calls
 		VkPipelineLayoutBuilder& AddDescriptorSetLayout(VkDescriptorSetLayout layout);
+		VkPipelineLayoutBuilder& AddPushConstantRange(const VkPushConstantRange& range);
 		VkPipelineLayout Build();
 
 	private:
-		VkDescriptorSetLayout m_Layout{ VK_NULL_HANDLE };
+		std::vector<VkDescriptorSetLayout>	m_Layouts;
+		std::vector<VkPushConstantRange>	m_PushConstantRanges;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "VulkanAbstraction/Pipelines/VulkanLayoutCache.h"
+#include "VulkanAbstraction/Pipelines/VkPipelineLayoutBuilder.h"
+#include "VulkanAbstraction/Descriptors/VkDescriptorSetLayoutBuilder.h"
+#include "VulkanAbstraction/Shaders/VulkanShader.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	template<typename T>
+	static uint64_t HashValue(const T& value, uint64_t seed)
+	{
+		return HashUtils::Hash64(&value, sizeof(T), seed);
+	}
+
+	ReflectedLayout VulkanLayoutCache::GetLayout(const std::vector<std::shared_ptr<VulkanShader>>& shaders)
+	{
+		ReflectedLayout layout;
+
+		for (const auto& shader : shaders)
+			layout.reflection.Merge(shader->GetReflection());
+
+		// Sets without bindings in between still need a (empty) layout
+		uint32_t setCount = layout.reflection.GetSetCount();
+		for (uint32_t set = 0; set < setCount; ++set)
+		{
+			std::vector<ShaderResourceBinding> setBindings;
+			for (const auto& binding : layout.reflection.bindings)
+			{
+				if (binding.set == set)
+					setBindings.push_back(binding);
+			}
+
+			layout.setLayouts.push_back(GetDescriptorSetLayout(setBindings));
+		}
+
+		layout.pipelineLayout = GetPipelineLayout(layout.setLayouts, layout.reflection.pushConstantRanges);
+
+		return layout;
+	}
+
+	VkDescriptorSetLayout VulkanLayoutCache::GetDescriptorSetLayout(const std::vector<ShaderResourceBinding>& bindings)
+	{
+		uint64_t key = HashUtils::kHashSeed;
+		for (const auto& binding : bindings)
+		{
+			key = HashValue(binding.binding, key);
+			key = HashValue(binding.descriptorType, key);
+			key = HashValue(binding.descriptorCount, key);
+			key = HashValue(binding.stageFlags, key);
+		}
+
+		std::lock_guard lock(s_Mutex);
+
+		if (auto it = s_SetLayouts.find(key); it != s_SetLayouts.end())
+			return it->second;
+
+		VkDescriptorSetLayoutBuilder builder;
+		for (const auto& binding : bindings)
+			builder.AddBinding(binding.binding, binding.descriptorType, binding.descriptorCount, binding.stageFlags);
+
+		VkDescriptorSetLayout setLayout = builder.Build();
+		s_SetLayouts.emplace(key, setLayout);
+
+		return setLayout;
+	}
+
+	VkPipelineLayout VulkanLayoutCache::GetPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts,
+		const std::vector<VkPushConstantRange>& pushConstantRanges)
+	{
+		uint64_t key = HashUtils::Hash64(setLayouts.data(), setLayouts.size() * sizeof(VkDescriptorSetLayout));
+		key = HashUtils::Hash64(pushConstantRanges.data(), pushConstantRanges.size() * sizeof(VkPushConstantRange), key);
+
+		std::lock_guard lock(s_Mutex);
+
+		if (auto it = s_PipelineLayouts.find(key); it != s_PipelineLayouts.end())
+			return it->second;
+
+		VkPipelineLayoutBuilder builder;
+		for (VkDescriptorSetLayout setLayout : setLayouts)
+			builder.AddDescriptorSetLayout(setLayout);
+
+		for (const auto& range : pushConstantRanges)
+			builder.AddPushConstantRange(range);
+
+		VkPipelineLayout pipelineLayout = builder.Build();
+		s_PipelineLayouts.emplace(key, pipelineLayout);
+
+		VulkanEngine_DEBUG(fmt::runtime("Created pipeline layout: {} sets, {} push constant ranges"),
+			setLayouts.size(), pushConstantRanges.size());
+
+		return pipelineLayout;
+	}
+
+}
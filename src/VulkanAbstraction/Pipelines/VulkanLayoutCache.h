@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "VulkanAbstraction/Shaders/ShaderReflection.h"
+
+
+namespace VulkanEngine {
+
+	class VulkanShader;
+
+	// Layouts derived from the shaders of one pipeline
+	struct ReflectedLayout
+	{
+		ShaderReflection					reflection; // all stages merged
+		std::vector<VkDescriptorSetLayout>	setLayouts;
+		VkPipelineLayout					pipelineLayout{ VK_NULL_HANDLE };
+
+		std::vector<PoolSize> GetPoolSizes(uint32_t set, uint32_t setCount = 1) const { return reflection.GetPoolSizes(set, setCount); }
+	};
+
+	// Deduplicates descriptor set and pipeline layouts by content.
+	// Pipelines whose shaders share an interface share the same VkPipelineLayout, which keeps
+	// descriptor sets compatible across them.
+	class VulkanLayoutCache
+	{
+	public:
+		VulkanLayoutCache()		= delete;
+		~VulkanLayoutCache()	= delete;
+
+		static ReflectedLayout GetLayout(const std::vector<std::shared_ptr<VulkanShader>>& shaders);
+
+		// Bindings of a single set
+		static VkDescriptorSetLayout	GetDescriptorSetLayout(const std::vector<ShaderResourceBinding>& bindings);
+		static VkPipelineLayout			GetPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts,
+			const std::vector<VkPushConstantRange>& pushConstantRanges);
+
+	private:
+		static inline std::mutex										s_Mutex;
+		static inline std::unordered_map<uint64_t, VkDescriptorSetLayout>	s_SetLayouts;
+		static inline std::unordered_map<uint64_t, VkPipelineLayout>		s_PipelineLayouts;
+	};
+
+}
@@ -0,0 +1,93 @@
+#include "VulkanAbstraction/Pipelines/VulkanPipeline.h"
+
+
+namespace VulkanEngine {
+
+	VulkanPipeline::VulkanPipeline(VkPipeline pipeline, VkPipelineBindPoint bindPoint)
+		: m_Pipeline(pipeline), m_BindPoint(bindPoint)
+	{
+
+	}
+
+	GraphicsPipelineStateInfos::GraphicsPipelineStateInfos(const GraphicsPipelineDescription& desc)
+	{
+		const GraphicsState& state = desc.state;
+
+		// Vertex data is pulled from buffers in the shader
+		vertexInput = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO
+		};
+
+		inputAssembly = {
+			.sType					= VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+			.topology				= state.topology,
+			.primitiveRestartEnable = VK_FALSE
+		};
+
+		// Viewport and scissor are dynamic
+		viewport = {
+			.sType			= VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+			.viewportCount	= 1,
+			.scissorCount	= 1
+		};
+
+		rasterization = {
+			.sType			= VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+			.polygonMode	= state.polygonMode,
+			.cullMode		= state.cullMode,
+			.frontFace		= state.frontFace,
+			.lineWidth		= 1.0f
+		};
+
+		multisample = {
+			.sType					= VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+			.rasterizationSamples	= state.samples,
+			.minSampleShading		= 1.0f
+		};
+
+		depthStencil = {
+			.sType				= VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+			.depthTestEnable	= state.depthTest,
+			.depthWriteEnable	= state.depthWrite,
+			.depthCompareOp		= state.depthCompareOp,
+			.minDepthBounds		= 0.0f,
+			.maxDepthBounds		= 1.0f
+		};
+
+		colorBlendAttachment = {
+			.blendEnable			= state.blendEnable,
+			.srcColorBlendFactor	= state.blendEquation.srcColorBlendFactor,
+			.dstColorBlendFactor	= state.blendEquation.dstColorBlendFactor,
+			.colorBlendOp			= state.blendEquation.colorBlendOp,
+			.srcAlphaBlendFactor	= state.blendEquation.srcAlphaBlendFactor,
+			.dstAlphaBlendFactor	= state.blendEquation.dstAlphaBlendFactor,
+			.alphaBlendOp			= state.blendEquation.alphaBlendOp,
+			.colorWriteMask			=
+				VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+				VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+		};
+
+		colorBlend = {
+			.sType				= VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+			.logicOpEnable		= VK_FALSE,
+			.attachmentCount	= 1,
+			.pAttachments		= &colorBlendAttachment
+		};
+
+		dynamicState = {
+			.sType				= VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+			.dynamicStateCount	= static_cast<uint32_t>(dynamicStates.size()),
+			.pDynamicStates		= dynamicStates.data()
+		};
+
+		// Dynamic rendering
+		colorFormat = desc.colorFormat;
+		rendering = {
+			.sType					 = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+			.colorAttachmentCount	 = 1,
+			.pColorAttachmentFormats = &colorFormat,
+			.depthAttachmentFormat	 = desc.depthFormat
+		};
+	}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <array>
+
+#include "VulkanAbstraction/VulkanTypes.h"
+
+
+namespace VulkanEngine {
+
+	// Everything needed to create a graphics pipeline, shared by the monolithic and the library path
+	struct GraphicsPipelineDescription
+	{
+		VkShaderModule		vertexShader{ VK_NULL_HANDLE };
+		VkShaderModule		fragmentShader{ VK_NULL_HANDLE };
+		VkShaderModule		taskShader{ VK_NULL_HANDLE };	// mesh pipelines only, optional
+		VkShaderModule		meshShader{ VK_NULL_HANDLE };	// set instead of vertexShader for mesh pipelines
+		uint64_t			vertexShaderHash{ 0 };
+		uint64_t			fragmentShaderHash{ 0 };
+		VkPipelineLayout	layout{ VK_NULL_HANDLE };
+		GraphicsState		state;
+		VkFormat			colorFormat{ VK_FORMAT_R16G16B16A16_SFLOAT };
+		VkFormat			depthFormat{ VK_FORMAT_UNDEFINED };
+		SpecializationConstants specialization;
+	};
+
+	// Pipeline handle that can be replaced while in use (optimized GPL link, hot reload).
+	// Readers always see either the old or the new VkPipeline.
+	class VulkanPipeline
+	{
+	public:
+		VulkanPipeline(VkPipeline pipeline, VkPipelineBindPoint bindPoint);
+		virtual ~VulkanPipeline() = default;
+		VulkanPipeline(const VulkanPipeline&)				= delete;
+		VulkanPipeline& operator=(const VulkanPipeline&)	= delete;
+
+		VkPipeline			GetRaw()		const { return m_Pipeline.load(std::memory_order_acquire); }
+		VkPipelineBindPoint GetBindPoint()	const { return m_BindPoint; }
+
+		// Compute only, the local size the pipeline was created with
+		const std::array<uint32_t, 3>&	GetWorkgroupSize() const { return m_WorkgroupSize; }
+		void							SetWorkgroupSize(const std::array<uint32_t, 3>& size) { m_WorkgroupSize = size; }
+
+		// Returns the previous pipeline, the caller owns its destruction
+		VkPipeline Swap(VkPipeline pipeline) { return m_Pipeline.exchange(pipeline, std::memory_order_acq_rel); }
+
+	private:
+		std::atomic<VkPipeline> m_Pipeline{ VK_NULL_HANDLE };
+		VkPipelineBindPoint		m_BindPoint{ VK_PIPELINE_BIND_POINT_GRAPHICS };
+		std::array<uint32_t, 3> m_WorkgroupSize{ 1, 1, 1 };
+	};
+
+	// Fixed-function create infos for a GraphicsPipelineDescription.
+	// Holds internal pointers, so it is filled in place and never copied.
+	struct GraphicsPipelineStateInfos
+	{
+		GraphicsPipelineStateInfos(const GraphicsPipelineDescription& desc);
+		GraphicsPipelineStateInfos(const GraphicsPipelineStateInfos&)				= delete;
+		GraphicsPipelineStateInfos& operator=(const GraphicsPipelineStateInfos&)	= delete;
+
+		VkPipelineVertexInputStateCreateInfo	vertexInput{};
+		VkPipelineInputAssemblyStateCreateInfo	inputAssembly{};
+		VkPipelineViewportStateCreateInfo		viewport{};
+		VkPipelineRasterizationStateCreateInfo	rasterization{};
+		VkPipelineMultisampleStateCreateInfo	multisample{};
+		VkPipelineDepthStencilStateCreateInfo	depthStencil{};
+		VkPipelineColorBlendAttachmentState		colorBlendAttachment{};
+		VkPipelineColorBlendStateCreateInfo		colorBlend{};
+		VkPipelineDynamicStateCreateInfo		dynamicState{};
+		VkPipelineRenderingCreateInfo			rendering{};
+
+		VkFormat								colorFormat{ VK_FORMAT_UNDEFINED };
+		std::array<VkDynamicState, 2>			dynamicStates{ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+	};
+
+}
@@ -0,0 +1,348 @@
+#include "VulkanAbstraction/Pipelines/VulkanPipelineLibrary.h"
+#include "VulkanAbstraction/Core/VulkanContext.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "Core/Application.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	enum class LibraryPart : uint32_t
+	{
+		VertexInput,
+		PreRasterization,
+		FragmentShader,
+		FragmentOutput
+	};
+
+	template<typename T>
+	static uint64_t HashValue(const T& value, uint64_t seed)
+	{
+		return HashUtils::Hash64(&value, sizeof(T), seed);
+	}
+
+	VulkanPipelineLibrary::VulkanPipelineLibrary()
+	{
+		m_Worker = std::thread([this]() { WorkerLoop(); });
+
+		// Deletor
+		auto* app = Application::GetRaw();
+		app->GetLifetimeManager()->PushFunction([this]() { Destroy(); });
+	}
+
+	bool VulkanPipelineLibrary::IsSupported()
+	{
+		auto* ctx = VulkanContext::GetRaw();
+		return ctx && ctx->GetDevice()->IsExtensionEnabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+	}
+
+	std::shared_ptr<VulkanPipeline> VulkanPipelineLibrary::Link(const GraphicsPipelineDescription& desc, bool optimizeInBackground)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		std::array<VkPipeline, 4> parts = {
+			GetVertexInputPart(desc),
+			GetPreRasterizationPart(desc),
+			GetFragmentShaderPart(desc),
+			GetFragmentOutputPart(desc)
+		};
+
+		uint64_t linkKey = HashUtils::Hash64(parts.data(), sizeof(parts));
+		linkKey = HashValue(desc.layout, linkKey);
+
+		{
+			std::lock_guard lock(m_Mutex);
+			if (auto it = m_Linked.find(linkKey); it != m_Linked.end())
+				return it->second;
+		}
+
+		// Fast link, no link-time optimization
+		VkPipeline fastLinked = LinkParts(parts, desc.layout, false);
+
+		std::lock_guard lock(m_Mutex);
+
+		// Another thread linked the same key meanwhile, its pipeline wins and ours was never handed out
+		if (auto it = m_Linked.find(linkKey); it != m_Linked.end())
+		{
+			std::erase(m_OwnedPipelines, fastLinked);
+			vkDestroyPipeline(*VulkanContext::GetRaw()->GetDevice(), fastLinked, nullptr);
+
+			return it->second;
+		}
+
+		auto pipeline = std::make_shared<VulkanPipeline>(fastLinked, VK_PIPELINE_BIND_POINT_GRAPHICS);
+		m_Linked.emplace(linkKey, pipeline);
+
+		auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start);
+		VulkanEngine_DEBUG(fmt::runtime("Fast-linked graphics pipeline in {:.3f} ms"), elapsed.count());
+
+		if (optimizeInBackground && !m_StopWorker)
+		{
+			m_OptimizeQueue.push_back({ pipeline, parts, desc.layout });
+			m_WorkerCondition.notify_one();
+		}
+
+		return pipeline;
+	}
+
+	// ===========================================================================
+	// Library parts
+	// ===========================================================================
+
+	VkPipeline VulkanPipelineLibrary::GetVertexInputPart(const GraphicsPipelineDescription& desc)
+	{
+		uint64_t key = HashValue(LibraryPart::VertexInput, HashUtils::kHashSeed);
+		key = HashValue(desc.state.topology, key);
+
+		{
+			std::lock_guard lock(m_Mutex);
+			if (auto it = m_Parts.find(key); it != m_Parts.end())
+				return it->second;
+		}
+
+		GraphicsPipelineStateInfos states(desc);
+
+		VkGraphicsPipelineCreateInfo createInfo{
+			.sType					= VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+			.pVertexInputState		= &states.vertexInput,
+			.pInputAssemblyState	= &states.inputAssembly
+		};
+
+		return CreatePart(key, VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, createInfo);
+	}
+
+	VkPipeline VulkanPipelineLibrary::GetPreRasterizationPart(const GraphicsPipelineDescription& desc)
+	{
+		uint64_t key = HashValue(LibraryPart::PreRasterization, HashUtils::kHashSeed);
+		key = HashValue(desc.vertexShaderHash, key);
+		key = HashValue(desc.state.polygonMode, key);
+		key = HashValue(desc.state.cullMode, key);
+		key = HashValue(desc.state.frontFace, key);
+		key = HashValue(desc.layout, key);
+		key = desc.specialization.GetHash(key);
+
+		{
+			std::lock_guard lock(m_Mutex);
+			if (auto it = m_Parts.find(key); it != m_Parts.end())
+				return it->second;
+		}
+
+		GraphicsPipelineStateInfos states(desc);
+		VkSpecializationInfo specializationInfo = desc.specialization.GetInfo();
+
+		VkPipelineShaderStageCreateInfo stageInfo{
+			.sType					= VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+			.stage					= VK_SHADER_STAGE_VERTEX_BIT,
+			.module					= desc.vertexShader,
+			.pName					= "main",
+			.pSpecializationInfo	= desc.specialization.IsEmpty() ? nullptr : &specializationInfo
+		};
+
+		VkGraphicsPipelineCreateInfo createInfo{
+			.sType					= VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+			.pNext					= &states.rendering,
+			.stageCount				= 1,
+			.pStages				= &stageInfo,
+			.pViewportState			= &states.viewport,
+			.pRasterizationState	= &states.rasterization,
+			.pDynamicState			= &states.dynamicState,
+			.layout					= desc.layout
+		};
+
+		return CreatePart(key, VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT, createInfo);
+	}
+
+	VkPipeline VulkanPipelineLibrary::GetFragmentShaderPart(const GraphicsPipelineDescription& desc)
+	{
+		uint64_t key = HashValue(LibraryPart::FragmentShader, HashUtils::kHashSeed);
+		key = HashValue(desc.fragmentShaderHash, key);
+		key = HashValue(desc.state.depthTest, key);
+		key = HashValue(desc.state.depthWrite, key);
+		key = HashValue(desc.state.depthCompareOp, key);
+		key = HashValue(desc.state.samples, key);
+		key = HashValue(desc.layout, key);
+		key = desc.specialization.GetHash(key);
+
+		{
+			std::lock_guard lock(m_Mutex);
+			if (auto it = m_Parts.find(key); it != m_Parts.end())
+				return it->second;
+		}
+
+		GraphicsPipelineStateInfos states(desc);
+		VkSpecializationInfo specializationInfo = desc.specialization.GetInfo();
+
+		VkPipelineShaderStageCreateInfo stageInfo{
+			.sType					= VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+			.stage					= VK_SHADER_STAGE_FRAGMENT_BIT,
+			.module					= desc.fragmentShader,
+			.pName					= "main",
+			.pSpecializationInfo	= desc.specialization.IsEmpty() ? nullptr : &specializationInfo
+		};
+
+		VkGraphicsPipelineCreateInfo createInfo{
+			.sType				= VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+			.pNext				= &states.rendering,
+			.stageCount			= 1,
+			.pStages			= &stageInfo,
+			.pMultisampleState	= &states.multisample,
+			.pDepthStencilState = &states.depthStencil,
+			.layout				= desc.layout
+		};
+
+		return CreatePart(key, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, createInfo);
+	}
+
+	VkPipeline VulkanPipelineLibrary::GetFragmentOutputPart(const GraphicsPipelineDescription& desc)
+	{
+		uint64_t key = HashValue(LibraryPart::FragmentOutput, HashUtils::kHashSeed);
+		key = HashValue(desc.colorFormat, key);
+		key = HashValue(desc.depthFormat, key);
+		key = HashValue(desc.state.samples, key);
+		key = HashValue(desc.state.blendEnable, key);
+		key = HashValue(desc.state.blendEquation, key);
+
+		{
+			std::lock_guard lock(m_Mutex);
+			if (auto it = m_Parts.find(key); it != m_Parts.end())
+				return it->second;
+		}
+
+		GraphicsPipelineStateInfos states(desc);
+
+		VkGraphicsPipelineCreateInfo createInfo{
+			.sType				= VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+			.pNext				= &states.rendering,
+			.pMultisampleState	= &states.multisample,
+			.pColorBlendState	= &states.colorBlend
+		};
+
+		return CreatePart(key, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT, createInfo);
+	}
+
+	VkPipeline VulkanPipelineLibrary::CreatePart(uint64_t key, VkGraphicsPipelineLibraryFlagsEXT part, VkGraphicsPipelineCreateInfo& createInfo)
+	{
+		auto* ctx = VulkanContext::GetRaw();
+
+		VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo{
+			.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+			.pNext = createInfo.pNext,
+			.flags = part
+		};
+
+		createInfo.pNext = &libraryInfo;
+		createInfo.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+
+		// Compiled outside the lock, so parts and links of other states don't wait on it
+		VkPipeline pipeline{ VK_NULL_HANDLE };
+		CHECK_VK_RES(vkCreateGraphicsPipelines(*ctx->GetDevice(), VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline));
+
+		std::lock_guard lock(m_Mutex);
+
+		// Another thread compiled the same part meanwhile, same as a lost race in Link
+		if (auto it = m_Parts.find(key); it != m_Parts.end())
+		{
+			vkDestroyPipeline(*ctx->GetDevice(), pipeline, nullptr);
+			return it->second;
+		}
+
+		m_Parts.emplace(key, pipeline);
+		m_OwnedPipelines.push_back(pipeline);
+
+		return pipeline;
+	}
+
+	VkPipeline VulkanPipelineLibrary::LinkParts(const std::array<VkPipeline, 4>& parts, VkPipelineLayout layout, bool optimize)
+	{
+		auto* ctx = VulkanContext::GetRaw();
+
+		VkPipelineLibraryCreateInfoKHR linkInfo{
+			.sType			= VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+			.pNext			= nullptr,
+			.libraryCount	= static_cast<uint32_t>(parts.size()),
+			.pLibraries		= parts.data()
+		};
+
+		VkGraphicsPipelineCreateInfo createInfo{
+			.sType	= VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+			.pNext	= &linkInfo,
+			.flags	= optimize ? VkPipelineCreateFlags(VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT) : 0,
+			.layout = layout
+		};
+
+		VkPipeline pipeline{ VK_NULL_HANDLE };
+		CHECK_VK_RES(vkCreateGraphicsPipelines(*ctx->GetDevice(), VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline));
+
+		std::lock_guard lock(m_Mutex);
+		m_OwnedPipelines.push_back(pipeline);
+
+		return pipeline;
+	}
+
+	// ===========================================================================
+	// Background optimization
+	// ===========================================================================
+
+	void VulkanPipelineLibrary::WorkerLoop()
+	{
+		while (true)
+		{
+			OptimizeRequest request;
+			{
+				std::unique_lock lock(m_Mutex);
+				m_WorkerCondition.wait(lock, [this]() { return m_StopWorker || !m_OptimizeQueue.empty(); });
+
+				if (m_StopWorker)
+					return;
+
+				request = std::move(m_OptimizeQueue.back());
+				m_OptimizeQueue.pop_back();
+			}
+
+			auto start = std::chrono::high_resolution_clock::now();
+			VkPipeline optimized = LinkParts(request.parts, request.layout, true);
+			auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start);
+
+			// The fast-linked pipeline may still be referenced by frames in flight
+			VkPipeline previous = request.target->Swap(optimized);
+			{
+				std::lock_guard lock(m_Mutex);
+				std::erase(m_OwnedPipelines, previous);
+			}
+			VulkanRenderer::GetDeletionQueue().Release(previous);
+
+			VulkanEngine_DEBUG(fmt::runtime("Swapped in optimized graphics pipeline ({:.3f} ms)"), elapsed.count());
+		}
+	}
+
+	void VulkanPipelineLibrary::StopWorker()
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_StopWorker = true;
+			m_OptimizeQueue.clear();
+		}
+
+		m_WorkerCondition.notify_all();
+
+		if (m_Worker.joinable())
+			m_Worker.join();
+	}
+
+	void VulkanPipelineLibrary::Destroy()
+	{
+		StopWorker();
+
+		auto* ctx = VulkanContext::GetRaw();
+		VkDevice device = *ctx->GetDevice();
+
+		for (auto it = m_OwnedPipelines.rbegin(); it != m_OwnedPipelines.rend(); ++it)
+			vkDestroyPipeline(device, *it, nullptr);
+
+		m_OwnedPipelines.clear();
+		m_Parts.clear();
+		m_Linked.clear();
+	}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "VulkanAbstraction/Pipelines/VulkanPipeline.h"
+
+
+namespace VulkanEngine {
+
+	// VK_EXT_graphics_pipeline_library cache.
+	// The four pipeline parts are compiled once per unique state and reused; a new combination
+	// is fast-linked on first use and a link-time optimized version is swapped in from a worker thread.
+	class VulkanPipelineLibrary
+	{
+	public:
+		VulkanPipelineLibrary();
+		virtual ~VulkanPipelineLibrary() = default;
+		VulkanPipelineLibrary(const VulkanPipelineLibrary&)				= delete;
+		VulkanPipelineLibrary& operator=(const VulkanPipelineLibrary&)	= delete;
+
+		static bool IsSupported();
+
+		std::shared_ptr<VulkanPipeline> Link(const GraphicsPipelineDescription& desc, bool optimizeInBackground = true);
+
+		// Stops the optimization worker, must run before any pipeline layout or shader module is destroyed
+		void StopWorker();
+
+	private:
+		VkPipeline GetVertexInputPart(const GraphicsPipelineDescription& desc);
+		VkPipeline GetPreRasterizationPart(const GraphicsPipelineDescription& desc);
+		VkPipeline GetFragmentShaderPart(const GraphicsPipelineDescription& desc);
+		VkPipeline GetFragmentOutputPart(const GraphicsPipelineDescription& desc);
+
+		VkPipeline CreatePart(uint64_t key, VkGraphicsPipelineLibraryFlagsEXT part, VkGraphicsPipelineCreateInfo& createInfo);
+		VkPipeline LinkParts(const std::array<VkPipeline, 4>& parts, VkPipelineLayout layout, bool optimize);
+
+		void WorkerLoop();
+		void Destroy();
+
+	private:
+		struct OptimizeRequest
+		{
+			std::shared_ptr<VulkanPipeline> target;
+			std::array<VkPipeline, 4>		parts;
+			VkPipelineLayout				layout;
+		};
+
+		std::mutex										m_Mutex;
+		std::unordered_map<uint64_t, VkPipeline>		m_Parts;
+		std::unordered_map<uint64_t, std::shared_ptr<VulkanPipeline>> m_Linked;
+		std::vector<VkPipeline>							m_OwnedPipelines;
+
+		std::thread										m_Worker;
+		std::condition_variable							m_WorkerCondition;
+		std::vector<OptimizeRequest>					m_OptimizeQueue;
+		bool											m_StopWorker{ false };
+	};
+
+}
@@ -0,0 +1,240 @@
+#include "VulkanAbstraction/Pipelines/WorkgroupAutotuner.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "VulkanAbstraction/Core/VulkanContext.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	static constexpr uint32_t kBenchmarkDispatches	= 16;
+	static constexpr uint32_t kBenchmarkRepetitions	= 3;
+
+	static VkPhysicalDeviceProperties GetDeviceProperties()
+	{
+		auto* ctx = VulkanContext::GetRaw();
+
+		VkPhysicalDeviceProperties props;
+		vkGetPhysicalDeviceProperties(*ctx->GetPhysicalDevice(), &props);
+
+		return props;
+	}
+
+	// Serializes consecutive dispatches so each one is measured on its own
+	static void InsertComputeBarrier(VkCommandBuffer cmd)
+	{
+		VkMemoryBarrier2 barrier{
+			.sType			= VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+			.srcStageMask	= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			.srcAccessMask	= VK_ACCESS_2_SHADER_WRITE_BIT,
+			.dstStageMask	= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			.dstAccessMask	= VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT
+		};
+
+		VkDependencyInfo dependency{
+			.sType					= VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+			.memoryBarrierCount		= 1,
+			.pMemoryBarriers		= &barrier
+		};
+
+		vkCmdPipelineBarrier2(cmd, &dependency);
+	}
+
+	std::array<uint32_t, 3> WorkgroupAutotuner::Tune(const std::string& name, const VkPipelineBuilder& builder,
+		VkExtent3D extent, const BindCallback& bindResources)
+	{
+		const auto& shaders = builder.GetShaders();
+		auto shader = std::find_if(shaders.begin(), shaders.end(),
+			[](const std::shared_ptr<VulkanShader>& s) { return s->GetStage() == VK_SHADER_STAGE_COMPUTE_BIT; });
+
+		if (shader == shaders.end())
+		{
+			VulkanEngine_ERROR(fmt::runtime("Autotune '{}': no compute shader"), name);
+			return { 1, 1, 1 };
+		}
+
+		// Editing the shader invalidates its results
+		std::string key = fmt::format("{}|{}|{}|{}x{}x{}", GetDeviceKey(), name, HashUtils::ToHex((*shader)->GetHash()),
+			extent.width, extent.height, extent.depth);
+
+		{
+			std::lock_guard lock(s_Mutex);
+			LoadResults();
+
+			if (auto it = s_Results.find(key); it != s_Results.end())
+				return it->second;
+		}
+
+		if (!GetDeviceProperties().limits.timestampComputeAndGraphics)
+		{
+			VulkanEngine_WARN(fmt::runtime("Autotune '{}': no compute timestamps, keeping the default workgroup size"), name);
+			return builder.GetWorkgroupSize();
+		}
+
+		std::array<uint32_t, 3> bestSize = builder.GetWorkgroupSize();
+		double bestTime = std::numeric_limits<double>::max();
+
+		for (const auto& size : GetCandidates(extent))
+		{
+			VkPipelineBuilder candidate = builder;
+			candidate.SetWorkgroupSize(size);
+
+			double time = Benchmark(candidate, extent, bindResources);
+			VulkanEngine_DEBUG(fmt::runtime("Autotune '{}': {}x{}x{} -> {:.4f} ms"), name, size[0], size[1], size[2], time);
+
+			if (time < bestTime)
+			{
+				bestTime = time;
+				bestSize = size;
+			}
+		}
+
+		VulkanEngine_INFO(fmt::runtime("Autotune '{}': {}x{}x{} ({:.4f} ms)"), name, bestSize[0], bestSize[1], bestSize[2], bestTime);
+
+		std::lock_guard lock(s_Mutex);
+		s_Results[key] = bestSize;
+		SaveResults();
+
+		return bestSize;
+	}
+
+	std::vector<std::array<uint32_t, 3>> WorkgroupAutotuner::GetCandidates(VkExtent3D extent)
+	{
+		static const std::vector<std::array<uint32_t, 3>> s_Candidates2D = {
+			{ 8, 8, 1 }, { 16, 8, 1 }, { 8, 16, 1 }, { 16, 16, 1 }, { 32, 8, 1 }, { 8, 32, 1 },
+			{ 32, 16, 1 }, { 16, 32, 1 }, { 32, 32, 1 }, { 64, 4, 1 }, { 64, 8, 1 }
+		};
+		static const std::vector<std::array<uint32_t, 3>> s_Candidates1D = {
+			{ 32, 1, 1 }, { 64, 1, 1 }, { 128, 1, 1 }, { 256, 1, 1 }, { 512, 1, 1 }, { 1024, 1, 1 }
+		};
+
+		auto limits = GetDeviceProperties().limits;
+
+		std::vector<std::array<uint32_t, 3>> candidates;
+		for (const auto& size : extent.height > 1 ? s_Candidates2D : s_Candidates1D)
+		{
+			bool fits =
+				size[0] <= limits.maxComputeWorkGroupSize[0] &&
+				size[1] <= limits.maxComputeWorkGroupSize[1] &&
+				size[2] <= limits.maxComputeWorkGroupSize[2] &&
+				size[0] * size[1] * size[2] <= limits.maxComputeWorkGroupInvocations;
+
+			if (fits)
+				candidates.push_back(size);
+		}
+
+		return candidates;
+	}
+
+	double WorkgroupAutotuner::Benchmark(const VkPipelineBuilder& builder, VkExtent3D extent, const BindCallback& bindResources)
+	{
+		auto*		ctx		= VulkanContext::GetRaw();
+		VkDevice	device	= *ctx->GetDevice();
+
+		VkPipeline			pipeline	= builder.BuildUnmanaged(PipelineType::Compute);
+		VkPipelineLayout	layout		= builder.GetLayout();
+		VkExtent3D			groupCount	= VulkanUtils::GetGroupCount(extent, builder.GetWorkgroupSize());
+
+		VkQueryPoolCreateInfo queryPoolInfo{
+			.sType		= VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+			.queryType	= VK_QUERY_TYPE_TIMESTAMP,
+			.queryCount = 2
+		};
+
+		VkQueryPool queryPool{ VK_NULL_HANDLE };
+		CHECK_VK_RES(vkCreateQueryPool(device, &queryPoolInfo, nullptr, &queryPool));
+
+		double timestampPeriod	= GetDeviceProperties().limits.timestampPeriod;
+		double bestTime			= std::numeric_limits<double>::max();
+
+		for (uint32_t repetition = 0; repetition < kBenchmarkRepetitions; ++repetition)
+		{
+			VulkanRenderer::ImmediateSubmit([&](VkCommandBuffer cmd)
+				{
+					vkCmdResetQueryPool(cmd, queryPool, 0, 2);
+					vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+					bindResources(cmd, layout);
+
+					// Warm up caches and clocks
+					vkCmdDispatch(cmd, groupCount.width, groupCount.height, groupCount.depth);
+					InsertComputeBarrier(cmd);
+
+					vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, queryPool, 0);
+					for (uint32_t i = 0; i < kBenchmarkDispatches; ++i)
+					{
+						vkCmdDispatch(cmd, groupCount.width, groupCount.height, groupCount.depth);
+						InsertComputeBarrier(cmd);
+					}
+					vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, queryPool, 1);
+				});
+
+			std::array<uint64_t, 2> timestamps{};
+			CHECK_VK_RES(vkGetQueryPoolResults(device, queryPool, 0, 2, sizeof(timestamps), timestamps.data(),
+				sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT));
+
+			double milliseconds = static_cast<double>(timestamps[1] - timestamps[0]) * timestampPeriod / 1e6;
+			bestTime = std::min(bestTime, milliseconds / kBenchmarkDispatches);
+		}
+
+		vkDestroyQueryPool(device, queryPool, nullptr);
+		vkDestroyPipeline(device, pipeline, nullptr);
+
+		return bestTime;
+	}
+
+	// ===========================================================================
+	// Results file
+	// ===========================================================================
+
+	std::string WorkgroupAutotuner::GetDeviceKey()
+	{
+		auto props = GetDeviceProperties();
+		return fmt::format("{:04x}-{:04x}-{:08x}", props.vendorID, props.deviceID, props.driverVersion);
+	}
+
+	std::filesystem::path WorkgroupAutotuner::GetResultsPath()
+	{
+		return std::filesystem::current_path() / "Cache" / "Autotune.txt";
+	}
+
+	void WorkgroupAutotuner::LoadResults()
+	{
+		if (s_ResultsLoaded) return;
+		s_ResultsLoaded = true;
+
+		std::ifstream resultsFile(GetResultsPath());
+		if (!resultsFile.is_open()) return;
+
+		// One "<device|name|shader|extent> TAB <x> <y> <z>" line per result
+		std::string line;
+		while (std::getline(resultsFile, line))
+		{
+			std::istringstream entryStream(line);
+			std::string key;
+			std::array<uint32_t, 3> size{};
+
+			if (std::getline(entryStream, key, '\t') && (entryStream >> size[0] >> size[1] >> size[2]))
+				s_Results[key] = size;
+		}
+	}
+
+	void WorkgroupAutotuner::SaveResults()
+	{
+		std::filesystem::create_directories(GetResultsPath().parent_path());
+
+		auto tempPath = GetResultsPath();
+		tempPath += ".tmp";
+
+		{
+			std::ofstream resultsFile(tempPath, std::ios::trunc);
+			if (!resultsFile.is_open()) return;
+
+			for (const auto& [key, size] : s_Results)
+				resultsFile << key << '\t' << size[0] << ' ' << size[1] << ' ' << size[2] << "\n";
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, GetResultsPath(), ec);
+	}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "VulkanAbstraction/Pipelines/VkPipelineBuilder.h"
+
+
+namespace VulkanEngine {
+
+	// Picks the fastest workgroup size of a compute pipeline on the current device.
+	// Candidates are timed with GPU timestamps over a fixed extent; winners are stored per
+	// device, driver, shader binary and extent in Cache/Autotune.txt so each GPU benchmarks once.
+	class WorkgroupAutotuner
+	{
+	public:
+		WorkgroupAutotuner()	= delete;
+		~WorkgroupAutotuner()	= delete;
+
+		// Binds everything the dispatch needs except the pipeline
+		using BindCallback = std::function<void(VkCommandBuffer cmd, VkPipelineLayout layout)>;
+
+		// The compute shader must declare local_size_*_id matching WORKGROUP_SIZE_*_ID.
+		// Falls back to the builder's size when the device has no compute timestamps.
+		static std::array<uint32_t, 3> Tune(const std::string& name, const VkPipelineBuilder& builder,
+			VkExtent3D extent, const BindCallback& bindResources);
+
+	private:
+		static std::vector<std::array<uint32_t, 3>> GetCandidates(VkExtent3D extent);
+		static double Benchmark(const VkPipelineBuilder& builder, VkExtent3D extent, const BindCallback& bindResources);
+
+		static std::string				GetDeviceKey();
+		static std::filesystem::path	GetResultsPath();
+		static void LoadResults();
+		static void SaveResults();
+
+	private:
+		static inline std::mutex											s_Mutex;
+		static inline bool													s_ResultsLoaded = false;
+		static inline std::unordered_map<std::string, std::array<uint32_t, 3>>	s_Results;
+	};
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace VulkanEngine {
+
+	// Index into a ResourcePool plus the generation the slot had when the handle was made.
+	// A slot's generation changes when its resource is removed, older handles then read as stale.
+	template<typename Tag>
+	struct ResourceHandle
+	{
+		uint32_t index{ 0 };
+		uint32_t generation{ 0 }; // odd while alive, 0 never refers to anything
+
+		bool IsValid() const { return generation != 0; }
+		explicit operator bool() const { return IsValid(); }
+
+		bool operator==(const ResourceHandle&) const = default;
+	};
+
+	struct ShaderTag;
+	struct PipelineTag;
+	struct ImageTag;
+	struct BufferTag;
+	struct DescriptorSetTag;
+
+	using ShaderHandle			= ResourceHandle<ShaderTag>;
+	using PipelineHandle		= ResourceHandle<PipelineTag>;
+	using ImageHandle			= ResourceHandle<ImageTag>;
+	using BufferHandle			= ResourceHandle<BufferTag>;
+	using DescriptorSetHandle	= ResourceHandle<DescriptorSetTag>;
+
+}
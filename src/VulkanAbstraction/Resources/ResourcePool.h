@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "VulkanAbstraction/Resources/ResourceHandle.h"
+
+
+namespace VulkanEngine {
+
+	// Fixed capacity slots in one contiguous array, reused through a free list. Slots never move, so a
+	// lookup is an index and a generation compare, and the pool can be read without a lock while another
+	// thread adds to it. Generations are atomic: a stale handle reads as stale from any thread, even while
+	// its slot is freed or reused, without touching the value. Not synchronized otherwise: the owner
+	// serializes Add and Remove, and a handle's value is only read until its Remove.
+	template<typename T, typename Tag>
+	class ResourcePool
+	{
+	public:
+		using Handle = ResourceHandle<Tag>;
+
+		explicit ResourcePool(uint32_t capacity)
+			: m_Slots(capacity)
+		{
+			// Low indices first
+			m_FreeSlots.reserve(capacity);
+			for (uint32_t i = capacity; i > 0; --i)
+				m_FreeSlots.push_back(i - 1);
+		}
+
+		ResourcePool(const ResourcePool&)				= delete;
+		ResourcePool& operator=(const ResourcePool&)	= delete;
+
+		// Invalid when the pool is full
+		Handle Add(T value)
+		{
+			if (m_FreeSlots.empty())
+				return {};
+
+			uint32_t index = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+
+			Slot& slot = m_Slots[index];
+			slot.value = std::move(value);
+
+			// Released with the value, a reader that sees the generation sees the value
+			uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+			slot.generation.store(generation, std::memory_order_release);
+			m_Count++;
+
+			return { index, generation };
+		}
+
+		// The value, or nullopt for a stale handle
+		std::optional<T> Remove(Handle handle)
+		{
+			if (!IsAlive(handle))
+				return std::nullopt;
+
+			Slot& slot = m_Slots[handle.index];
+
+			// Stale before the value goes, a reader checking the handle from now on never reaches it
+			slot.generation.store(handle.generation + 1, std::memory_order_release);
+
+			std::optional<T> value = std::move(slot.value);
+			slot.value.reset();
+			m_Count--;
+			m_FreeSlots.push_back(handle.index);
+
+			return value;
+		}
+
+		// Every live slot, their handles read as stale afterwards
+		void Clear()
+		{
+			for (uint32_t i = 0; i < m_Slots.size(); ++i)
+			{
+				Slot& slot = m_Slots[i];
+				if (!slot.value)
+					continue;
+
+				slot.generation.fetch_add(1, std::memory_order_release);
+				slot.value.reset();
+				m_FreeSlots.push_back(i);
+			}
+
+			m_Count = 0;
+		}
+
+		bool IsAlive(Handle handle) const
+		{
+			return handle.index < m_Slots.size() && handle.generation != 0 &&
+				m_Slots[handle.index].generation.load(std::memory_order_acquire) == handle.generation;
+		}
+
+		// nullptr for a stale handle
+		T* Get(Handle handle)
+		{
+			return IsAlive(handle) ? &*m_Slots[handle.index].value : nullptr;
+		}
+
+		const T* Get(Handle handle) const
+		{
+			return IsAlive(handle) ? &*m_Slots[handle.index].value : nullptr;
+		}
+
+		// function(handle, value) over the live slots, in slot order
+		template<typename F>
+		void ForEach(F&& function)
+		{
+			for (uint32_t i = 0; i < m_Slots.size(); ++i)
+			{
+				Slot& slot = m_Slots[i];
+				if (slot.value)
+					function(Handle{ i, slot.generation.load(std::memory_order_relaxed) }, *slot.value);
+			}
+		}
+
+		uint32_t GetCount()		const { return m_Count; }
+		uint32_t GetCapacity()	const { return static_cast<uint32_t>(m_Slots.size()); }
+
+	private:
+		struct Slot
+		{
+			std::optional<T>		value;
+			std::atomic<uint32_t>	generation{ 0 };
+		};
+
+	private:
+		std::vector<Slot>		m_Slots;
+		std::vector<uint32_t>	m_FreeSlots;
+		uint32_t				m_Count{ 0 };
+	};
+
+}
@@ -0,0 +1,195 @@
+#include "VulkanAbstraction/Resources/ResourceRegistry.h"
+#include "VulkanAbstraction/Shaders/VulkanShader.h"
+#include "VulkanAbstraction/DeletionQueue.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "Core/LogSystem.h"
+
+#include <algorithm>
+#include <utility>
+
+
+namespace VulkanEngine {
+
+	template<typename Handle>
+	static Handle CheckAdded(Handle handle, const char* poolName)
+	{
+		if (!handle)
+			VulkanEngine_ERROR(fmt::runtime("Resource registry: {} pool is full"), poolName);
+
+		return handle;
+	}
+
+	ResourceRegistry::ResourceRegistry(const ResourceRegistrySpecification& spec, DeletionQueue& deletionQueue)
+		: m_DeletionQueue(deletionQueue),
+		m_Shaders(spec.maxShaders),
+		m_Pipelines(spec.maxPipelines),
+		m_Images(spec.maxImages),
+		m_Buffers(spec.maxBuffers),
+		m_DescriptorSets(spec.maxDescriptorSets)
+	{
+	}
+
+	ShaderHandle ResourceRegistry::AddShader(std::shared_ptr<VulkanShader> shader)
+	{
+		std::lock_guard lock(m_Mutex);
+		return CheckAdded(m_Shaders.Add(std::move(shader)), "shader");
+	}
+
+	PipelineHandle ResourceRegistry::AddPipeline(const PipelineResource& pipeline)
+	{
+		std::lock_guard lock(m_Mutex);
+		return CheckAdded(m_Pipelines.Add(pipeline), "pipeline");
+	}
+
+	ImageHandle ResourceRegistry::AddImage(const AllocatedImage& image)
+	{
+		std::lock_guard lock(m_Mutex);
+		return CheckAdded(m_Images.Add(image), "image");
+	}
+
+	BufferHandle ResourceRegistry::AddBuffer(const AllocatedBuffer& buffer)
+	{
+		std::lock_guard lock(m_Mutex);
+		return CheckAdded(m_Buffers.Add(buffer), "buffer");
+	}
+
+	DescriptorSetHandle ResourceRegistry::AddDescriptorSet(VkDescriptorSet set)
+	{
+		std::lock_guard lock(m_Mutex);
+		return CheckAdded(m_DescriptorSets.Add(set), "descriptor set");
+	}
+
+	std::shared_ptr<VulkanShader> ResourceRegistry::GetShader(ShaderHandle handle) const
+	{
+		std::lock_guard lock(m_Mutex);
+
+		const std::shared_ptr<VulkanShader>* shader = m_Shaders.Get(handle);
+		return shader ? *shader : nullptr;
+	}
+
+	bool ResourceRegistry::IsAlive(ShaderHandle handle) const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Shaders.IsAlive(handle);
+	}
+
+	void ResourceRegistry::Remove(ShaderHandle handle)			{ Retire(handle); }
+	void ResourceRegistry::Remove(PipelineHandle handle)		{ Retire(handle); }
+	void ResourceRegistry::Remove(ImageHandle handle)			{ Retire(handle); }
+	void ResourceRegistry::Remove(BufferHandle handle)			{ Retire(handle); }
+	void ResourceRegistry::Remove(DescriptorSetHandle handle)	{ Retire(handle); }
+
+	VkPipeline ResourceRegistry::RebindPipeline(PipelineHandle handle, VkPipeline pipeline)
+	{
+		std::lock_guard lock(m_Mutex);
+
+		PipelineResource* resource = m_Pipelines.Get(handle);
+		if (!resource)
+			return pipeline; // removed meanwhile, the rebuild goes to the deletion queue instead
+
+		return std::exchange(resource->pipeline, pipeline);
+	}
+
+	void ResourceRegistry::RebindShader(const std::shared_ptr<VulkanShader>& previous, std::shared_ptr<VulkanShader> reloaded)
+	{
+		std::lock_guard lock(m_Mutex);
+
+		m_Shaders.ForEach([&](ShaderHandle, std::shared_ptr<VulkanShader>& shader)
+			{
+				if (shader == previous)
+					shader = reloaded;
+			});
+	}
+
+	void ResourceRegistry::Collect(uint64_t completedValue)
+	{
+		std::lock_guard lock(m_Mutex);
+
+		auto retired = std::find_if(m_Retired.begin(), m_Retired.end(),
+			[completedValue](const RetiredHandle& retired)
+			{
+				return retired.retireValue > completedValue;
+			});
+
+		for (auto it = m_Retired.begin(); it != retired; ++it)
+			Free(it->handle);
+
+		m_Retired.erase(m_Retired.begin(), retired);
+	}
+
+	void ResourceRegistry::Flush()
+	{
+		std::lock_guard lock(m_Mutex);
+
+		VkDevice		device		= *VulkanContext::GetRaw()->GetDevice();
+		VmaAllocator	allocator	= VulkanRenderer::GetAllocator().GetRaw();
+
+		m_Pipelines.ForEach([device](PipelineHandle, PipelineResource& pipeline)
+			{
+				vkDestroyPipeline(device, pipeline.pipeline, nullptr);
+			});
+
+		m_Images.ForEach([device, allocator](ImageHandle, AllocatedImage& image)
+			{
+				vkDestroyImageView(device, image.imageView, nullptr);
+				vmaDestroyImage(allocator, image.image, image.allocation);
+			});
+
+		m_Buffers.ForEach([allocator](BufferHandle, AllocatedBuffer& buffer)
+			{
+				vmaDestroyBuffer(allocator, buffer.buffer, buffer.allocation);
+			});
+
+		m_Shaders.Clear();
+		m_Pipelines.Clear();
+		m_Images.Clear();
+		m_Buffers.Clear();
+		m_DescriptorSets.Clear();
+
+		m_Retired.clear();
+	}
+
+	void ResourceRegistry::Retire(AnyHandle handle)
+	{
+		std::lock_guard lock(m_Mutex);
+
+		// Stays readable for the frames in flight and the ones queued for the render thread
+		m_Retired.push_back({ m_DeletionQueue.GetRetireValue(), handle });
+	}
+
+	void ResourceRegistry::Free(const AnyHandle& handle)
+	{
+		VkDevice		device		= *VulkanContext::GetRaw()->GetDevice();
+		VmaAllocator	allocator	= VulkanRenderer::GetAllocator().GetRaw();
+
+		// The GPU is done with it, destroyed right away
+		if (auto* pipelineHandle = std::get_if<PipelineHandle>(&handle))
+		{
+			if (auto pipeline = m_Pipelines.Remove(*pipelineHandle))
+				vkDestroyPipeline(device, pipeline->pipeline, nullptr);
+		}
+		else if (auto* imageHandle = std::get_if<ImageHandle>(&handle))
+		{
+			if (auto image = m_Images.Remove(*imageHandle))
+			{
+				vkDestroyImageView(device, image->imageView, nullptr);
+				vmaDestroyImage(allocator, image->image, image->allocation);
+			}
+		}
+		else if (auto* bufferHandle = std::get_if<BufferHandle>(&handle))
+		{
+			if (auto buffer = m_Buffers.Remove(*bufferHandle))
+				vmaDestroyBuffer(allocator, buffer->buffer, buffer->allocation);
+		}
+		else if (auto* shaderHandle = std::get_if<ShaderHandle>(&handle))
+		{
+			// The module goes to the deletion queue with the shader's last reference
+			m_Shaders.Remove(*shaderHandle);
+		}
+		else if (auto* setHandle = std::get_if<DescriptorSetHandle>(&handle))
+		{
+			m_DescriptorSets.Remove(*setHandle);
+		}
+	}
+
+}
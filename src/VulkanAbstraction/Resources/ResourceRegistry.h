@@ -0,0 +1,125 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <variant>
+#include <vector>
+
+#include "VulkanAbstraction/Resources/ResourceHandle.h"
+#include "VulkanAbstraction/Resources/ResourcePool.h"
+#include "VulkanAbstraction/VulkanTypes.h"
+
+
+namespace VulkanEngine {
+
+	class DeletionQueue;
+	class VulkanShader;
+
+	struct ResourceRegistrySpecification
+	{
+		uint32_t maxShaders			= 1024;
+		uint32_t maxPipelines		= 1024;
+		uint32_t maxImages			= 4096;
+		uint32_t maxBuffers			= 4096;
+		uint32_t maxDescriptorSets	= 4096;
+	};
+
+	struct PipelineResource
+	{
+		VkPipeline				pipeline{ VK_NULL_HANDLE };
+		VkPipelineBindPoint		bindPoint{ VK_PIPELINE_BIND_POINT_GRAPHICS };
+		std::array<uint32_t, 3> workgroupSize{ 1, 1, 1 }; // compute only
+	};
+
+	// Generational handles for shaders, pipelines, images, buffers and descriptor sets, in fixed capacity
+	// pools. Pipeline, image, buffer and descriptor set lookups take no lock and touch no reference count,
+	// the render path resolves a handle to its Vulkan object with an index and a generation compare.
+	// Add and Remove may come from any thread. A handle's value is only used after its Add and until its
+	// Remove has retired, but checking a handle (IsAlive, a stale Get) is safe from any thread at any time,
+	// even while its slot is freed or reused. Added pipelines, images and buffers are owned by the registry:
+	// Remove destroys them once the GPU has retired every frame that may use them, the handle reads as stale
+	// from then on.
+	// Hot reload rebinds pipeline and shader handles in place, holders of the handle see the new version.
+	class ResourceRegistry
+	{
+	public:
+		ResourceRegistry(const ResourceRegistrySpecification& spec, DeletionQueue& deletionQueue);
+		virtual ~ResourceRegistry() = default;
+		ResourceRegistry(const ResourceRegistry&)				= delete;
+		ResourceRegistry& operator=(const ResourceRegistry&)	= delete;
+
+		// Invalid handles when a pool is full
+		ShaderHandle		AddShader(std::shared_ptr<VulkanShader> shader);
+		PipelineHandle		AddPipeline(const PipelineResource& pipeline);
+		ImageHandle			AddImage(const AllocatedImage& image);		// VulkanRenderer::CreateUnmanagedImage
+		BufferHandle		AddBuffer(const AllocatedBuffer& buffer);	// VulkanRenderer::CreateUnmanagedBuffer
+		DescriptorSetHandle AddDescriptorSet(VkDescriptorSet set);		// freed with its pool
+
+		// Shaders are build-time data and locked, nullptr when stale
+		std::shared_ptr<VulkanShader> GetShader(ShaderHandle handle) const;
+
+		// nullptr or VK_NULL_HANDLE when stale
+		const PipelineResource* GetPipeline(PipelineHandle handle) const	{ return m_Pipelines.Get(handle); }
+		AllocatedImage*			GetImage(ImageHandle handle)				{ return m_Images.Get(handle); }
+		AllocatedBuffer*		GetBuffer(BufferHandle handle)				{ return m_Buffers.Get(handle); }
+		VkDescriptorSet			GetDescriptorSet(DescriptorSetHandle handle) const
+		{
+			const VkDescriptorSet* set = m_DescriptorSets.Get(handle);
+			return set ? *set : VK_NULL_HANDLE;
+		}
+
+		bool IsAlive(ShaderHandle handle) const;
+		bool IsAlive(PipelineHandle handle)			const { return m_Pipelines.IsAlive(handle); }
+		bool IsAlive(ImageHandle handle)			const { return m_Images.IsAlive(handle); }
+		bool IsAlive(BufferHandle handle)			const { return m_Buffers.IsAlive(handle); }
+		bool IsAlive(DescriptorSetHandle handle)	const { return m_DescriptorSets.IsAlive(handle); }
+
+		void Remove(ShaderHandle handle);
+		void Remove(PipelineHandle handle);
+		void Remove(ImageHandle handle);
+		void Remove(BufferHandle handle);
+		void Remove(DescriptorSetHandle handle);
+
+		// On the recording thread between frames (ShaderHotReloader::OnFrameBoundary), returns the replaced
+		// pipeline for the deletion queue
+		VkPipeline RebindPipeline(PipelineHandle handle, VkPipeline pipeline);
+
+		// Every handle to previous now resolves to reloaded
+		void RebindShader(const std::shared_ptr<VulkanShader>& previous, std::shared_ptr<VulkanShader> reloaded);
+
+		// Frees what the timeline has reached, after DeletionQueue::Collect
+		void Collect(uint64_t completedValue);
+
+		// Destroys everything, once the device is idle. Shaders are dropped, their modules go to the deletion
+		// queue, which is flushed after this.
+		void Flush();
+
+	private:
+		using AnyHandle = std::variant<ShaderHandle, PipelineHandle, ImageHandle, BufferHandle, DescriptorSetHandle>;
+
+		struct RetiredHandle
+		{
+			uint64_t	retireValue{ 0 };
+			AnyHandle	handle;
+		};
+
+		void Retire(AnyHandle handle);
+		void Free(const AnyHandle& handle);
+
+	private:
+		DeletionQueue&											m_DeletionQueue;
+
+		mutable std::mutex										m_Mutex; // Add, Remove, shaders
+		ResourcePool<std::shared_ptr<VulkanShader>, ShaderTag>	m_Shaders;
+		ResourcePool<PipelineResource, PipelineTag>				m_Pipelines;
+		ResourcePool<AllocatedImage, ImageTag>					m_Images;
+		ResourcePool<AllocatedBuffer, BufferTag>				m_Buffers;
+		ResourcePool<VkDescriptorSet, DescriptorSetTag>			m_DescriptorSets;
+
+		std::vector<RetiredHandle>								m_Retired; // retire values never decrease
+	};
+
+}
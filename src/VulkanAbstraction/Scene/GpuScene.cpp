@@ -0,0 +1,428 @@
+#include "VulkanAbstraction/Scene/GpuScene.h"
+#include "VulkanAbstraction/Scene/HiZPyramid.h"
+#include "VulkanAbstraction/Pipelines/VkPipelineBuilder.h"
+#include "VulkanAbstraction/Pipelines/VulkanLayoutCache.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+#include <algorithm>
+
+
+namespace VulkanEngine {
+
+	// Objects and meshes are read by culling and by the draws, task and mesh stages only exist with VK_EXT_mesh_shader
+	static VkPipelineStageFlags2 GetSceneReadStages()
+	{
+		VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT;
+
+		if (VulkanRenderer::IsMeshShadingSupported())
+			stages |= VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT;
+
+		return stages;
+	}
+
+	GpuScene::GpuScene(uint32_t maxObjects, uint32_t maxMeshes, HiZPyramid& pyramid, const std::filesystem::path& cullShaderPath)
+		: m_MaxObjects(maxObjects), m_MaxMeshes(maxMeshes), m_Pyramid(&pyramid)
+	{
+		VkBufferUsageFlags storageUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		VmaAllocationCreateFlags hostFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+		m_ObjectBuffer		= VulkanRenderer::CreateBuffer(sizeof(GpuObject) * VkDeviceSize(maxObjects), storageUsage);
+		m_MeshBuffer		= VulkanRenderer::CreateBuffer(sizeof(GpuMesh) * VkDeviceSize(maxMeshes), storageUsage);
+		m_CullDataBuffer	= VulkanRenderer::CreateBuffer(sizeof(GpuCullData) * FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VMA_MEMORY_USAGE_AUTO, hostFlags);
+
+		// A frame only overwrites its own staging buffer, the other one may still be copied from
+		for (auto& staging : m_StagingBuffers)
+		{
+			staging = VulkanRenderer::CreateBuffer(m_ObjectBuffer.size + m_MeshBuffer.size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VMA_MEMORY_USAGE_AUTO, hostFlags);
+		}
+
+		m_DrawArguments = std::make_unique<IndirectArgumentBuffer>(maxObjects, static_cast<uint32_t>(sizeof(VkDrawIndexedIndirectCommand)));
+
+		if (VulkanRenderer::IsMeshShadingSupported())
+			m_TaskArguments = std::make_unique<IndirectArgumentBuffer>(maxObjects, static_cast<uint32_t>(sizeof(GpuTaskCommand)));
+
+		m_Objects.reserve(maxObjects);
+		m_Meshes.reserve(maxMeshes);
+		m_ObjectDirtyFlags.resize(maxObjects, 0);
+
+		// Cull pipeline
+		auto shader = std::make_shared<VulkanShader>(cullShaderPath);
+		ReflectedLayout layout = VulkanLayoutCache::GetLayout({ shader });
+
+		VkPipelineBuilder builder;
+		builder.AddPipelineShader(shader);
+
+		m_SetAllocator	= std::make_shared<VulkanDescriptorSetAllocator>(1, layout.GetPoolSizes(0));
+		m_Set			= m_SetAllocator->Allocate(layout.setLayouts[0]);
+		m_Set->WriteSampledImage(pyramid.GetView(), pyramid.GetSampler(), VK_IMAGE_LAYOUT_GENERAL, 0);
+
+		ComputePass cullPass{
+			.name		= "GpuCull",
+			.pipeline	= builder.BuildReloadable(PipelineType::Compute),
+			.layout		= layout.pipelineLayout,
+			.bind		= [this](VkCommandBuffer cmd, VkPipelineLayout pipelineLayout)
+				{
+					VkDescriptorSet set = m_Set->GetRaw();
+					vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &set, 0, nullptr);
+					vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GpuCullConstants), &m_CullConstants);
+				},
+			.reads		= { &m_ObjectBuffer, &m_MeshBuffer },
+			.arguments	= { m_DrawArguments.get() }
+		};
+
+		if (m_TaskArguments)
+			cullPass.arguments.push_back(m_TaskArguments.get());
+
+		m_CullSequence.AddPass(std::move(cullPass));
+	}
+
+	uint32_t GpuScene::AddMesh(uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset, const glm::vec4& localSphere)
+	{
+		Submesh submesh{
+			.vertexOffset	= vertexOffset,
+			.boundingSphere = localSphere,
+			.lodCount		= 1
+		};
+		submesh.lods[0] = { .firstIndex = firstIndex, .indexCount = indexCount };
+
+		return AddMesh(submesh);
+	}
+
+	uint32_t GpuScene::AddMesh(const Submesh& submesh)
+	{
+		if (m_Meshes.size() >= m_MaxMeshes)
+		{
+			VulkanEngine_ERROR(fmt::runtime("GpuScene: mesh capacity ({}) exceeded"), m_MaxMeshes);
+			return kInvalidIndex;
+		}
+
+		GpuMesh mesh{
+			.lodCount		= std::clamp(submesh.lodCount, 1u, kMaxMeshLods),
+			.vertexOffset	= submesh.vertexOffset,
+			.firstMeshlet	= submesh.firstMeshlet,
+			.meshletCount	= submesh.meshletCount
+		};
+
+		for (uint32_t lod = 0; lod < mesh.lodCount; ++lod)
+		{
+			mesh.lods[lod] = {
+				.indexCount = submesh.lods[lod].indexCount,
+				.firstIndex = submesh.lods[lod].firstIndex,
+				.error		= submesh.lods[lod].error
+			};
+		}
+
+		m_Meshes.push_back(mesh);
+		m_MeshSpheres.push_back(submesh.boundingSphere);
+
+		return static_cast<uint32_t>(m_Meshes.size() - 1);
+	}
+
+	uint32_t GpuScene::AddObject(uint32_t mesh, const glm::mat4& transform)
+	{
+		if (m_Objects.size() >= m_MaxObjects)
+		{
+			VulkanEngine_ERROR(fmt::runtime("GpuScene: object capacity ({}) exceeded"), m_MaxObjects);
+			return kInvalidIndex;
+		}
+
+		if (mesh >= m_Meshes.size())
+		{
+			VulkanEngine_ERROR(fmt::runtime("GpuScene: object added for unknown mesh {}"), mesh);
+			return kInvalidIndex;
+		}
+
+		m_Objects.push_back({ .transform = transform, .meshIndex = mesh });
+
+		uint32_t object = static_cast<uint32_t>(m_Objects.size() - 1);
+		UpdateBoundingSphere(object);
+
+		return object;
+	}
+
+	void GpuScene::SetTransform(uint32_t object, const glm::mat4& transform)
+	{
+		if (object >= m_Objects.size())
+		{
+			VulkanEngine_ERROR(fmt::runtime("GpuScene: transform set on unknown object {}"), object);
+			return;
+		}
+
+		m_Objects[object].transform = transform;
+		UpdateBoundingSphere(object);
+	}
+
+	uint32_t GpuScene::AddMeshData(const MeshData& meshData, const glm::mat4& transform)
+	{
+		uint32_t firstMesh = GetMeshCount();
+
+		// All or nothing, nodes index the submeshes relative to the first one
+		if (meshData.submeshes.size() > m_MaxMeshes - m_Meshes.size())
+		{
+			VulkanEngine_ERROR(fmt::runtime("GpuScene: mesh capacity ({}) exceeded"), m_MaxMeshes);
+			return kInvalidIndex;
+		}
+
+		for (const auto& submesh : meshData.submeshes)
+			AddMesh(submesh);
+
+		for (const auto& node : meshData.nodes)
+			AddObject(firstMesh + node.submesh, transform * node.transform);
+
+		return firstMesh;
+	}
+
+	void GpuScene::SetGeometry(AllocatedBuffer* vertexBuffer, AllocatedBuffer* indexBuffer)
+	{
+		m_VertexBuffer	= vertexBuffer;
+		m_IndexBuffer	= indexBuffer;
+	}
+
+	void GpuScene::SetGeometry(MeshBuffers& buffers)
+	{
+		SetGeometry(&buffers.vertexBuffer, &buffers.indexBuffer);
+
+		bool meshlets = buffers.HasMeshlets();
+		m_MeshletBuffer			= meshlets ? &buffers.meshletBuffer			: nullptr;
+		m_MeshletVertexBuffer	= meshlets ? &buffers.meshletVertexBuffer	: nullptr;
+		m_MeshletTriangleBuffer = meshlets ? &buffers.meshletTriangleBuffer : nullptr;
+	}
+
+	void GpuScene::UpdateBoundingSphere(uint32_t object)
+	{
+		GpuObject& gpuObject = m_Objects[object];
+		const glm::vec4& localSphere = m_MeshSpheres[gpuObject.meshIndex];
+
+		// Largest axis scale keeps the sphere conservative under non-uniform scaling
+		float scale = std::max({
+			glm::length(glm::vec3(gpuObject.transform[0])),
+			glm::length(glm::vec3(gpuObject.transform[1])),
+			glm::length(glm::vec3(gpuObject.transform[2])) });
+
+		glm::vec3 center = glm::vec3(gpuObject.transform * glm::vec4(glm::vec3(localSphere), 1.0f));
+		gpuObject.boundingSphere	= glm::vec4(center, localSphere.w * scale);
+		gpuObject.scale				= scale;
+
+		MarkDirty(object);
+	}
+
+	void GpuScene::MarkDirty(uint32_t object)
+	{
+		if (m_ObjectDirtyFlags[object])
+			return;
+
+		m_ObjectDirtyFlags[object] = 1;
+		m_DirtyObjects.push_back(object);
+	}
+
+	void GpuScene::Upload(VkCommandBuffer cmd)
+	{
+		uint32_t meshCount = GetMeshCount();
+		if (m_DirtyObjects.empty() && m_UploadedMeshCount == meshCount)
+			return;
+
+		AllocatedBuffer& staging = m_StagingBuffers[VulkanRenderer::GetFrameNumber() % FRAMES_IN_FLIGHT];
+		auto* mapped = static_cast<std::byte*>(staging.mapped);
+		VkPipelineStageFlags2 readStages = GetSceneReadStages();
+
+		// Packed into staging one after the other, never more than both buffers
+		VkDeviceSize stagingSize = 0;
+
+		auto copy = [&](AllocatedBuffer& destination, size_t firstRegion, size_t lastRegion)
+			{
+				uint32_t regionCount = static_cast<uint32_t>(lastRegion - firstRegion);
+				if (regionCount == 0)
+					return;
+
+				VulkanUtils::InsertBufferMemoryBarrier(cmd, destination.buffer, destination.bufferState,
+					VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+				vkCmdCopyBuffer(cmd, staging.buffer, destination.buffer, regionCount, m_CopyRegions.data() + firstRegion);
+
+				VulkanUtils::InsertBufferMemoryBarrier(cmd, destination.buffer, destination.bufferState,
+					readStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+			};
+
+		auto stage = [&](const void* data, VkDeviceSize size, VkDeviceSize dstOffset)
+			{
+				std::memcpy(mapped + stagingSize, data, size);
+				m_CopyRegions.push_back({ .srcOffset = stagingSize, .dstOffset = dstOffset, .size = size });
+				stagingSize += size;
+			};
+
+		m_CopyRegions.clear();
+
+		// Changed objects in index order, neighbours coalesced into one region
+		std::sort(m_DirtyObjects.begin(), m_DirtyObjects.end());
+		for (size_t i = 0; i < m_DirtyObjects.size();)
+		{
+			uint32_t first	= m_DirtyObjects[i];
+			uint32_t last	= first + 1;
+			while (++i < m_DirtyObjects.size() && m_DirtyObjects[i] == last)
+				++last;
+
+			stage(&m_Objects[first], (last - first) * sizeof(GpuObject), first * sizeof(GpuObject));
+		}
+
+		for (uint32_t object : m_DirtyObjects)
+			m_ObjectDirtyFlags[object] = 0;
+		m_DirtyObjects.clear();
+
+		size_t meshRegion = m_CopyRegions.size();
+		if (m_UploadedMeshCount < meshCount)
+		{
+			stage(&m_Meshes[m_UploadedMeshCount], (meshCount - m_UploadedMeshCount) * sizeof(GpuMesh),
+				m_UploadedMeshCount * sizeof(GpuMesh));
+			m_UploadedMeshCount = meshCount;
+		}
+
+		vmaFlushAllocation(VulkanRenderer::GetAllocator().GetRaw(), staging.allocation, 0, stagingSize);
+
+		copy(m_ObjectBuffer, 0, meshRegion);
+		copy(m_MeshBuffer, meshRegion, m_CopyRegions.size());
+	}
+
+	void GpuScene::Cull(VkCommandBuffer cmd, const glm::mat4& viewProj, const LodSelection& lodSelection, bool occlusion)
+	{
+		uint32_t frameIndex = static_cast<uint32_t>(VulkanRenderer::GetFrameNumber() % FRAMES_IN_FLIGHT);
+		VkDeviceSize cullOffset = sizeof(GpuCullData) * frameIndex;
+
+		GpuCullData cullData{
+			.occlusionViewProj	= m_Pyramid->GetViewProj(),
+			.pyramidSize		= { m_Pyramid->GetExtent().width, m_Pyramid->GetExtent().height },
+			.pyramidMipCount	= m_Pyramid->GetMipCount(),
+			.occlusionEnabled	= occlusion && m_Pyramid->IsValid() ? 1u : 0u,
+			.cameraPosition		= lodSelection.cameraPosition,
+			.lodDistanceFactor	= lodSelection.GetDistanceFactor(),
+			.viewProj			= viewProj
+		};
+
+		auto planes = ExtractFrustumPlanes(viewProj);
+		std::copy(planes.begin(), planes.end(), cullData.frustumPlanes);
+
+		std::memcpy(static_cast<std::byte*>(m_CullDataBuffer.mapped) + cullOffset, &cullData, sizeof(cullData));
+		vmaFlushAllocation(VulkanRenderer::GetAllocator().GetRaw(), m_CullDataBuffer.allocation, cullOffset, sizeof(cullData));
+
+		m_CullConstants = {
+			.objects		= m_ObjectBuffer.address,
+			.meshes			= m_MeshBuffer.address,
+			.cull			= m_CullDataBuffer.address + cullOffset,
+			.drawCount		= m_DrawArguments->GetCountAddress(),
+			.drawCommands	= m_DrawArguments->GetCommandsAddress(),
+			.taskCount		= m_TaskArguments ? m_TaskArguments->GetCountAddress() : 0,
+			.taskCommands	= m_TaskArguments ? m_TaskArguments->GetCommandsAddress() : 0,
+			.objectCount	= GetObjectCount(),
+			.maxDraws		= m_DrawArguments->GetMaxCommands(),
+			.maxTaskDraws	= CanDrawMeshlets() ? m_TaskArguments->GetMaxCommands() : 0
+		};
+
+		// Group count follows the object count and the tuned workgroup size
+		ComputePass& cullPass = m_CullSequence.GetPass(0);
+		cullPass.groupCount = VulkanUtils::GetGroupCount({ std::max(1u, GetObjectCount()), 1, 1 }, cullPass.pipeline->GetWorkgroupSize());
+
+		m_Pyramid->PrepareRead(cmd);
+		m_CullSequence.Record(cmd);
+
+		// Record() leaves them as storage reads for compute, the draws read objects too
+		VkPipelineStageFlags2 readStages = GetSceneReadStages();
+		VulkanUtils::InsertBufferMemoryBarrier(cmd, m_ObjectBuffer.buffer, m_ObjectBuffer.bufferState,
+			readStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+		if (m_TaskArguments)
+		{
+			VulkanUtils::InsertBufferMemoryBarrier(cmd, m_MeshBuffer.buffer, m_MeshBuffer.bufferState,
+				readStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+			// Meshlet.task reads the object index back from its own command
+			AllocatedBuffer& taskBuffer = m_TaskArguments->GetBuffer();
+			VulkanUtils::InsertBufferMemoryBarrier(cmd, taskBuffer.buffer, taskBuffer.bufferState,
+				VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT,
+				VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+		}
+	}
+
+	void GpuScene::Draw(VkPipelineLayout layout, const glm::mat4& viewProj)
+	{
+		if (!m_VertexBuffer || !m_IndexBuffer)
+		{
+			VulkanEngine_ERROR("GpuScene: Draw without geometry");
+			return;
+		}
+
+		GpuDrawConstants constants{
+			.objects	= m_ObjectBuffer.address,
+			.vertices	= m_VertexBuffer->address,
+			.viewProj	= viewProj
+		};
+
+		VulkanRenderer::BindIndexBuffer(*m_IndexBuffer);
+		vkCmdPushConstants(VulkanRenderer::GetCommandBuffer(), layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+
+		AllocatedBuffer& arguments = m_DrawArguments->GetBuffer();
+		VulkanRenderer::DrawIndexedIndirectCount(
+			arguments, IndirectArgumentBuffer::kCommandsOffset,
+			arguments, IndirectArgumentBuffer::kCountOffset,
+			m_DrawArguments->GetMaxCommands()
+		);
+	}
+
+	void GpuScene::DrawMeshlets(VkPipelineLayout layout)
+	{
+		if (!CanDrawMeshlets() || !m_VertexBuffer)
+		{
+			VulkanEngine_ERROR("GpuScene: DrawMeshlets without mesh shader support or meshlet geometry");
+			return;
+		}
+
+		GpuMeshletConstants constants{
+			.objects			= m_ObjectBuffer.address,
+			.meshes				= m_MeshBuffer.address,
+			.cull				= m_CullConstants.cull, // this frame's GpuCullData
+			.taskCommands		= m_TaskArguments->GetCommandsAddress(),
+			.meshlets			= m_MeshletBuffer->address,
+			.meshletVertices	= m_MeshletVertexBuffer->address,
+			.meshletTriangles	= m_MeshletTriangleBuffer->address,
+			.vertices			= m_VertexBuffer->address
+		};
+
+		vkCmdPushConstants(VulkanRenderer::GetCommandBuffer(), layout, VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT,
+			0, sizeof(constants), &constants);
+
+		AllocatedBuffer& arguments = m_TaskArguments->GetBuffer();
+		VulkanRenderer::DrawMeshTasksIndirectCount(
+			arguments, IndirectArgumentBuffer::kCommandsOffset,
+			arguments, IndirectArgumentBuffer::kCountOffset,
+			m_TaskArguments->GetMaxCommands(), sizeof(GpuTaskCommand)
+		);
+	}
+
+	std::array<glm::vec4, 6> GpuScene::ExtractFrustumPlanes(const glm::mat4& viewProj)
+	{
+		// Rows of the matrix, glm is column major
+		glm::mat4 m = glm::transpose(viewProj);
+
+		// Left, right, bottom, top, near (reverse-Z: z <= w), far (z >= 0)
+		std::array<glm::vec4, 6> planes = {
+			m[3] + m[0],
+			m[3] - m[0],
+			m[3] + m[1],
+			m[3] - m[1],
+			m[3] - m[2],
+			m[2]
+		};
+
+		for (auto& plane : planes)
+		{
+			float length = glm::length(glm::vec3(plane));
+
+			// Infinite far plane degenerates to a zero normal, never culls
+			plane = length > 0.0f ? plane / length : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		}
+
+		return planes;
+	}
+
+}
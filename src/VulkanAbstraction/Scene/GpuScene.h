@@ -0,0 +1,197 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "VulkanAbstraction/VulkanTypes.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "VulkanAbstraction/Compute/ComputePassSequence.h"
+#include "VulkanAbstraction/Compute/IndirectArgumentBuffer.h"
+#include "VulkanAbstraction/Descriptors/VulkanDescriptorSetAllocator.h"
+#include "VulkanAbstraction/Geometry/MeshData.h"
+
+
+namespace VulkanEngine {
+
+	class HiZPyramid;
+
+	// Mirrors Assets/Shaders/Include/GpuScene.glsl (std430)
+	struct GpuObject
+	{
+		glm::mat4	transform{ 1.0f };
+		glm::vec4	boundingSphere{ 0.0f }; // world space, xyz center + w radius
+		uint32_t	meshIndex{ 0 };
+		float		scale{ 1.0f }; // largest axis scale of the transform
+		uint32_t	padding[2]{};
+	};
+	static_assert(sizeof(GpuObject) == 96);
+
+	struct GpuMeshLod
+	{
+		uint32_t	indexCount{ 0 };
+		uint32_t	firstIndex{ 0 };
+		float		error{ 0.0f }; // mesh space
+		uint32_t	padding{ 0 };
+	};
+
+	struct GpuMesh
+	{
+		uint32_t	lodCount{ 0 };
+		int32_t		vertexOffset{ 0 };
+		uint32_t	firstMeshlet{ 0 }; // LOD 0 only
+		uint32_t	meshletCount{ 0 };
+		std::array<GpuMeshLod, kMaxMeshLods> lods{}; // full detail first
+	};
+	static_assert(sizeof(GpuMesh) == 144);
+
+	struct GpuCullData
+	{
+		glm::vec4	frustumPlanes[6]{};		// xyz normal pointing inside, w distance
+		glm::mat4	occlusionViewProj{ 1.0f };	// view projection the depth pyramid was rendered with
+		glm::vec2	pyramidSize{ 0.0f };	// mip 0
+		uint32_t	pyramidMipCount{ 0 };
+		uint32_t	occlusionEnabled{ 0 };
+		glm::vec3	cameraPosition{ 0.0f };
+		float		lodDistanceFactor{ 0.0f }; // LodSelection::GetDistanceFactor
+		glm::mat4	viewProj{ 1.0f };		// mesh shader path transforms with it
+	};
+	static_assert(sizeof(GpuCullData) == 256);
+
+	// GpuCull.comp push constants
+	struct GpuCullConstants
+	{
+		VkDeviceAddress objects;
+		VkDeviceAddress meshes;
+		VkDeviceAddress cull;
+		VkDeviceAddress drawCount;
+		VkDeviceAddress drawCommands;
+		VkDeviceAddress taskCount;
+		VkDeviceAddress taskCommands;
+		uint32_t		objectCount;
+		uint32_t		maxDraws;
+		uint32_t		maxTaskDraws; // 0 skips the mesh task draws
+		uint32_t		padding;
+	};
+
+	// VkDrawMeshTasksIndirectCommandEXT followed by the object index, read by Meshlet.task through gl_DrawID
+	struct GpuTaskCommand
+	{
+		uint32_t groupCountX;
+		uint32_t groupCountY;
+		uint32_t groupCountZ;
+		uint32_t objectIndex;
+	};
+
+	// GpuDriven.vert push constants, the object is gl_InstanceIndex
+	struct GpuDrawConstants
+	{
+		VkDeviceAddress objects;
+		VkDeviceAddress vertices;
+		glm::mat4		viewProj;
+	};
+
+	// Meshlet.task and Meshlet.mesh push constants (Assets/Shaders/Include/Meshlet.glsl)
+	struct GpuMeshletConstants
+	{
+		VkDeviceAddress objects;
+		VkDeviceAddress meshes;
+		VkDeviceAddress cull;
+		VkDeviceAddress taskCommands;
+		VkDeviceAddress meshlets;
+		VkDeviceAddress meshletVertices;
+		VkDeviceAddress meshletTriangles;
+		VkDeviceAddress vertices;
+	};
+
+	// Objects and meshes resident on the GPU, culled and turned into draws by a compute pass.
+	// Every object becomes at most one VkDrawIndexedIndirectCommand for the LOD its screen-space
+	// error allows, with firstInstance set to the object index, and the whole scene is drawn by a single vkCmdDrawIndexedIndirectCount, so the
+	// CPU cost of a frame does not grow with the number of visible objects.
+	// With VK_EXT_mesh_shader every visible object with meshlets also gets a mesh task draw, DrawMeshlets
+	// culls its meshlets one by one on the GPU and draws the survivors with no index buffer at all.
+	// All meshes share one vertex and one index buffer (SetGeometry).
+	class GpuScene
+	{
+	public:
+		GpuScene(uint32_t maxObjects, uint32_t maxMeshes, HiZPyramid& pyramid,
+			const std::filesystem::path& cullShaderPath = "Assets\\Shaders\\GpuCull.comp");
+		virtual ~GpuScene() = default;
+
+		// What AddMesh, AddObject and AddMeshData return once the scene is full or for an unknown mesh
+		static constexpr uint32_t kInvalidIndex = ~0u;
+
+		// localSphere is in mesh space, objects get a world space copy
+		uint32_t AddMesh(uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset, const glm::vec4& localSphere);
+		uint32_t AddMesh(const Submesh& submesh); // with its LOD chain
+		uint32_t AddObject(uint32_t mesh, const glm::mat4& transform);
+		void SetTransform(uint32_t object, const glm::mat4& transform);
+
+		// Every submesh as a mesh and every node as an object placed under transform, returns the first mesh
+		uint32_t AddMeshData(const MeshData& meshData, const glm::mat4& transform = glm::mat4(1.0f));
+
+		// Not owned, must outlive the scene
+		void SetGeometry(AllocatedBuffer* vertexBuffer, AllocatedBuffer* indexBuffer);
+		void SetGeometry(MeshBuffers& buffers); // with its meshlets when it has them
+
+		// Outside rendering, in this order, every frame. Upload copies only the objects and meshes added or
+		// changed since the last one, its cost follows what changed rather than the size of the scene.
+		void Upload(VkCommandBuffer cmd);
+		void Cull(VkCommandBuffer cmd, const glm::mat4& viewProj, const LodSelection& lodSelection, bool occlusion = true);
+
+		// Inside rendering, with a pipeline whose vertex stage takes GpuDrawConstants
+		void Draw(VkPipelineLayout layout, const glm::mat4& viewProj);
+
+		// Inside rendering, with a PipelineType::Mesh pipeline built from Meshlet.task and Meshlet.mesh.
+		// Uses the view projection of the last Cull.
+		void DrawMeshlets(VkPipelineLayout layout);
+		bool CanDrawMeshlets() const { return m_TaskArguments && m_MeshletBuffer; }
+
+		uint32_t GetObjectCount()	const { return static_cast<uint32_t>(m_Objects.size()); }
+		uint32_t GetMeshCount()		const { return static_cast<uint32_t>(m_Meshes.size()); }
+		IndirectArgumentBuffer& GetDrawArguments() { return *m_DrawArguments; }
+		IndirectArgumentBuffer* GetTaskArguments() { return m_TaskArguments.get(); } // null without mesh shader support
+
+	private:
+		static std::array<glm::vec4, 6> ExtractFrustumPlanes(const glm::mat4& viewProj);
+
+		void UpdateBoundingSphere(uint32_t object);
+		void MarkDirty(uint32_t object);
+
+	private:
+		uint32_t								m_MaxObjects{ 0 };
+		uint32_t								m_MaxMeshes{ 0 };
+		HiZPyramid*								m_Pyramid{ nullptr };
+
+		// CPU copies, what changed is uploaded
+		std::vector<GpuObject>					m_Objects;
+		std::vector<GpuMesh>					m_Meshes;
+		std::vector<glm::vec4>					m_MeshSpheres;
+		std::vector<uint32_t>					m_DirtyObjects;
+		std::vector<uint8_t>					m_ObjectDirtyFlags;			// per object, keeps m_DirtyObjects unique
+		uint32_t								m_UploadedMeshCount{ 0 };	// meshes are only ever appended
+		std::vector<VkBufferCopy>				m_CopyRegions;				// reused by Upload
+
+		AllocatedBuffer							m_ObjectBuffer;
+		AllocatedBuffer							m_MeshBuffer;
+		AllocatedBuffer							m_CullDataBuffer; // one GpuCullData per frame in flight
+		std::array<AllocatedBuffer, FRAMES_IN_FLIGHT> m_StagingBuffers;
+		std::unique_ptr<IndirectArgumentBuffer>	m_DrawArguments;
+		std::unique_ptr<IndirectArgumentBuffer>	m_TaskArguments;
+
+		AllocatedBuffer*						m_VertexBuffer{ nullptr };
+		AllocatedBuffer*						m_IndexBuffer{ nullptr };
+		AllocatedBuffer*						m_MeshletBuffer{ nullptr };
+		AllocatedBuffer*						m_MeshletVertexBuffer{ nullptr };
+		AllocatedBuffer*						m_MeshletTriangleBuffer{ nullptr };
+
+		std::shared_ptr<VulkanDescriptorSetAllocator>	m_SetAllocator;
+		std::shared_ptr<VulkanDescriptorSet>			m_Set;
+		ComputePassSequence								m_CullSequence;
+		GpuCullConstants								m_CullConstants{};
+	};
+
+}
@@ -0,0 +1,183 @@
+#include "VulkanAbstraction/Scene/HiZPyramid.h"
+#include "VulkanAbstraction/Pipelines/VkPipelineBuilder.h"
+#include "VulkanAbstraction/Pipelines/VulkanLayoutCache.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "VulkanAbstraction/Core/VulkanContext.h"
+#include "Core/Application.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	struct DownsampleConstants
+	{
+		int32_t sourceSize[2];
+		int32_t destinationSize[2];
+	};
+
+	// Each level reads the one written just before
+	static void InsertComputeBarrier(VkCommandBuffer cmd)
+	{
+		VkMemoryBarrier2 barrier{
+			.sType			= VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+			.srcStageMask	= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			.srcAccessMask	= VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			.dstStageMask	= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			.dstAccessMask	= VK_ACCESS_2_SHADER_SAMPLED_READ_BIT
+		};
+
+		VkDependencyInfo dependency{
+			.sType					= VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+			.memoryBarrierCount		= 1,
+			.pMemoryBarriers		= &barrier
+		};
+
+		vkCmdPipelineBarrier2(cmd, &dependency);
+	}
+
+	HiZPyramid::HiZPyramid(const AllocatedImage& depthTarget, const std::filesystem::path& shaderPath)
+	{
+		auto* app = Application::GetRaw();
+		auto* ctx = VulkanContext::GetRaw();
+		VkDevice device = *ctx->GetDevice();
+
+		// Half resolution, down to 1x1
+		VkExtent3D extent{ std::max(1u, depthTarget.extent.width / 2), std::max(1u, depthTarget.extent.height / 2), 1 };
+		uint32_t mipCount = static_cast<uint32_t>(std::floor(std::log2(std::max(extent.width, extent.height)))) + 1;
+
+		m_Pyramid.format = VK_FORMAT_R32_SFLOAT;
+		m_Pyramid.extent = extent;
+
+		VkImageCreateInfo imageInfo = VulkanUtils::GetImageCreateInfo(m_Pyramid.format, extent,
+			VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+		imageInfo.mipLevels = mipCount;
+
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+		const auto& allocator = VulkanRenderer::GetAllocator();
+		allocator.AllocateImage(imageInfo, allocInfo, &m_Pyramid.image, &m_Pyramid.allocation);
+		app->GetLifetimeManager()->Push(vmaDestroyImage, allocator.GetRaw(), m_Pyramid.image, m_Pyramid.allocation);
+
+		// Whole chain for culling, one view per level for the build
+		VkImageViewCreateInfo viewInfo = VulkanUtils::GetImageViewCreateInfo(m_Pyramid.image, m_Pyramid.format, VK_IMAGE_ASPECT_COLOR_BIT);
+		viewInfo.subresourceRange.levelCount = mipCount;
+		CHECK_VK_RES(vkCreateImageView(device, &viewInfo, nullptr, &m_Pyramid.imageView));
+		app->GetLifetimeManager()->Push(vkDestroyImageView, device, m_Pyramid.imageView, nullptr);
+
+		m_MipViews.resize(mipCount);
+		for (uint32_t mip = 0; mip < mipCount; ++mip)
+		{
+			VkImageViewCreateInfo mipViewInfo = VulkanUtils::GetImageViewCreateInfo(m_Pyramid.image, m_Pyramid.format, VK_IMAGE_ASPECT_COLOR_BIT);
+			mipViewInfo.subresourceRange.baseMipLevel = mip;
+
+			CHECK_VK_RES(vkCreateImageView(device, &mipViewInfo, nullptr, &m_MipViews[mip]));
+			app->GetLifetimeManager()->Push(vkDestroyImageView, device, m_MipViews[mip], nullptr);
+		}
+
+		// Texels are fetched, never filtered
+		VkSamplerCreateInfo samplerInfo{
+			.sType			= VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+			.magFilter		= VK_FILTER_NEAREST,
+			.minFilter		= VK_FILTER_NEAREST,
+			.mipmapMode		= VK_SAMPLER_MIPMAP_MODE_NEAREST,
+			.addressModeU	= VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.addressModeV	= VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.addressModeW	= VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.maxLod			= VK_LOD_CLAMP_NONE
+		};
+		CHECK_VK_RES(vkCreateSampler(device, &samplerInfo, nullptr, &m_Sampler));
+		app->GetLifetimeManager()->Push(vkDestroySampler, device, m_Sampler, nullptr);
+
+		// Pipeline
+		auto shader = std::make_shared<VulkanShader>(shaderPath);
+		ReflectedLayout layout = VulkanLayoutCache::GetLayout({ shader });
+
+		VkPipelineBuilder builder;
+		builder.AddPipelineShader(shader);
+
+		m_Pipeline	= builder.BuildReloadable(PipelineType::Compute);
+		m_Layout	= layout.pipelineLayout;
+
+		// Level 0 reads the depth target, every other level the one above it
+		m_SetAllocator = std::make_shared<VulkanDescriptorSetAllocator>(mipCount, layout.GetPoolSizes(0, mipCount));
+
+		for (uint32_t mip = 0; mip < mipCount; ++mip)
+		{
+			auto set = m_SetAllocator->Allocate(layout.setLayouts[0]);
+
+			if (mip == 0)
+				set->WriteSampledImage(depthTarget.imageView, m_Sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0);
+			else
+				set->WriteSampledImage(m_MipViews[mip - 1], m_Sampler, VK_IMAGE_LAYOUT_GENERAL, 0);
+
+			set->WriteImage(m_MipViews[mip], VK_IMAGE_LAYOUT_GENERAL, 1);
+			m_Sets.push_back(set);
+		}
+
+		// Bound by culling before the first build, occlusion stays off until then
+		VulkanRenderer::ImmediateSubmit([&](VkCommandBuffer cmd)
+			{
+				VulkanUtils::InsertImageMemoryBarrier(
+					cmd, m_Pyramid.image, m_Pyramid.imageState,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+					VK_IMAGE_LAYOUT_GENERAL
+				);
+			});
+
+		VulkanEngine_DEBUG(fmt::runtime("Hi-Z pyramid: {}x{}, {} levels"), extent.width, extent.height, mipCount);
+	}
+
+	void HiZPyramid::Build(VkCommandBuffer cmd, AllocatedImage& depthTarget, const glm::mat4& viewProj)
+	{
+		VulkanUtils::InsertImageMemoryBarrier(
+			cmd, depthTarget.image, depthTarget.imageState,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_DEPTH_BIT
+		);
+
+		VulkanUtils::InsertImageMemoryBarrier(
+			cmd, m_Pyramid.image, m_Pyramid.imageState,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			VK_IMAGE_LAYOUT_GENERAL
+		);
+
+		vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline->GetRaw());
+
+		VkExtent2D sourceSize{ depthTarget.extent.width, depthTarget.extent.height };
+
+		for (uint32_t mip = 0; mip < GetMipCount(); ++mip)
+		{
+			VkExtent2D destinationSize{ std::max(1u, m_Pyramid.extent.width >> mip), std::max(1u, m_Pyramid.extent.height >> mip) };
+
+			DownsampleConstants constants{
+				.sourceSize			= { static_cast<int32_t>(sourceSize.width), static_cast<int32_t>(sourceSize.height) },
+				.destinationSize	= { static_cast<int32_t>(destinationSize.width), static_cast<int32_t>(destinationSize.height) }
+			};
+
+			VkDescriptorSet set = m_Sets[mip]->GetRaw();
+			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_Layout, 0, 1, &set, 0, nullptr);
+			vkCmdPushConstants(cmd, m_Layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+
+			VkExtent3D groupCount = VulkanUtils::GetGroupCount({ destinationSize.width, destinationSize.height, 1 }, m_Pipeline->GetWorkgroupSize());
+			vkCmdDispatch(cmd, groupCount.width, groupCount.height, groupCount.depth);
+
+			InsertComputeBarrier(cmd);
+			sourceSize = destinationSize;
+		}
+
+		m_ViewProj	= viewProj;
+		m_Valid		= true;
+	}
+
+	void HiZPyramid::PrepareRead(VkCommandBuffer cmd)
+	{
+		VulkanUtils::InsertImageMemoryBarrier(
+			cmd, m_Pyramid.image, m_Pyramid.imageState,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+			VK_IMAGE_LAYOUT_GENERAL
+		);
+	}
+
+}
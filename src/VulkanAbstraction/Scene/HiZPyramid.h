@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "VulkanAbstraction/VulkanTypes.h"
+#include "VulkanAbstraction/Pipelines/VulkanPipeline.h"
+#include "VulkanAbstraction/Descriptors/VulkanDescriptorSetAllocator.h"
+
+
+namespace VulkanEngine {
+
+	// Min-depth mip chain of the depth target (reverse-Z, so each texel is the farthest depth it covers).
+	// Built at the end of a frame and used by the next frame's occlusion culling together with the
+	// view projection it was rendered with.
+	class HiZPyramid
+	{
+	public:
+		HiZPyramid(const AllocatedImage& depthTarget, const std::filesystem::path& shaderPath = "Assets\\Shaders\\HiZDownsample.comp");
+		virtual ~HiZPyramid() = default;
+
+		// Outside rendering, after everything that writes depth
+		void Build(VkCommandBuffer cmd, AllocatedImage& depthTarget, const glm::mat4& viewProj);
+
+		// Orders the next sampled read after the build
+		void PrepareRead(VkCommandBuffer cmd);
+
+		bool				IsValid()		const { return m_Valid; }
+		VkImageView			GetView()		const { return m_Pyramid.imageView; }
+		VkSampler			GetSampler()	const { return m_Sampler; }
+		VkExtent2D			GetExtent()		const { return { m_Pyramid.extent.width, m_Pyramid.extent.height }; }
+		uint32_t			GetMipCount()	const { return static_cast<uint32_t>(m_MipViews.size()); }
+		const glm::mat4&	GetViewProj()	const { return m_ViewProj; }
+
+	private:
+		AllocatedImage										m_Pyramid{};
+		std::vector<VkImageView>							m_MipViews;
+		VkSampler											m_Sampler{ VK_NULL_HANDLE };
+
+		std::shared_ptr<VulkanPipeline>						m_Pipeline;
+		VkPipelineLayout									m_Layout{ VK_NULL_HANDLE };
+		std::shared_ptr<VulkanDescriptorSetAllocator>		m_SetAllocator;
+		std::vector<std::shared_ptr<VulkanDescriptorSet>>	m_Sets; // one per mip
+
+		glm::mat4											m_ViewProj{ 1.0f };
+		bool												m_Valid{ false };
+	};
+
+}
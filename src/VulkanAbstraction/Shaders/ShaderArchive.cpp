@@ -0,0 +1,223 @@
+#include "VulkanAbstraction/Shaders/ShaderArchive.h"
+#include "Core/LogSystem.h"
+
+
+namespace VulkanEngine {
+
+	static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	bool ShaderArchive::Mount(const std::filesystem::path& archivePath, const std::filesystem::path& rootDirectory)
+	{
+		std::lock_guard lock(s_Mutex);
+
+		s_File.Close();
+		s_Invalidated.clear();
+
+		if (!s_File.Open(archivePath))
+		{
+			VulkanEngine_WARN(fmt::runtime("Shader archive not found: {}"), archivePath.string());
+			return false;
+		}
+
+		if (!Validate(s_File))
+		{
+			VulkanEngine_ERROR(fmt::runtime("Shader archive is corrupt or outdated: {}"), archivePath.string());
+			s_File.Close();
+			return false;
+		}
+
+		s_RootDirectory = std::filesystem::absolute(rootDirectory).lexically_normal();
+
+		const auto* header = reinterpret_cast<const ShaderArchiveHeader*>(s_File.GetData());
+		VulkanEngine_INFO(fmt::runtime("Mounted shader archive: {} ({} shaders, {} profile, {} KB)"), archivePath.string(),
+			header->entryCount, ShaderCompiler::GetProfileName(static_cast<ShaderProfile>(header->profile)), s_File.GetSize() / 1024);
+
+		return true;
+	}
+
+	void ShaderArchive::Unmount()
+	{
+		std::lock_guard lock(s_Mutex);
+
+		s_File.Close();
+		s_Invalidated.clear();
+	}
+
+	bool ShaderArchive::IsMounted()
+	{
+		std::lock_guard lock(s_Mutex);
+		return s_File.IsOpen();
+	}
+
+	std::span<const uint32_t> ShaderArchive::Find(const std::filesystem::path& shaderPath, const ShaderCompileOptions& options)
+	{
+		std::lock_guard lock(s_Mutex);
+
+		if (!s_File.IsOpen())
+			return {};
+
+		std::filesystem::path relativePath = GetRelativePath(shaderPath);
+		if (relativePath.empty() || s_Invalidated.contains(HashUtils::Hash64(relativePath.generic_string())))
+			return {};
+
+		uint64_t key = GetKey(relativePath, options);
+
+		const auto* header	= reinterpret_cast<const ShaderArchiveHeader*>(s_File.GetData());
+		const auto* first	= reinterpret_cast<const ShaderArchiveEntry*>(s_File.GetData() + sizeof(ShaderArchiveHeader));
+		const auto* last	= first + header->entryCount;
+
+		const auto* entry = std::lower_bound(first, last, key,
+			[](const ShaderArchiveEntry& e, uint64_t k) { return e.key < k; });
+
+		if (entry == last || entry->key != key)
+			return {};
+
+		return { reinterpret_cast<const uint32_t*>(s_File.GetData() + entry->offset), entry->size / sizeof(uint32_t) };
+	}
+
+	void ShaderArchive::Invalidate(const std::filesystem::path& shaderPath)
+	{
+		std::lock_guard lock(s_Mutex);
+
+		std::filesystem::path relativePath = GetRelativePath(shaderPath);
+		if (!relativePath.empty())
+			s_Invalidated.insert(HashUtils::Hash64(relativePath.generic_string()));
+	}
+
+	uint64_t ShaderArchive::GetKey(const std::filesystem::path& relativePath, const ShaderCompileOptions& options)
+	{
+		ShaderCompileOptions variant = options;
+		variant.profile = ShaderProfile::Release;
+
+		return HashUtils::Hash64(relativePath.generic_string(), variant.GetHash());
+	}
+
+	bool ShaderArchive::Write(const std::filesystem::path& archivePath, ShaderProfile profile, std::vector<Blob> blobs)
+	{
+		std::sort(blobs.begin(), blobs.end(), [](const Blob& a, const Blob& b) { return a.key < b.key; });
+
+		for (size_t i = 1; i < blobs.size(); ++i)
+		{
+			if (blobs[i].key == blobs[i - 1].key)
+			{
+				VulkanEngine_ERROR(fmt::runtime("Shader archive key collision: {}"), HashUtils::ToHex(blobs[i].key));
+				return false;
+			}
+		}
+
+		ShaderArchiveHeader header{
+			.magic		= kShaderArchiveMagic,
+			.version	= kShaderArchiveVersion,
+			.entryCount = static_cast<uint32_t>(blobs.size()),
+			.profile	= static_cast<uint32_t>(profile)
+		};
+
+		std::vector<ShaderArchiveEntry> entries;
+		uint64_t offset = AlignUp(sizeof(ShaderArchiveHeader) + blobs.size() * sizeof(ShaderArchiveEntry), kShaderArchiveAlignment);
+
+		for (const auto& blob : blobs)
+		{
+			uint64_t size = blob.spirv.size() * sizeof(uint32_t);
+			entries.push_back({ blob.key, offset, size });
+			offset = AlignUp(offset + size, kShaderArchiveAlignment);
+		}
+
+		std::filesystem::create_directories(std::filesystem::absolute(archivePath).parent_path());
+
+		// Written next to the target and renamed, a running engine never maps a half-written file
+		auto tempPath = archivePath;
+		tempPath += ".tmp";
+
+		bool written = false;
+		{
+			std::ofstream archiveFile(tempPath, std::ios::binary | std::ios::trunc);
+			if (!archiveFile.is_open())
+			{
+				VulkanEngine_ERROR(fmt::runtime("Failed to write shader archive: {}"), tempPath.string());
+				return false;
+			}
+
+			auto pad = [&](uint64_t target)
+				{
+					static constexpr char zeros[kShaderArchiveAlignment]{};
+					uint64_t position = static_cast<uint64_t>(archiveFile.tellp());
+					archiveFile.write(zeros, static_cast<std::streamsize>(target - position));
+				};
+
+			archiveFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			archiveFile.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ShaderArchiveEntry));
+
+			for (size_t i = 0; i < blobs.size(); ++i)
+			{
+				pad(entries[i].offset);
+				archiveFile.write(reinterpret_cast<const char*>(blobs[i].spirv.data()), entries[i].size);
+			}
+
+			written = archiveFile.good();
+		}
+
+		// Closed by now, a failed write leaves no temporary behind
+		std::error_code ec;
+		if (written)
+			std::filesystem::rename(tempPath, archivePath, ec);
+
+		if (!written || ec)
+		{
+			VulkanEngine_ERROR(fmt::runtime("Failed to write shader archive: {}"), archivePath.string());
+
+			std::error_code removeError;
+			std::filesystem::remove(tempPath, removeError);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool ShaderArchive::Validate(const FilesystemUtils::MappedFile& file)
+	{
+		if (file.GetSize() < sizeof(ShaderArchiveHeader))
+			return false;
+
+		const auto* header = reinterpret_cast<const ShaderArchiveHeader*>(file.GetData());
+		if (header->magic != kShaderArchiveMagic || header->version != kShaderArchiveVersion)
+			return false;
+
+		uint64_t tocEnd = sizeof(ShaderArchiveHeader) + uint64_t(header->entryCount) * sizeof(ShaderArchiveEntry);
+		if (tocEnd > file.GetSize())
+			return false;
+
+		const auto* entries = reinterpret_cast<const ShaderArchiveEntry*>(file.GetData() + sizeof(ShaderArchiveHeader));
+		for (uint32_t i = 0; i < header->entryCount; ++i)
+		{
+			const auto& entry = entries[i];
+
+			bool valid =
+				entry.offset >= tocEnd &&
+				entry.offset <= file.GetSize() &&
+				entry.offset % kShaderArchiveAlignment == 0 &&
+				entry.size % sizeof(uint32_t) == 0 &&
+				entry.size <= file.GetSize() - entry.offset &&
+				(i == 0 || entries[i - 1].key < entry.key);
+
+			if (!valid)
+				return false;
+		}
+
+		return true;
+	}
+
+	std::filesystem::path ShaderArchive::GetRelativePath(const std::filesystem::path& shaderPath)
+	{
+		std::filesystem::path relativePath = std::filesystem::absolute(shaderPath).lexically_normal().lexically_relative(s_RootDirectory);
+
+		// Outside of the archive root
+		if (relativePath.empty() || *relativePath.begin() == "..")
+			return {};
+
+		return relativePath;
+	}
+
+}
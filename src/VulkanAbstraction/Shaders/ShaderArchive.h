@@ -0,0 +1,82 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+#include "VulkanAbstraction/Shaders/ShaderCompiler.h"
+#include "Utility/Utility.h"
+
+
+namespace VulkanEngine {
+
+	// On-disk layout, little endian:
+	//   ShaderArchiveHeader
+	//   ShaderArchiveEntry[entryCount]	sorted by key
+	//   SPIR-V blobs					each aligned to kShaderArchiveAlignment
+	struct ShaderArchiveHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t profile; // ShaderProfile every blob was compiled with
+	};
+
+	struct ShaderArchiveEntry
+	{
+		uint64_t key;
+		uint64_t offset; // from the start of the file
+		uint64_t size;	 // in bytes
+	};
+
+	static constexpr uint32_t kShaderArchiveMagic		= 0x43524153; // "SARC"
+	static constexpr uint32_t kShaderArchiveVersion		= 2;
+	static constexpr uint64_t kShaderArchiveAlignment	= 16;
+
+	// Read-only pack of precompiled SPIR-V, produced at build time by the ShaderPacker tool.
+	// The file is memory mapped and lookups return views into the mapping, so shader modules are
+	// created straight from the archive without copies. Shaders that are missing from the archive,
+	// or were edited since it was built, go through the ShaderCache instead.
+	class ShaderArchive
+	{
+	public:
+		ShaderArchive()		= delete;
+		~ShaderArchive()	= delete;
+
+		// Shader paths are looked up relative to rootDirectory
+		static bool Mount(const std::filesystem::path& archivePath, const std::filesystem::path& rootDirectory);
+		static void Unmount();
+		static bool IsMounted();
+
+		// Empty span on a miss, valid until Unmount
+		static std::span<const uint32_t> Find(const std::filesystem::path& shaderPath, const ShaderCompileOptions& options);
+
+		// Stops serving a shader whose source changed on disk (hot reload)
+		static void Invalidate(const std::filesystem::path& shaderPath);
+
+		// Relative path + options, identical for the packer and the runtime. The profile is left
+		// out: an archive holds one profile, chosen when it is built, and serves every lookup
+		static uint64_t GetKey(const std::filesystem::path& relativePath, const ShaderCompileOptions& options);
+
+		struct Blob
+		{
+			uint64_t				key{ 0 };
+			std::vector<uint32_t>	spirv;
+		};
+
+		static bool Write(const std::filesystem::path& archivePath, ShaderProfile profile, std::vector<Blob> blobs);
+
+	private:
+		static bool Validate(const FilesystemUtils::MappedFile& file);
+		static std::filesystem::path GetRelativePath(const std::filesystem::path& shaderPath);
+
+	private:
+		static inline std::mutex					s_Mutex;
+		static inline FilesystemUtils::MappedFile	s_File;
+		static inline std::filesystem::path			s_RootDirectory;
+		static inline std::unordered_set<uint64_t>	s_Invalidated; // relative path hashes
+	};
+
+}
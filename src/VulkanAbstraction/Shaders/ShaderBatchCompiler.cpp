@@ -0,0 +1,105 @@
+#include "VulkanAbstraction/Shaders/ShaderBatchCompiler.h"
+#include "VulkanAbstraction/Shaders/ShaderCache.h"
+#include "Core/LogSystem.h"
+
+#include <atomic>
+#include <thread>
+
+
+namespace VulkanEngine {
+
+	static bool IsShaderSource(const std::filesystem::path& path)
+	{
+		static const std::set<std::string> s_Extensions = { ".vert", ".frag", ".comp", ".geom", ".task", ".mesh" };
+		return s_Extensions.contains(path.extension().string());
+	}
+
+	std::vector<ShaderBatchResult> ShaderBatchCompiler::Compile(const std::vector<ShaderBatchEntry>& entries, uint32_t threadCount)
+	{
+		std::vector<ShaderBatchResult> results(entries.size());
+		if (entries.empty()) return results;
+
+		if (threadCount == 0)
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		threadCount = std::min<uint32_t>(threadCount, static_cast<uint32_t>(entries.size()));
+
+		auto batchStart = std::chrono::high_resolution_clock::now();
+
+		// Workers pull the next entry until the list is drained, each result slot is written by one worker
+		std::atomic<size_t> nextEntry{ 0 };
+
+		auto worker = [&]()
+			{
+				std::vector<uint32_t> spirv;
+
+				for (size_t i = nextEntry++; i < entries.size(); i = nextEntry++)
+				{
+					const auto& entry = entries[i];
+					auto start = std::chrono::high_resolution_clock::now();
+
+					ShaderCacheResult cacheResult = ShaderCache::LoadOrCompile(entry.path, entry.options, spirv);
+
+					results[i] = ShaderBatchResult{
+						.path			= entry.path,
+						.success		= cacheResult != ShaderCacheResult::Failed,
+						.cached			= cacheResult == ShaderCacheResult::Cached,
+						.milliseconds	= std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count()
+					};
+				}
+			};
+
+		std::vector<std::thread> workers;
+		workers.reserve(threadCount);
+
+		for (uint32_t i = 0; i < threadCount; ++i)
+			workers.emplace_back(worker);
+
+		for (auto& thread : workers)
+			thread.join();
+
+		// The whole batch in one index write
+		ShaderCache::SaveIndex();
+
+		// Report
+		auto batchTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - batchStart);
+		uint32_t compiledCount = 0;
+		uint32_t failedCount = 0;
+
+		for (const auto& result : results)
+		{
+			if (!result.success)
+				failedCount++;
+			else if (!result.cached)
+				compiledCount++;
+
+			VulkanEngine_DEBUG(fmt::runtime("  {} {:>9.3f} ms  {}"),
+				!result.success ? "failed  " : result.cached ? "cached  " : "compiled",
+				result.milliseconds, result.path.string());
+		}
+
+		VulkanEngine_INFO(fmt::runtime("Shader batch: {} shaders ({} compiled, {} failed) on {} threads in {:.3f} ms"),
+			results.size(), compiledCount, failedCount, threadCount, batchTime.count());
+
+		return results;
+	}
+
+	std::vector<ShaderBatchResult> ShaderBatchCompiler::CompileDirectory(const std::filesystem::path& directory,
+		const ShaderCompileOptions& options, uint32_t threadCount)
+	{
+		std::vector<ShaderBatchEntry> entries;
+
+		std::error_code ec;
+		for (const auto& file : std::filesystem::recursive_directory_iterator(directory, ec))
+		{
+			if (file.is_regular_file() && IsShaderSource(file.path()))
+				entries.push_back({ file.path(), options });
+		}
+
+		if (ec)
+			VulkanEngine_ERROR(fmt::runtime("Failed to scan shader directory {}: {}"), directory.string(), ec.message());
+
+		return Compile(entries, threadCount);
+	}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "VulkanAbstraction/Shaders/ShaderCompiler.h"
+
+
+namespace VulkanEngine {
+
+	struct ShaderBatchEntry
+	{
+		std::filesystem::path	path;
+		ShaderCompileOptions	options;
+	};
+
+	struct ShaderBatchResult
+	{
+		std::filesystem::path	path;
+		bool					success{ false };
+		bool					cached{ false };
+		double					milliseconds{ 0.0 };
+	};
+
+	// Warms the SPIR-V cache for a whole shader set across a worker pool.
+	// VulkanShaders created afterwards load straight from the cache.
+	class ShaderBatchCompiler
+	{
+	public:
+		ShaderBatchCompiler()	= delete;
+		~ShaderBatchCompiler()	= delete;
+
+		// threadCount 0 means one worker per hardware thread
+		static std::vector<ShaderBatchResult> Compile(const std::vector<ShaderBatchEntry>& entries, uint32_t threadCount = 0);
+
+		// Every shader source below the directory, compiled with the same options
+		static std::vector<ShaderBatchResult> CompileDirectory(const std::filesystem::path& directory,
+			const ShaderCompileOptions& options = {}, uint32_t threadCount = 0);
+	};
+
+}
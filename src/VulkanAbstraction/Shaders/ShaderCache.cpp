@@ -0,0 +1,325 @@
+#include "VulkanAbstraction/Shaders/ShaderCache.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+#include <charconv>
+#include <fstream>
+#include <thread>
+
+
+namespace VulkanEngine {
+
+	static constexpr uint32_t kSpirvMagic		= 0x07230203;
+	static constexpr uint32_t kIndexVersion		= 2;
+
+	// The whole text or nothing, the index may have been edited by hand
+	static bool ParseHex(std::string_view text, uint64_t& value)
+	{
+		auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+		return error == std::errc() && end == text.data() + text.size() && !text.empty();
+	}
+
+	std::filesystem::path ShaderCache::GetCacheDir()
+	{
+		return std::filesystem::current_path() / "Cache" / "Shaders";
+	}
+
+	ShaderCacheResult ShaderCache::LoadOrCompile(const std::filesystem::path& shaderPath, const ShaderCompileOptions& options,
+		std::vector<uint32_t>& spirv)
+	{
+		std::string source = FilesystemUtils::ReadFile(shaderPath, FilesystemUtils::ReadMode::Text);
+		if (source.empty()) 
+		{
+			VulkanEngine_CRITICAL(fmt::runtime("Failed to read shader source: {}"), shaderPath.string());
+			return ShaderCacheResult::Failed;
+		}
+
+		uint64_t variantHash	= GetVariantHash(options);
+		uint64_t sourceHash		= HashUtils::Hash64(source);
+
+		// Fast path: source unchanged since the last run, key is known without preprocessing
+		if (auto key = FindKey(shaderPath, variantHash, sourceHash))
+		{
+			VulkanEngine_DEBUG(fmt::runtime("Loading cached SPIR-V: {}"), shaderPath.string());
+			if (Load(*key, spirv)) return ShaderCacheResult::Cached;
+			VulkanEngine_WARN("Failed to load cache (corrupted?), recompiling...");
+		}
+
+		// Source or an include changed on disk, the preprocessed text decides whether the binary is still valid
+		std::string preprocessed;
+		std::vector<ShaderDependency> dependencies;
+		if (!ShaderCompiler::Preprocess(shaderPath, source, options, preprocessed, dependencies))
+			return ShaderCacheResult::Failed;
+
+		uint64_t key = ComputeKey(preprocessed, variantHash);
+		ShaderCacheResult result = ShaderCacheResult::Cached;
+
+		if (!Load(key, spirv))
+		{
+			VulkanEngine_DEBUG(fmt::runtime("Compiling shader: {}"), shaderPath.string());
+
+			ShaderCompileStats stats;
+			if (!ShaderCompiler::Compile(shaderPath, source, options, spirv, &stats))
+				return ShaderCacheResult::Failed;
+
+			VulkanEngine_DEBUG(fmt::runtime("  [{}] {} -> {} bytes, {} -> {} instructions"), ShaderCompiler::GetProfileName(options.profile),
+				stats.sizeBefore, stats.sizeAfter, stats.instructionsBefore, stats.instructionsAfter);
+
+			result = ShaderCacheResult::Compiled;
+		}
+
+		Store(shaderPath, variantHash, sourceHash, key, dependencies, spirv);
+		return result;
+	}
+
+	std::filesystem::path ShaderCache::GetIndexPath()
+	{
+		return GetCacheDir() / "index.txt";
+	}
+
+	std::filesystem::path ShaderCache::GetBinaryPath(uint64_t key)
+	{
+		return GetCacheDir() / (HashUtils::ToHex(key) + ".spv");
+	}
+
+	std::string ShaderCache::GetIndexKey(const std::filesystem::path& shaderPath, uint64_t variantHash)
+	{
+		return std::filesystem::absolute(shaderPath).lexically_normal().generic_string() + "|" + HashUtils::ToHex(variantHash);
+	}
+
+	uint64_t ShaderCache::GetVariantHash(const ShaderCompileOptions& options)
+	{
+		uint64_t optionsHash = options.GetHash();
+		uint64_t versionHash = ShaderCompiler::GetVersionHash();
+		uint64_t includeHash = ShaderCompiler::GetIncludeDirectoriesHash();
+
+		uint64_t hash = HashUtils::Hash64(&versionHash, sizeof(versionHash), optionsHash);
+		return HashUtils::Hash64(&includeHash, sizeof(includeHash), hash);
+	}
+
+	uint64_t ShaderCache::ComputeKey(const std::string& preprocessedSource, uint64_t variantHash)
+	{
+		return HashUtils::Hash64(preprocessedSource, variantHash);
+	}
+
+	std::optional<uint64_t> ShaderCache::FindKey(const std::filesystem::path& shaderPath, uint64_t variantHash, uint64_t sourceHash)
+	{
+		IndexEntry entry;
+		{
+			std::lock_guard lock(s_Mutex);
+			LoadIndex();
+
+			auto it = s_Index.find(GetIndexKey(shaderPath, variantHash));
+			if (it == s_Index.end() || it->second.sourceHash != sourceHash)
+				return std::nullopt;
+
+			entry = it->second;
+		}
+
+		// Includes are re-hashed outside the lock, only this shader's closure is read
+		for (const auto& dependency : entry.dependencies)
+		{
+			std::error_code ec;
+			if (!std::filesystem::is_regular_file(dependency.path, ec))
+				return std::nullopt;
+
+			std::string content = FilesystemUtils::ReadFile(dependency.path, FilesystemUtils::ReadMode::Text);
+			if (HashUtils::Hash64(content) != dependency.contentHash)
+			{
+				VulkanEngine_DEBUG(fmt::runtime("Include changed: {} (used by {})"), dependency.path.string(), shaderPath.string());
+				return std::nullopt;
+			}
+		}
+
+		return entry.key;
+	}
+
+	std::vector<std::filesystem::path> ShaderCache::GetDependencies(const std::filesystem::path& shaderPath, const ShaderCompileOptions& options)
+	{
+		std::lock_guard lock(s_Mutex);
+		LoadIndex();
+
+		std::vector<std::filesystem::path> dependencies;
+
+		auto it = s_Index.find(GetIndexKey(shaderPath, GetVariantHash(options)));
+		if (it != s_Index.end())
+		{
+			for (const auto& dependency : it->second.dependencies)
+				dependencies.push_back(dependency.path);
+		}
+
+		return dependencies;
+	}
+
+	bool ShaderCache::Load(uint64_t key, std::vector<uint32_t>& spirv)
+	{
+		std::ifstream cacheFile(GetBinaryPath(key), std::ios::binary | std::ios::ate);
+		if (!cacheFile.is_open()) return false;
+
+		auto fileSize = static_cast<std::size_t>(cacheFile.tellg());
+		if (fileSize == 0 || fileSize % sizeof(uint32_t) != 0) 
+		{
+			VulkanEngine_WARN(fmt::runtime("Invalid SPIR-V cache file size: {}"), fileSize);
+			return false;
+		}
+
+		cacheFile.seekg(0, std::ios::beg);
+		spirv.resize(fileSize / sizeof(uint32_t));
+		cacheFile.read(reinterpret_cast<char*>(spirv.data()), fileSize);
+
+		if (!cacheFile.good() || spirv[0] != kSpirvMagic)
+		{
+			VulkanEngine_WARN(fmt::runtime("Corrupted SPIR-V cache file: {}"), GetBinaryPath(key).string());
+			spirv.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	void ShaderCache::Store(const std::filesystem::path& shaderPath, uint64_t variantHash, uint64_t sourceHash,
+		uint64_t key, const std::vector<ShaderDependency>& dependencies, const std::vector<uint32_t>& spirv)
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(GetCacheDir(), ec);
+
+		// Same key means same binary, only write it once. Written without the lock, so batch workers
+		// don't queue behind each other's disk writes.
+		auto binaryPath = GetBinaryPath(key);
+		if (!std::filesystem::exists(binaryPath, ec))
+		{
+			// Write to a temp file first so a crash never leaves a truncated binary behind. Per thread, two
+			// workers storing the same key must not write into the same temp file.
+			auto tempPath = binaryPath;
+			tempPath += "." + HashUtils::ToHex(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+
+			bool written = false;
+			{
+				std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+				if (cacheFile.is_open())
+				{
+					cacheFile.write(reinterpret_cast<const char*>(spirv.data()), spirv.size() * sizeof(uint32_t));
+					written = cacheFile.good();
+				}
+			}
+
+			if (written)
+				std::filesystem::rename(tempPath, binaryPath, ec);
+
+			if (!written || ec)
+			{
+				VulkanEngine_WARN(fmt::runtime("Failed to write SPIR-V cache: {}"), binaryPath.string());
+				std::filesystem::remove(tempPath, ec);
+				return;
+			}
+
+			VulkanEngine_DEBUG(fmt::runtime("Cached SPIR-V to: {}"), binaryPath.string());
+		}
+
+		std::lock_guard lock(s_Mutex);
+		LoadIndex();
+
+		s_Index[GetIndexKey(shaderPath, variantHash)] = { sourceHash, key, dependencies };
+		s_IndexDirty = true;
+	}
+
+	void ShaderCache::SaveIndex()
+	{
+		std::lock_guard lock(s_Mutex);
+		if (!s_IndexDirty)
+			return;
+
+		s_IndexDirty = false;
+		WriteIndex();
+	}
+
+	// ===========================================================================
+	// Index file
+	// ===========================================================================
+
+	void ShaderCache::LoadIndex()
+	{
+		if (s_IndexLoaded) return;
+		s_IndexLoaded = true;
+
+		std::ifstream indexFile(GetIndexPath());
+		if (!indexFile.is_open()) return;
+
+		// Header: "version <n>", then one line per entry:
+		// <path|variant> TAB <sourceHash> <key> [TAB <includeHash> <includePath>]...
+		std::string tag;
+		uint32_t version = 0;
+		indexFile >> tag >> version;
+
+		if (tag != "version" || version != kIndexVersion)
+		{
+			VulkanEngine_WARN("Shader cache index has an unknown format, ignoring it");
+			return;
+		}
+
+		std::string line;
+		while (std::getline(indexFile, line))
+		{
+			std::istringstream entryStream(line);
+			std::string indexKey, hashes;
+
+			if (!std::getline(entryStream, indexKey, '\t') || !std::getline(entryStream, hashes, '\t'))
+				continue;
+
+			std::istringstream hashStream(hashes);
+			std::string sourceHash, key;
+			if (!(hashStream >> sourceHash >> key))
+				continue;
+
+			IndexEntry entry;
+			if (!ParseHex(sourceHash, entry.sourceHash) || !ParseHex(key, entry.key))
+				continue;
+
+			// A dependency that doesn't parse would leave the include closure incomplete, drop the whole entry
+			bool valid = true;
+			std::string field;
+			while (valid && std::getline(entryStream, field, '\t'))
+			{
+				size_t separator = field.find(' ');
+				if (separator == std::string::npos)
+					continue;
+
+				ShaderDependency dependency{ field.substr(separator + 1) };
+				valid = ParseHex(std::string_view(field).substr(0, separator), dependency.contentHash);
+				entry.dependencies.push_back(std::move(dependency));
+			}
+
+			if (!valid)
+				continue;
+
+			s_Index[indexKey] = std::move(entry);
+		}
+	}
+
+	void ShaderCache::WriteIndex()
+	{
+		auto tempPath = GetIndexPath();
+		tempPath += ".tmp";
+
+		{
+			std::ofstream indexFile(tempPath, std::ios::trunc);
+			if (!indexFile.is_open()) return;
+
+			indexFile << "version " << kIndexVersion << "\n";
+
+			for (const auto& [indexKey, entry] : s_Index)
+			{
+				indexFile << indexKey << '\t' << HashUtils::ToHex(entry.sourceHash) << ' ' << HashUtils::ToHex(entry.key);
+
+				for (const auto& dependency : entry.dependencies)
+					indexFile << '\t' << HashUtils::ToHex(dependency.contentHash) << ' ' << dependency.path.generic_string();
+
+				indexFile << "\n";
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, GetIndexPath(), ec);
+	}
+
+}
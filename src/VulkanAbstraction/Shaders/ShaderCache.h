@@ -0,0 +1,80 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "VulkanAbstraction/Shaders/ShaderCompiler.h"
+
+
+namespace VulkanEngine {
+
+	enum class ShaderCacheResult : uint8_t
+	{
+		Failed,
+		Cached,
+		Compiled
+	};
+
+	// Content-addressed SPIR-V cache.
+	// Binaries are stored as <key>.spv where the key hashes the preprocessed source, the compile
+	// options and the compiler version. A small index maps (source path, options) to the last key
+	// and the shader's include closure, so shaders whose source and includes are unchanged skip
+	// preprocessing; mtimes are never consulted.
+	class ShaderCache
+	{
+	public:
+		ShaderCache()	= delete;
+		~ShaderCache()	= delete;
+
+		static std::filesystem::path GetCacheDir();
+
+		// Thread-safe, returns the cached binary or compiles and stores it
+		static ShaderCacheResult LoadOrCompile(const std::filesystem::path& shaderPath, const ShaderCompileOptions& options,
+			std::vector<uint32_t>& spirv);
+
+		// Options + compiler version, identifies one compiled variant of a source file
+		static uint64_t GetVariantHash(const ShaderCompileOptions& options);
+		static uint64_t ComputeKey(const std::string& preprocessedSource, uint64_t variantHash);
+
+		// Only returns a key if the source and every recorded include still hash the same
+		static std::optional<uint64_t> FindKey(const std::filesystem::path& shaderPath, uint64_t variantHash, uint64_t sourceHash);
+
+		// Include closure recorded by the last compile of this variant, empty if unknown
+		static std::vector<std::filesystem::path> GetDependencies(const std::filesystem::path& shaderPath, const ShaderCompileOptions& options);
+
+		static bool Load(uint64_t key, std::vector<uint32_t>& spirv);
+
+		// Writes the binary and updates the index in memory, SaveIndex puts the index on disk
+		static void Store(const std::filesystem::path& shaderPath, uint64_t variantHash, uint64_t sourceHash,
+			uint64_t key, const std::vector<ShaderDependency>& dependencies, const std::vector<uint32_t>& spirv);
+
+		// Once after a batch of LoadOrCompile calls, only writes when an entry changed
+		static void SaveIndex();
+
+	private:
+		struct IndexEntry
+		{
+			uint64_t						sourceHash{ 0 };
+			uint64_t						key{ 0 };
+			std::vector<ShaderDependency>	dependencies;
+		};
+
+		static std::filesystem::path	GetIndexPath();
+		static std::filesystem::path	GetBinaryPath(uint64_t key);
+		static std::string				GetIndexKey(const std::filesystem::path& shaderPath, uint64_t variantHash);
+
+		static void LoadIndex();
+		static void WriteIndex();
+
+	private:
+		static inline std::mutex								s_Mutex;
+		static inline bool										s_IndexLoaded = false;
+		static inline bool										s_IndexDirty = false;
+		static inline std::unordered_map<std::string, IndexEntry> s_Index;
+	};
+
+}
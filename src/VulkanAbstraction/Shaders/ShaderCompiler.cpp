@@ -0,0 +1,391 @@
+#include "VulkanAbstraction/Shaders/ShaderCompiler.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+// Shipped builds configured with VULKANENGINE_RUNTIME_SHADERC=OFF load every shader from the
+// ShaderArchive and do not link shaderc
+#ifndef VULKANENGINE_RUNTIME_SHADERC
+	#define VULKANENGINE_RUNTIME_SHADERC 1
+#endif
+
+#if VULKANENGINE_RUNTIME_SHADERC
+	#include <shaderc/shaderc.hpp>
+	#include <spirv-tools/optimizer.hpp> // bundled in shaderc_combined
+	#include <glslang/build_info.h>
+#endif
+
+// Vulkan SDK the shader toolchain comes from, set by CMake
+#ifndef VULKANENGINE_SHADER_TOOLCHAIN
+	#define VULKANENGINE_SHADER_TOOLCHAIN ""
+#endif
+
+
+namespace VulkanEngine {
+
+#if VULKANENGINE_RUNTIME_SHADERC
+	static shaderc_shader_kind GetShadercKind(const std::filesystem::path& shaderPath) 
+	{
+		std::string shaderExt = shaderPath.extension().string();
+
+		if (shaderExt == ".vert") return shaderc_vertex_shader;
+		if (shaderExt == ".frag") return shaderc_fragment_shader;
+		if (shaderExt == ".comp") return shaderc_compute_shader;
+		if (shaderExt == ".geom") return shaderc_geometry_shader;
+		if (shaderExt == ".task") return shaderc_task_shader;
+		if (shaderExt == ".mesh") return shaderc_mesh_shader;
+
+		VulkanEngine_WARN(fmt::runtime("Unsupported shader extension: {}"), shaderExt);
+		return shaderc_glsl_infer_from_source;
+	}
+
+	static shaderc_env_version GetShadercEnvVersion(uint32_t vulkanVersion)
+	{
+		switch (VK_API_VERSION_MINOR(vulkanVersion))
+		{
+		case 0:  return shaderc_env_version_vulkan_1_0;
+		case 1:  return shaderc_env_version_vulkan_1_1;
+		case 2:  return shaderc_env_version_vulkan_1_2;
+		case 3:  return shaderc_env_version_vulkan_1_3;
+		default: return shaderc_env_version_vulkan_1_4;
+		}
+	}
+
+	// Resolves #include against the including file's directory and the include roots.
+	// Every resolved file is recorded with the hash of the content handed to the compiler.
+	class ShaderIncluder : public shaderc::CompileOptions::IncluderInterface
+	{
+	public:
+		ShaderIncluder(const std::vector<std::filesystem::path>& includeDirectories, std::vector<ShaderDependency>* dependencies)
+			: m_IncludeDirectories(includeDirectories), m_Dependencies(dependencies)
+		{
+		}
+
+		shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type type,
+			const char* requestingSource, size_t includeDepth) override
+		{
+			auto* include = new IncludeResult();
+
+			std::filesystem::path resolved = Resolve(requestedSource, type, requestingSource);
+			if (resolved.empty())
+			{
+				// Empty source name signals failure, content is the error message
+				include->content = fmt::format("cannot find include \"{}\"", requestedSource);
+			}
+			else
+			{
+				include->sourceName = resolved.generic_string();
+				include->content	= FilesystemUtils::ReadFile(resolved, FilesystemUtils::ReadMode::Text);
+
+				if (m_Dependencies)
+					m_Dependencies->push_back({ resolved, HashUtils::Hash64(include->content) });
+			}
+
+			include->result = {
+				.source_name		= include->sourceName.c_str(),
+				.source_name_length = include->sourceName.size(),
+				.content			= include->content.c_str(),
+				.content_length		= include->content.size(),
+				.user_data			= include
+			};
+
+			return &include->result;
+		}
+
+		void ReleaseInclude(shaderc_include_result* data) override
+		{
+			delete static_cast<IncludeResult*>(data->user_data);
+		}
+
+	private:
+		struct IncludeResult
+		{
+			std::string				sourceName;
+			std::string				content;
+			shaderc_include_result	result{};
+		};
+
+		std::filesystem::path Resolve(const char* requestedSource, shaderc_include_type type, const char* requestingSource) const
+		{
+			std::vector<std::filesystem::path> candidates;
+
+			if (type == shaderc_include_type_relative)
+				candidates.push_back(std::filesystem::path(requestingSource).parent_path() / requestedSource);
+
+			for (const auto& directory : m_IncludeDirectories)
+				candidates.push_back(directory / requestedSource);
+
+			for (const auto& candidate : candidates)
+			{
+				std::error_code ec;
+				if (std::filesystem::is_regular_file(candidate, ec))
+					return std::filesystem::weakly_canonical(candidate, ec);
+			}
+
+			return {};
+		}
+
+	private:
+		const std::vector<std::filesystem::path>&	m_IncludeDirectories;
+		std::vector<ShaderDependency>*				m_Dependencies;
+	};
+
+	static shaderc::CompileOptions GetShadercOptions(const ShaderCompileOptions& options,
+		const std::vector<std::filesystem::path>& includeDirectories, std::vector<ShaderDependency>* dependencies = nullptr)
+	{
+		shaderc::CompileOptions shadercOptions;
+
+		shadercOptions.SetIncluder(std::make_unique<ShaderIncluder>(includeDirectories, dependencies));
+
+		shadercOptions.SetTargetEnvironment(shaderc_target_env_vulkan, GetShadercEnvVersion(options.vulkanVersion));
+
+		// shaderc always emits the unoptimized module with debug info, the profile's spirv-opt
+		// recipe runs afterwards so the effect of each profile can be measured
+		shadercOptions.SetOptimizationLevel(shaderc_optimization_level_zero);
+		shadercOptions.SetGenerateDebugInfo();
+
+		for (const auto& [name, value] : options.defines)
+			shadercOptions.AddMacroDefinition(name, value);
+
+		return shadercOptions;
+	}
+
+	static spv_target_env GetSpirvTargetEnv(uint32_t vulkanVersion)
+	{
+		switch (VK_API_VERSION_MINOR(vulkanVersion))
+		{
+		case 0:  return SPV_ENV_VULKAN_1_0;
+		case 1:  return SPV_ENV_VULKAN_1_1;
+		case 2:  return SPV_ENV_VULKAN_1_2;
+		case 3:  return SPV_ENV_VULKAN_1_3;
+		default: return SPV_ENV_VULKAN_1_4;
+		}
+	}
+
+	static bool OptimizeSpirv(const std::filesystem::path& shaderPath, const ShaderCompileOptions& options, std::vector<uint32_t>& spirv)
+	{
+		if (options.profile == ShaderProfile::Debug)
+			return true;
+
+		spvtools::Optimizer optimizer(GetSpirvTargetEnv(options.vulkanVersion));
+
+		std::string messages;
+		optimizer.SetMessageConsumer([&](spv_message_level_t level, const char*, const spv_position_t& position, const char* message)
+			{
+				if (level <= SPV_MSG_ERROR)
+					messages += fmt::format("{}: {}\n", position.index, message);
+			});
+
+		if (options.profile == ShaderProfile::Size)
+			optimizer.RegisterSizePasses();
+		else
+			optimizer.RegisterPerformancePasses();
+
+		optimizer.RegisterPass(spvtools::CreateStripDebugInfoPass());
+		optimizer.RegisterPass(spvtools::CreateStripNonSemanticInfoPass());
+
+		std::vector<uint32_t> optimized;
+		if (!optimizer.Run(spirv.data(), spirv.size(), &optimized))
+		{
+			VulkanEngine_CRITICAL(fmt::runtime("spirv-opt failed ({}):\n{}"), shaderPath.string(), messages);
+			return false;
+		}
+
+		spirv = std::move(optimized);
+		return true;
+	}
+
+	// shaderc::Compiler is expensive to create and must not be shared between threads
+	static shaderc::Compiler& GetThreadCompiler()
+	{
+		thread_local shaderc::Compiler compiler;
+		return compiler;
+	}
+#endif
+
+	uint64_t ShaderCompileOptions::GetHash() const
+	{
+		uint64_t hash = HashUtils::kHashSeed;
+
+		for (const auto& [name, value] : defines)
+		{
+			hash = HashUtils::Hash64(name, hash);
+			hash = HashUtils::Hash64(std::string_view("="), hash);
+			hash = HashUtils::Hash64(value, hash);
+			hash = HashUtils::Hash64(std::string_view(";"), hash);
+		}
+
+		hash = HashUtils::Hash64(&profile, sizeof(profile), hash);
+		hash = HashUtils::Hash64(&vulkanVersion, sizeof(vulkanVersion), hash);
+
+		return hash;
+	}
+
+	uint64_t ShaderCompiler::GetVersionHash()
+	{
+#if VULKANENGINE_RUNTIME_SHADERC
+		// The SPIR-V version alone stays the same across compiler releases: hash every component's build
+		unsigned int spvVersion = 0;
+		unsigned int spvRevision = 0;
+		shaderc_get_spv_version(&spvVersion, &spvRevision);
+
+		uint64_t hash = HashUtils::Hash64(&spvVersion, sizeof(spvVersion));
+		hash = HashUtils::Hash64(&spvRevision, sizeof(spvRevision), hash);
+
+		const int glslangVersion[] = { GLSLANG_VERSION_MAJOR, GLSLANG_VERSION_MINOR, GLSLANG_VERSION_PATCH };
+		hash = HashUtils::Hash64(glslangVersion, sizeof(glslangVersion), hash);
+		hash = HashUtils::Hash64(std::string_view(GLSLANG_VERSION_FLAVOR), hash);
+
+		// Release and commit of the SPIRV-Tools build, spirv-opt included
+		hash = HashUtils::Hash64(std::string_view(spvSoftwareVersionDetailsString()), hash);
+		hash = HashUtils::Hash64(std::string_view(VULKANENGINE_SHADER_TOOLCHAIN), hash);
+
+		return hash;
+#else
+		return 0;
+#endif
+	}
+
+	void ShaderCompiler::SetIncludeDirectories(const std::vector<std::filesystem::path>& directories)
+	{
+		s_IncludeDirectories.clear();
+
+		for (const auto& directory : directories)
+			s_IncludeDirectories.push_back(std::filesystem::absolute(directory).lexically_normal());
+	}
+
+	uint64_t ShaderCompiler::GetIncludeDirectoriesHash()
+	{
+		uint64_t hash = HashUtils::kHashSeed;
+
+		for (const auto& directory : s_IncludeDirectories)
+		{
+			hash = HashUtils::Hash64(directory.generic_string(), hash);
+			hash = HashUtils::Hash64(std::string_view(";"), hash);
+		}
+
+		return hash;
+	}
+
+	bool ShaderCompiler::Preprocess(const std::filesystem::path& shaderPath, const std::string& source,
+		const ShaderCompileOptions& options, std::string& preprocessed, std::vector<ShaderDependency>& dependencies)
+	{
+		dependencies.clear();
+
+#if VULKANENGINE_RUNTIME_SHADERC
+		shaderc::Compiler& compiler = GetThreadCompiler();
+
+		shaderc::PreprocessedSourceCompilationResult result = compiler.PreprocessGlsl(
+			source.c_str(), source.size(),
+			GetShadercKind(shaderPath),
+			shaderPath.string().c_str(),
+			GetShadercOptions(options, s_IncludeDirectories, &dependencies)
+		);
+
+		if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+		{
+			VulkanEngine_CRITICAL(fmt::runtime("Shader preprocessing failed ({}):\n{}"), shaderPath.string(), result.GetErrorMessage());
+			return false;
+		}
+
+		preprocessed.assign(result.begin(), result.end());
+
+		// Headers included more than once (include guards) are recorded once
+		std::sort(dependencies.begin(), dependencies.end(),
+			[](const ShaderDependency& a, const ShaderDependency& b) { return a.path < b.path; });
+		dependencies.erase(std::unique(dependencies.begin(), dependencies.end(),
+			[](const ShaderDependency& a, const ShaderDependency& b) { return a.path == b.path; }), dependencies.end());
+
+		return true;
+#else
+		VulkanEngine_CRITICAL(fmt::runtime("Built without a runtime shader compiler, not in the shader archive: {}"), shaderPath.string());
+		return false;
+#endif
+	}
+
+	bool ShaderCompiler::Compile(const std::filesystem::path& shaderPath, const std::string& source,
+		const ShaderCompileOptions& options, std::vector<uint32_t>& spirv, ShaderCompileStats* stats)
+	{
+#if VULKANENGINE_RUNTIME_SHADERC
+		shaderc::Compiler& compiler = GetThreadCompiler();
+
+		shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(
+			source.c_str(), source.size(),
+			GetShadercKind(shaderPath),
+			shaderPath.string().c_str(),
+			"main", GetShadercOptions(options, s_IncludeDirectories)
+		);
+
+		if (result.GetCompilationStatus() != shaderc_compilation_status_success) 
+		{
+			VulkanEngine_CRITICAL(fmt::runtime("Shader compilation failed ({}):\n{}"), shaderPath.string(), result.GetErrorMessage());
+			return false;
+		}
+
+		spirv.assign(result.begin(), result.end());
+
+		uint32_t sizeBefore			= static_cast<uint32_t>(spirv.size() * sizeof(uint32_t));
+		uint32_t instructionsBefore	= stats ? CountInstructions(spirv) : 0;
+
+		if (!OptimizeSpirv(shaderPath, options, spirv))
+			return false;
+
+		if (stats)
+		{
+			stats->sizeBefore			= sizeBefore;
+			stats->sizeAfter			= static_cast<uint32_t>(spirv.size() * sizeof(uint32_t));
+			stats->instructionsBefore	= instructionsBefore;
+			stats->instructionsAfter	= CountInstructions(spirv);
+		}
+
+		return true;
+#else
+		VulkanEngine_CRITICAL(fmt::runtime("Built without a runtime shader compiler, not in the shader archive: {}"), shaderPath.string());
+		return false;
+#endif
+	}
+
+	uint32_t ShaderCompiler::CountInstructions(std::span<const uint32_t> spirv)
+	{
+		// 5 word header, then each instruction stores its word count in the upper 16 bits
+		static constexpr size_t kHeaderWords = 5;
+
+		uint32_t count = 0;
+		for (size_t word = kHeaderWords; word < spirv.size(); ++count)
+		{
+			uint32_t wordCount = spirv[word] >> 16;
+			if (wordCount == 0)
+				break;
+
+			word += wordCount;
+		}
+
+		return count;
+	}
+
+	const char* ShaderCompiler::GetProfileName(ShaderProfile profile)
+	{
+		switch (profile)
+		{
+		case ShaderProfile::Debug:		return "debug";
+		case ShaderProfile::Release:	return "release";
+		case ShaderProfile::Size:		return "size";
+		}
+
+		return "unknown";
+	}
+
+	bool ShaderCompiler::ParseProfile(std::string_view name, ShaderProfile& profile)
+	{
+		for (ShaderProfile candidate : { ShaderProfile::Debug, ShaderProfile::Release, ShaderProfile::Size })
+		{
+			if (name == GetProfileName(candidate))
+			{
+				profile = candidate;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine {
+
+	enum class ShaderProfile : uint8_t
+	{
+		Debug,		// unoptimized, keeps names, line info and source for graphics debuggers
+		Release,	// spirv-opt performance recipe, debug info stripped
+		Size		// spirv-opt size recipe, debug info stripped
+	};
+
+#ifdef NDEBUG
+	static constexpr ShaderProfile kDefaultShaderProfile = ShaderProfile::Release;
+#else
+	static constexpr ShaderProfile kDefaultShaderProfile = ShaderProfile::Debug;
+#endif
+
+	struct ShaderCompileOptions
+	{
+		std::vector<std::pair<std::string, std::string>>	defines;
+		ShaderProfile										profile			= kDefaultShaderProfile;
+		uint32_t											vulkanVersion	= VK_API_VERSION_1_4;
+
+		uint64_t GetHash() const;
+	};
+
+	// A file pulled in through #include, hashed at the moment it was read
+	struct ShaderDependency
+	{
+		std::filesystem::path	path;
+		uint64_t				contentHash{ 0 };
+	};
+
+	// Effect of the profile on one shader, "before" is the unoptimized module with debug info
+	struct ShaderCompileStats
+	{
+		uint32_t sizeBefore{ 0 };			// bytes
+		uint32_t sizeAfter{ 0 };
+		uint32_t instructionsBefore{ 0 };
+		uint32_t instructionsAfter{ 0 };
+	};
+
+	// Thin wrapper over shaderc and spirv-opt, the only place that knows about it
+	class ShaderCompiler
+	{
+	public:
+		ShaderCompiler()	= delete;
+		~ShaderCompiler()	= delete;
+
+		// Identifies the compiler build, so cached SPIR-V is dropped when the toolchain changes
+		static uint64_t GetVersionHash();
+
+		// Roots searched for #include <...> and, after the including file's directory, #include "..."
+		// Set once at startup, before anything is compiled
+		static void SetIncludeDirectories(const std::vector<std::filesystem::path>& directories);
+		static uint64_t GetIncludeDirectoriesHash();
+
+		// Fills dependencies with every file reached through #include, sorted and without duplicates
+		static bool Preprocess(const std::filesystem::path& shaderPath, const std::string& source,
+			const ShaderCompileOptions& options, std::string& preprocessed, std::vector<ShaderDependency>& dependencies);
+
+		static bool Compile(const std::filesystem::path& shaderPath, const std::string& source,
+			const ShaderCompileOptions& options, std::vector<uint32_t>& spirv, ShaderCompileStats* stats = nullptr);
+
+		static uint32_t		CountInstructions(std::span<const uint32_t> spirv);
+		static const char*	GetProfileName(ShaderProfile profile);
+		static bool			ParseProfile(std::string_view name, ShaderProfile& profile);
+
+	private:
+		static inline std::vector<std::filesystem::path> s_IncludeDirectories;
+	};
+
+}
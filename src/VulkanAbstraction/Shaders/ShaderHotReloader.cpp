@@ -0,0 +1,233 @@
+#include "VulkanAbstraction/Shaders/ShaderHotReloader.h"
+#include "VulkanAbstraction/Shaders/ShaderArchive.h"
+#include "VulkanAbstraction/Shaders/ShaderCache.h"
+#include "VulkanAbstraction/Shaders/VulkanShader.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "Core/Application.h"
+#include "Core/LogSystem.h"
+
+
+namespace VulkanEngine {
+
+	static std::filesystem::path NormalizePath(const std::filesystem::path& path)
+	{
+		std::error_code ec;
+		std::filesystem::path normalized = std::filesystem::weakly_canonical(path, ec);
+
+		return ec ? path.lexically_normal() : normalized;
+	}
+
+	void ShaderHotReloader::Start(const std::vector<std::filesystem::path>& directories)
+	{
+		if (s_Watcher)
+			return;
+
+		s_Watcher = std::make_unique<ShaderWatcher>(directories, [](const std::vector<std::filesystem::path>& changedFiles)
+			{
+				OnFilesChanged(changedFiles);
+			});
+
+		RegisterDeletor();
+
+		VulkanEngine_INFO("Shader hot reload enabled");
+	}
+
+	void ShaderHotReloader::Stop()
+	{
+		if (s_Watcher)
+			s_Watcher->Stop();
+	}
+
+	void ShaderHotReloader::Register(std::shared_ptr<VulkanPipeline> pipeline, const VkPipelineBuilder& builder, PipelineType pipelineType)
+	{
+		RegisterDeletor();
+
+		std::lock_guard lock(s_Mutex);
+		s_Entries.push_back({ pipeline, {}, builder, pipelineType });
+	}
+
+	void ShaderHotReloader::Register(PipelineHandle pipeline, const VkPipelineBuilder& builder, PipelineType pipelineType)
+	{
+		RegisterDeletor();
+
+		std::lock_guard lock(s_Mutex);
+		s_Entries.push_back({ nullptr, pipeline, builder, pipelineType });
+	}
+
+	void ShaderHotReloader::OnFrameBoundary()
+	{
+		std::lock_guard lock(s_Mutex);
+
+		// The previous pipeline may still be in a frame in flight. Handles are rebound here, on the thread
+		// that records, so the render path reads them without synchronization.
+		for (auto& swap : s_PendingSwaps)
+		{
+			VkPipeline previous = swap.target
+				? swap.target->Swap(swap.pipeline)
+				: VulkanRenderer::GetResources().RebindPipeline(swap.handle, swap.pipeline);
+
+			VulkanRenderer::GetDeletionQueue().Release(previous);
+		}
+
+		s_PendingSwaps.clear();
+	}
+
+	void ShaderHotReloader::OnFilesChanged(const std::vector<std::filesystem::path>& changedFiles)
+	{
+		std::vector<std::filesystem::path> changed;
+		for (const auto& file : changedFiles)
+			changed.push_back(NormalizePath(file));
+
+		auto contains = [&](const std::filesystem::path& path)
+			{
+				return std::find(changed.begin(), changed.end(), NormalizePath(path)) != changed.end();
+			};
+
+		// Edited directly or through any file in its include closure
+		auto isChanged = [&](const std::shared_ptr<VulkanShader>& shader)
+			{
+				if (contains(shader->GetPath()))
+					return true;
+
+				auto dependencies = ShaderCache::GetDependencies(shader->GetPath(), shader->GetOptions());
+				return std::any_of(dependencies.begin(), dependencies.end(), contains);
+			};
+
+		// Snapshot, pipelines are built without holding the lock so frames are never stalled
+		std::vector<ReloadableEntry> entries;
+		{
+			std::lock_guard lock(s_Mutex);
+
+			// Handles removed from the registry since, nothing is left to rebuild for them
+			std::erase_if(s_Entries, [](const ReloadableEntry& entry)
+				{
+					return entry.handle && !VulkanRenderer::GetResources().IsAlive(entry.handle);
+				});
+
+			entries = s_Entries;
+		}
+
+		// One new module per changed (shader, options) pair, shared by all pipelines using it
+		std::vector<std::pair<std::shared_ptr<VulkanShader>, std::shared_ptr<VulkanShader>>> reloadedShaders;
+		std::vector<std::shared_ptr<VulkanShader>> failedShaders;
+
+		auto reload = [&](const std::shared_ptr<VulkanShader>& shader) -> std::shared_ptr<VulkanShader>
+			{
+				for (auto& [previous, reloaded] : reloadedShaders)
+					if (previous == shader)
+						return reloaded;
+
+				if (std::find(failedShaders.begin(), failedShaders.end(), shader) != failedShaders.end())
+					return nullptr;
+
+				// Validate first, a broken shader keeps the previous pipeline running
+				std::vector<uint32_t> spirv;
+				if (ShaderCache::LoadOrCompile(shader->GetPath(), shader->GetOptions(), spirv) == ShaderCacheResult::Failed)
+				{
+					VulkanEngine_ERROR(fmt::runtime("Hot reload failed, keeping previous version: {}"), shader->GetPath().string());
+					failedShaders.push_back(shader);
+					return nullptr;
+				}
+
+				// The packed binary is stale from now on
+				ShaderArchive::Invalidate(shader->GetPath());
+
+				auto reloaded = std::make_shared<VulkanShader>(shader->GetPath(), shader->GetOptions());
+				reloadedShaders.emplace_back(shader, reloaded);
+
+				return reloaded;
+			};
+
+		for (auto& entry : entries)
+		{
+			bool affected	= false;
+			bool failed		= false;
+
+			for (const auto& shader : entry.builder.GetShaders())
+			{
+				if (!isChanged(shader))
+					continue;
+
+				affected = true;
+
+				auto reloaded = reload(shader);
+				if (!reloaded)
+				{
+					failed = true;
+					break;
+				}
+
+				entry.builder.ReplaceShader(reloaded);
+			}
+
+			if (!affected || failed)
+				continue;
+
+			VkPipeline pipeline = entry.builder.BuildUnmanaged(entry.type);
+
+			std::lock_guard lock(s_Mutex);
+
+			for (auto& registered : s_Entries)
+			{
+				if (registered.pipeline == entry.pipeline && registered.handle == entry.handle)
+					registered.builder = entry.builder;
+			}
+
+			// A newer rebuild of the same pipeline supersedes one that hasn't been swapped in yet
+			for (auto& swap : s_PendingSwaps)
+			{
+				if (swap.target == entry.pipeline && swap.handle == entry.handle)
+				{
+					VulkanRenderer::GetDeletionQueue().Release(swap.pipeline);
+					swap.pipeline = pipeline;
+					pipeline = VK_NULL_HANDLE;
+				}
+			}
+
+			if (pipeline != VK_NULL_HANDLE)
+				s_PendingSwaps.push_back({ entry.pipeline, entry.handle, pipeline });
+		}
+
+		for (auto& [previous, reloaded] : reloadedShaders)
+		{
+			VulkanRenderer::GetResources().RebindShader(previous, reloaded);
+			VulkanEngine_INFO(fmt::runtime("Hot reloaded shader: {}"), reloaded->GetPath().string());
+		}
+	}
+
+	void ShaderHotReloader::RegisterDeletor()
+	{
+		if (s_DeletorRegistered)
+			return;
+
+		// Deletor
+		auto* app = Application::GetRaw();
+		app->GetLifetimeManager()->PushFunction([]() { Destroy(); });
+
+		s_DeletorRegistered = true;
+	}
+
+	void ShaderHotReloader::Destroy()
+	{
+		auto* ctx = VulkanContext::GetRaw();
+		VkDevice device = *ctx->GetDevice();
+
+		s_Watcher.reset();
+
+		std::lock_guard lock(s_Mutex);
+
+		for (auto& swap : s_PendingSwaps)
+			vkDestroyPipeline(device, swap.pipeline, nullptr);
+
+		// Handles are the registry's to destroy
+		for (auto& entry : s_Entries)
+		{
+			if (entry.pipeline)
+				vkDestroyPipeline(device, entry.pipeline->Swap(VK_NULL_HANDLE), nullptr);
+		}
+
+		s_PendingSwaps.clear();
+		s_Entries.clear();
+	}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "VulkanAbstraction/Pipelines/VkPipelineBuilder.h"
+#include "VulkanAbstraction/Pipelines/VulkanPipeline.h"
+#include "VulkanAbstraction/Resources/ResourceHandle.h"
+#include "VulkanAbstraction/Shaders/ShaderWatcher.h"
+
+
+namespace VulkanEngine {
+
+	// Recompiles shaders when their sources change and rebuilds every pipeline using them.
+	// Rebuilds happen on the watcher thread, the new VkPipeline is swapped in at the next frame
+	// boundary and the old one is destroyed once all frames that could reference it have retired.
+	class ShaderHotReloader
+	{
+	public:
+		ShaderHotReloader() = delete;
+		~ShaderHotReloader() = delete;
+
+		static void Start(const std::vector<std::filesystem::path>& directories);
+		static void Stop();
+
+		static void Register(std::shared_ptr<VulkanPipeline> pipeline, const VkPipelineBuilder& builder, PipelineType pipelineType);
+		static void Register(PipelineHandle pipeline, const VkPipelineBuilder& builder, PipelineType pipelineType);
+
+		// Called by the renderer before anything of the frame is recorded, replaced pipelines go to its deletion queue
+		static void OnFrameBoundary();
+
+	private:
+		static void OnFilesChanged(const std::vector<std::filesystem::path>& changedFiles);
+		static void RegisterDeletor();
+		static void Destroy();
+
+	private:
+		// Either an object or a registry handle is the target
+		struct ReloadableEntry
+		{
+			std::shared_ptr<VulkanPipeline> pipeline;
+			PipelineHandle					handle;
+			VkPipelineBuilder				builder;
+			PipelineType					type;
+		};
+
+		struct PendingSwap
+		{
+			std::shared_ptr<VulkanPipeline> target;
+			PipelineHandle					handle;
+			VkPipeline						pipeline;
+		};
+
+		static inline std::mutex						s_Mutex;
+		static inline std::vector<ReloadableEntry>		s_Entries;
+		static inline std::vector<PendingSwap>			s_PendingSwaps;
+		static inline std::unique_ptr<ShaderWatcher>	s_Watcher;
+		static inline bool								s_DeletorRegistered = false;
+	};
+
+}
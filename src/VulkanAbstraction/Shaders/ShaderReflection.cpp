@@ -0,0 +1,171 @@
+#include "VulkanAbstraction/Shaders/ShaderReflection.h"
+#include "Core/LogSystem.h"
+
+#include <spirv_reflect.h>
+
+
+namespace VulkanEngine {
+
+	bool ShaderReflection::Reflect(std::span<const uint32_t> spirv, VkShaderStageFlagBits stage, ShaderReflection& reflection)
+	{
+		reflection = {};
+
+		SpvReflectShaderModule module{};
+		SpvReflectResult result = spvReflectCreateShaderModule2(
+			SPV_REFLECT_MODULE_FLAG_NO_COPY, spirv.size_bytes(), spirv.data(), &module);
+
+		if (result != SPV_REFLECT_RESULT_SUCCESS)
+		{
+			VulkanEngine_ERROR(fmt::runtime("SPIR-V reflection failed ({})"), static_cast<int>(result));
+			return false;
+		}
+
+		// Descriptor bindings
+		uint32_t bindingCount = 0;
+		spvReflectEnumerateDescriptorBindings(&module, &bindingCount, nullptr);
+
+		std::vector<SpvReflectDescriptorBinding*> bindings(bindingCount);
+		spvReflectEnumerateDescriptorBindings(&module, &bindingCount, bindings.data());
+
+		for (const auto* binding : bindings)
+		{
+			// Unsized arrays need descriptor indexing, one descriptor until that is supported
+			uint32_t descriptorCount = binding->count;
+			if (descriptorCount == 0)
+			{
+				VulkanEngine_WARN(fmt::runtime("Runtime descriptor array '{}' reflected as a single descriptor"), binding->name);
+				descriptorCount = 1;
+			}
+
+			reflection.bindings.push_back({
+				.set				= binding->set,
+				.binding			= binding->binding,
+				.descriptorType		= static_cast<VkDescriptorType>(binding->descriptor_type),
+				.descriptorCount	= descriptorCount,
+				.stageFlags			= static_cast<VkShaderStageFlags>(stage),
+				.name				= binding->name ? binding->name : ""
+			});
+		}
+
+		// Push constants, a stage may only appear in one range
+		uint32_t blockCount = 0;
+		spvReflectEnumeratePushConstantBlocks(&module, &blockCount, nullptr);
+
+		std::vector<SpvReflectBlockVariable*> blocks(blockCount);
+		spvReflectEnumeratePushConstantBlocks(&module, &blockCount, blocks.data());
+
+		if (!blocks.empty())
+		{
+			uint32_t begin	= UINT32_MAX;
+			uint32_t end	= 0;
+
+			for (const auto* block : blocks)
+			{
+				begin	= std::min(begin, block->offset);
+				end		= std::max(end, block->offset + block->size);
+			}
+
+			reflection.pushConstantRanges.push_back({
+				.stageFlags = static_cast<VkShaderStageFlags>(stage),
+				.offset		= begin,
+				.size		= end - begin
+			});
+		}
+
+		// Workgroup size
+		if (stage == VK_SHADER_STAGE_COMPUTE_BIT)
+		{
+			if (const SpvReflectEntryPoint* entryPoint = spvReflectGetEntryPoint(&module, "main"))
+			{
+				reflection.localSize = {
+					std::max(1u, entryPoint->local_size.x),
+					std::max(1u, entryPoint->local_size.y),
+					std::max(1u, entryPoint->local_size.z)
+				};
+			}
+		}
+
+		spvReflectDestroyShaderModule(&module);
+
+		std::sort(reflection.bindings.begin(), reflection.bindings.end(),
+			[](const ShaderResourceBinding& a, const ShaderResourceBinding& b)
+			{
+				return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+			});
+
+		return true;
+	}
+
+	void ShaderReflection::Merge(const ShaderReflection& other)
+	{
+		for (const auto& binding : other.bindings)
+		{
+			auto it = std::find_if(bindings.begin(), bindings.end(),
+				[&](const ShaderResourceBinding& existing)
+				{
+					return existing.set == binding.set && existing.binding == binding.binding;
+				});
+
+			if (it == bindings.end())
+			{
+				bindings.push_back(binding);
+				continue;
+			}
+
+			if (it->descriptorType != binding.descriptorType || it->descriptorCount != binding.descriptorCount)
+			{
+				VulkanEngine_ERROR(fmt::runtime("Stages disagree on set {} binding {} ('{}' vs '{}')"),
+					binding.set, binding.binding, it->name, binding.name);
+			}
+
+			it->stageFlags |= binding.stageFlags;
+		}
+
+		std::sort(bindings.begin(), bindings.end(),
+			[](const ShaderResourceBinding& a, const ShaderResourceBinding& b)
+			{
+				return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+			});
+
+		for (const auto& range : other.pushConstantRanges)
+		{
+			auto it = std::find_if(pushConstantRanges.begin(), pushConstantRanges.end(),
+				[&](const VkPushConstantRange& existing)
+				{
+					return existing.offset == range.offset && existing.size == range.size;
+				});
+
+			if (it != pushConstantRanges.end())
+				it->stageFlags |= range.stageFlags;
+			else
+				pushConstantRanges.push_back(range);
+		}
+	}
+
+	uint32_t ShaderReflection::GetSetCount() const
+	{
+		return bindings.empty() ? 0 : bindings.back().set + 1;
+	}
+
+	std::vector<PoolSize> ShaderReflection::GetPoolSizes(uint32_t set, uint32_t setCount) const
+	{
+		std::vector<PoolSize> poolSizes;
+
+		for (const auto& binding : bindings)
+		{
+			if (binding.set != set)
+				continue;
+
+			auto it = std::find_if(poolSizes.begin(), poolSizes.end(),
+				[&](const PoolSize& poolSize) { return poolSize.descriptorType == binding.descriptorType; });
+
+			if (it == poolSizes.end())
+				poolSizes.push_back({ binding.descriptorType, binding.descriptorCount * setCount });
+			else
+				it->descriptorCount += binding.descriptorCount * setCount;
+		}
+
+		return poolSizes;
+	}
+
+}
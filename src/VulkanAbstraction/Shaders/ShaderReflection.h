@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "VulkanAbstraction/Descriptors/VulkanDescriptorSetAllocator.h"
+
+
+namespace VulkanEngine {
+
+	struct ShaderResourceBinding
+	{
+		uint32_t			set{ 0 };
+		uint32_t			binding{ 0 };
+		VkDescriptorType	descriptorType{ VK_DESCRIPTOR_TYPE_MAX_ENUM };
+		uint32_t			descriptorCount{ 1 };
+		VkShaderStageFlags	stageFlags{ 0 };
+		std::string			name;
+	};
+
+	// Resource interface of one shader, or of all stages of a pipeline once merged
+	struct ShaderReflection
+	{
+		std::vector<ShaderResourceBinding>	bindings; // sorted by (set, binding)
+		std::vector<VkPushConstantRange>	pushConstantRanges;
+		std::array<uint32_t, 3>				localSize{ 1, 1, 1 }; // compute only
+
+		static bool Reflect(std::span<const uint32_t> spirv, VkShaderStageFlagBits stage, ShaderReflection& reflection);
+
+		// Union of both interfaces, stage flags of shared bindings are combined
+		void Merge(const ShaderReflection& other);
+
+		uint32_t GetSetCount() const;
+
+		// Exact pool sizes to allocate setCount descriptor sets of the given set index
+		std::vector<PoolSize> GetPoolSizes(uint32_t set, uint32_t setCount = 1) const;
+	};
+
+}
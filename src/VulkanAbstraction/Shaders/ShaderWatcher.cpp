@@ -0,0 +1,174 @@
+#include "VulkanAbstraction/Shaders/ShaderWatcher.h"
+#include "Core/LogSystem.h"
+
+#ifdef __linux__
+	#include <sys/inotify.h>
+	#include <poll.h>
+	#include <unistd.h>
+#endif
+
+
+namespace VulkanEngine {
+
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr auto kDebounceTime	= std::chrono::milliseconds(100);
+	static constexpr auto kPollInterval	= std::chrono::milliseconds(250);
+
+	ShaderWatcher::ShaderWatcher(const std::vector<std::filesystem::path>& directories, Callback callback)
+		: m_Directories(directories), m_Callback(std::move(callback))
+	{
+		m_Thread = std::thread([this]() { Run(); });
+	}
+
+	ShaderWatcher::~ShaderWatcher()
+	{
+		Stop();
+	}
+
+	void ShaderWatcher::Stop()
+	{
+		m_Running = false;
+
+		if (m_Thread.joinable())
+			m_Thread.join();
+	}
+
+	void ShaderWatcher::Run()
+	{
+#ifdef __linux__
+		if (RunInotify())
+			return;
+
+		VulkanEngine_WARN("inotify unavailable, falling back to polling for shader changes");
+#endif
+		RunPolling();
+	}
+
+#ifdef __linux__
+	bool ShaderWatcher::RunInotify()
+	{
+		int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd < 0)
+			return false;
+
+		constexpr uint32_t kFileMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+		std::unordered_map<int, std::filesystem::path> watches;
+
+		auto addWatch = [&](const std::filesystem::path& directory)
+			{
+				int wd = inotify_add_watch(fd, directory.c_str(), kFileMask);
+				if (wd >= 0)
+					watches[wd] = directory;
+				else
+					VulkanEngine_WARN(fmt::runtime("Failed to watch shader directory: {}"), directory.string());
+			};
+
+		// inotify is not recursive, every subdirectory gets its own watch
+		for (const auto& directory : m_Directories)
+		{
+			addWatch(directory);
+
+			std::error_code ec;
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, ec))
+			{
+				if (entry.is_directory())
+					addWatch(entry.path());
+			}
+		}
+
+		VulkanEngine_INFO(fmt::runtime("Watching {} shader directories (inotify)"), watches.size());
+
+		std::set<std::filesystem::path> pending;
+		Clock::time_point lastEvent;
+
+		alignas(inotify_event) char buffer[4096];
+
+		while (m_Running)
+		{
+			pollfd pfd{ .fd = fd, .events = POLLIN, .revents = 0 };
+
+			if (poll(&pfd, 1, 50) > 0 && (pfd.revents & POLLIN))
+			{
+				ssize_t length = 0;
+				while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+				{
+					for (char* ptr = buffer; ptr < buffer + length; )
+					{
+						const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+						ptr += sizeof(inotify_event) + event->len;
+
+						if (event->len == 0 || !watches.contains(event->wd))
+							continue;
+
+						std::filesystem::path path = watches[event->wd] / event->name;
+
+						if (event->mask & IN_ISDIR)
+						{
+							if (event->mask & IN_CREATE)
+								addWatch(path);
+							continue;
+						}
+
+						pending.insert(path);
+						lastEvent = Clock::now();
+					}
+				}
+			}
+
+			if (!pending.empty() && Clock::now() - lastEvent > kDebounceTime)
+			{
+				m_Callback({ pending.begin(), pending.end() });
+				pending.clear();
+			}
+		}
+
+		close(fd);
+		return true;
+	}
+#endif
+
+	void ShaderWatcher::RunPolling()
+	{
+		std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes;
+
+		auto scan = [&](std::vector<std::filesystem::path>& changed)
+			{
+				for (const auto& directory : m_Directories)
+				{
+					std::error_code ec;
+					for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, ec))
+					{
+						if (!entry.is_regular_file())
+							continue;
+
+						auto writeTime = entry.last_write_time(ec);
+						auto [it, inserted] = writeTimes.try_emplace(entry.path().string(), writeTime);
+
+						if (!inserted && it->second != writeTime)
+						{
+							it->second = writeTime;
+							changed.push_back(entry.path());
+						}
+					}
+				}
+			};
+
+		std::vector<std::filesystem::path> changed;
+		scan(changed);
+
+		VulkanEngine_INFO(fmt::runtime("Watching {} shader files (polling)"), writeTimes.size());
+
+		while (m_Running)
+		{
+			std::this_thread::sleep_for(kPollInterval);
+
+			changed.clear();
+			scan(changed);
+
+			if (!changed.empty())
+				m_Callback(changed);
+		}
+	}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <vector>
+
+
+namespace VulkanEngine {
+
+	// Watches shader directories recursively on a background thread.
+	// Uses inotify on Linux and falls back to polling modification times elsewhere.
+	// Bursts of events (editors writing temp files, renames) are debounced into one callback.
+	class ShaderWatcher
+	{
+	public:
+		using Callback = std::function<void(const std::vector<std::filesystem::path>& changedFiles)>;
+
+		ShaderWatcher(const std::vector<std::filesystem::path>& directories, Callback callback);
+		virtual ~ShaderWatcher();
+		ShaderWatcher(const ShaderWatcher&)				= delete;
+		ShaderWatcher& operator=(const ShaderWatcher&)	= delete;
+
+		void Stop();
+
+	private:
+		void Run();
+#ifdef __linux__
+		bool RunInotify();
+#endif
+		void RunPolling();
+
+	private:
+		std::vector<std::filesystem::path>	m_Directories;
+		Callback							m_Callback;
+		std::atomic<bool>					m_Running{ true };
+		std::thread							m_Thread;
+	};
+
+}
@@ -1,6 +1,8 @@
 ﻿#include "VulkanAbstraction/Shaders/VulkanShader.h"
+#include "VulkanAbstraction/Shaders/ShaderArchive.h"
+#include "VulkanAbstraction/Shaders/ShaderCache.h"
 #include "VulkanAbstraction/Core/VulkanContext.h"
-#include "Core/Application.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
 #include "Core/LogSystem.h"
 #include "Utility/Utility.h"
 
@@ -9,21 +11,22 @@
 
 namespace VulkanEngine {
 
-	static shaderc_shader_kind GetShadercKind(const std::filesystem::path& shaderPath) 
+	static VkShaderStageFlagBits GetShaderStage(const std::filesystem::path& shaderPath)
 	{
 		std::string shaderExt = shaderPath.extension().string();
 
-		if (shaderExt == ".vert") return shaderc_vertex_shader;
-		if (shaderExt == ".frag") return shaderc_fragment_shader;
-		if (shaderExt == ".comp") return shaderc_compute_shader;
-		if (shaderExt == ".geom") return shaderc_geometry_shader;
+		if (shaderExt == ".vert") return VK_SHADER_STAGE_VERTEX_BIT;
+		if (shaderExt == ".frag") return VK_SHADER_STAGE_FRAGMENT_BIT;
+		if (shaderExt == ".comp") return VK_SHADER_STAGE_COMPUTE_BIT;
+		if (shaderExt == ".geom") return VK_SHADER_STAGE_GEOMETRY_BIT;
+		if (shaderExt == ".task") return VK_SHADER_STAGE_TASK_BIT_EXT;
+		if (shaderExt == ".mesh") return VK_SHADER_STAGE_MESH_BIT_EXT;
 
-		VulkanEngine_WARN(fmt::runtime("Unsupported shader extension: {}"), shaderExt);
-		return shaderc_glsl_infer_from_source;
+		return VK_SHADER_STAGE_ALL;
 	}
 
-	VulkanShader::VulkanShader(std::filesystem::path shaderPath)
-		: m_ShaderPath(shaderPath)
+	VulkanShader::VulkanShader(std::filesystem::path shaderPath, const ShaderCompileOptions& options)
+		: m_Stage(GetShaderStage(shaderPath)), m_ShaderPath(shaderPath), m_Options(options)
 	{
 		if (m_ShaderPath.empty()) 
 		{
@@ -34,121 +37,36 @@ namespace VulkanEngine {
 		CompileOrLoad();
 		CreateShaderModule();
 
-		// Deletor
-		auto* ctx = VulkanContext::GetRaw();
-		auto* app = Application::GetRaw();
-		VkDevice device = *ctx->GetDevice();
-
-		app->GetLifetimeManager()->Push(vkDestroyShaderModule, device, m_ShaderModule, nullptr);
-	}
-
-	std::filesystem::path VulkanShader::GetCacheDir() const 
-	{
-		return std::filesystem::current_path() / "Cache" / "Shaders";
-	}
-
-	std::filesystem::path VulkanShader::GetCachedPath() const 
-	{
-		return GetCacheDir() / (m_ShaderPath.stem().string() + ".spv");
-	}
-
-	bool VulkanShader::IsCacheValid() const 
-	{
-		auto cachePath = GetCachedPath();
-		if (!std::filesystem::exists(cachePath)) return false;
-
-		auto sourceTime  = std::filesystem::last_write_time(m_ShaderPath);
-		auto cacheTime   = std::filesystem::last_write_time(cachePath);
+		m_Hash = HashUtils::Hash64(m_Code.data(), m_Code.size_bytes());
 
-		return cacheTime > sourceTime; 
+		ShaderReflection::Reflect(m_Code, m_Stage, m_Reflection);
 	}
 
-	void VulkanShader::EnsureCacheDirExists() 
+	VulkanShader::~VulkanShader()
 	{
-		std::filesystem::create_directories(GetCacheDir());
+		VulkanRenderer::GetDeletionQueue().Release(m_ShaderModule);
 	}
 
 	bool VulkanShader::CompileOrLoad() 
 	{
-		EnsureCacheDirExists();
-
-		auto cachedPath = GetCachedPath();
-
-		if (IsCacheValid()) 
-		{
-			VulkanEngine_DEBUG(fmt::runtime("Loading cached SPIR-V: {}"), cachedPath.string());
-			if (LoadFromCache()) return true;
-			VulkanEngine_WARN("Failed to load cache (corrupted?), recompiling...");
-		}
-
-		VulkanEngine_DEBUG(fmt::runtime("Compiling shader: {}"), m_ShaderPath.string());
-
-		std::string source = FilesystemUtils::ReadFile(m_ShaderPath, FilesystemUtils::ReadMode::Text);
-		if (source.empty()) 
-		{
-			VulkanEngine_CRITICAL(fmt::runtime("Failed to read shader source: {}"), m_ShaderPath.string());
-			return false;
-		}
+		// Shipped builds: the packed archive, no copy
+		m_Code = ShaderArchive::Find(m_ShaderPath, m_Options);
+		if (!m_Code.empty())
+			return true;
 
-		return CompileAndCache(source);
-	}
-
-	bool VulkanShader::CompileAndCache(const std::string& source) 
-	{
-		shaderc::Compiler compiler;
-		shaderc::CompileOptions options;
-
-		options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_4);
-		options.SetOptimizationLevel(shaderc_optimization_level_performance);
-
-		shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(
-			source.c_str(), source.size(),
-			GetShadercKind(m_ShaderPath),
-			m_ShaderPath.string().c_str(),
-			"main", options
-		);
-
-		if (result.GetCompilationStatus() != shaderc_compilation_status_success) 
-		{
-			VulkanEngine_CRITICAL(fmt::runtime("Shader compilation failed ({}):\n{}"), m_ShaderPath.string(), result.GetErrorMessage());
-			return false;
-		}
-
-		m_SPIRV.assign(result.begin(), result.end());
-
-		// Write cache
-		std::ofstream cacheFile(GetCachedPath(), std::ios::binary | std::ios::trunc);
-		if (cacheFile.is_open()) 
-		{
-			cacheFile.write(reinterpret_cast<const char*>(m_SPIRV.data()), m_SPIRV.size() * sizeof(uint32_t));
-			VulkanEngine_DEBUG(fmt::runtime("Cached SPIR-V to: {}"), GetCachedPath().string());
-		}
-
-		return true;
-	}
-
-	bool VulkanShader::LoadFromCache() 
-	{
-		std::ifstream cacheFile(GetCachedPath(), std::ios::binary | std::ios::ate);
-		if (!cacheFile.is_open()) return false;
-
-		auto fileSize = static_cast<std::size_t>(cacheFile.tellg());
-		if (fileSize <= 0 || fileSize % sizeof(uint32_t) != 0) 
-		{
-			VulkanEngine_WARN(fmt::runtime("Invalid SPIR-V cache file size: {}"), fileSize);
-			return false;
-		}
+		// Development: loose per-file cache, compiles on a miss
+		bool loaded = ShaderCache::LoadOrCompile(m_ShaderPath, m_Options, m_SPIRV) != ShaderCacheResult::Failed;
+		m_Code = m_SPIRV;
 
-		cacheFile.seekg(0, std::ios::beg);
-		m_SPIRV.resize(fileSize / sizeof(uint32_t));
-		cacheFile.read(reinterpret_cast<char*>(m_SPIRV.data()), fileSize);
+		// Nothing to write after a batch warmed the cache (ShaderBatchCompiler)
+		ShaderCache::SaveIndex();
 
-		return !m_SPIRV.empty();
+		return loaded;
 	}
 
 	void VulkanShader::CreateShaderModule()
 	{
-		if (m_SPIRV.empty())
+		if (m_Code.empty())
 		{
 			VulkanEngine_CRITICAL(fmt::runtime("No SPIR-V data: {}"), m_ShaderPath.string());
 		}
@@ -159,8 +77,8 @@ namespace VulkanEngine {
 			.sType		= VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
 			.pNext		= nullptr,
 			.flags		= 0,
-			.codeSize	= m_SPIRV.size() * sizeof(uint32_t),
-			.pCode		= m_SPIRV.data()
+			.codeSize	= m_Code.size_bytes(),
+			.pCode		= m_Code.data()
 		};
 
 		CHECK_VK_RES(vkCreateShaderModule(*ctx->GetDevice(), &createInfo, nullptr, &m_ShaderModule));
@@ -1,36 +1,45 @@
 ﻿#pragma once
 
 #include <vulkan/vulkan.h>
-#include <shaderc/shaderc.hpp>
+#include <span>
 #include <vector>
 #include <filesystem>
 
+#include "VulkanAbstraction/Shaders/ShaderCompiler.h"
+#include "VulkanAbstraction/Shaders/ShaderReflection.h"
+
 namespace VulkanEngine {
 
 	class VulkanShader 
 	{
 	public:
-		VulkanShader(std::filesystem::path shaderPath);
-		virtual ~VulkanShader() = default;
-
-		VkShaderModule GetRaw() const { return m_ShaderModule; }
+		VulkanShader(std::filesystem::path shaderPath, const ShaderCompileOptions& options = {});
+		virtual ~VulkanShader(); // the module goes to the deletion queue, hot reload drops superseded shaders
+		VulkanShader(const VulkanShader&)				= delete;
+		VulkanShader& operator=(const VulkanShader&)	= delete;
+
+		VkShaderModule					GetRaw()	const { return m_ShaderModule;	}
+		VkShaderStageFlagBits			GetStage()	const { return m_Stage;			}
+		const std::filesystem::path&	GetPath()	const { return m_ShaderPath;	}
+		std::span<const uint32_t>		GetSPIRV()	const { return m_Code;			}
+		uint64_t						GetHash()	const { return m_Hash;			}
+		const ShaderCompileOptions&		GetOptions() const { return m_Options;		}
+		const ShaderReflection&			GetReflection() const { return m_Reflection; }
 
 	private:
-		std::filesystem::path GetCacheDir()		const;
-		std::filesystem::path GetCachedPath()	const;
-		bool IsCacheValid()						const;
-		void EnsureCacheDirExists();
-
 		bool CompileOrLoad();
-		bool CompileAndCache(const std::string& source);
-		bool LoadFromCache();
 
 		void CreateShaderModule();
 
 	private:
 		VkShaderModule			m_ShaderModule{ VK_NULL_HANDLE } ;
+		VkShaderStageFlagBits	m_Stage{ VK_SHADER_STAGE_ALL };
 		std::filesystem::path	m_ShaderPath;
-		std::vector<uint32_t>	m_SPIRV;
+		ShaderCompileOptions	m_Options;
+		std::vector<uint32_t>	m_SPIRV;	// only filled for loose-cache shaders
+		std::span<const uint32_t> m_Code;	// m_SPIRV or a view into the ShaderArchive
+		uint64_t				m_Hash{ 0 };
+		ShaderReflection		m_Reflection;
 	};
 
 }
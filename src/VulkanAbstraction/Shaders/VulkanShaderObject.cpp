@@ -0,0 +1,240 @@
+#include "VulkanAbstraction/Shaders/VulkanShaderObject.h"
+#include "VulkanAbstraction/Shaders/ShaderCache.h"
+#include "VulkanAbstraction/Core/VulkanContext.h"
+#include "VulkanAbstraction/Descriptors/VkDescriptorSetLayoutBuilder.h"
+#include "VulkanAbstraction/VulkanRenderer.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+#include <fstream>
+#include <cstring>
+
+
+namespace VulkanEngine {
+
+	struct ShaderBinaryHeader
+	{
+		static constexpr uint32_t kMagic	= 0x4A424F53; // "SOBJ"
+		static constexpr uint32_t kVersion	= 1;
+
+		uint32_t	magic{ kMagic };
+		uint32_t	version{ kVersion };
+		uint8_t		binaryUUID[VK_UUID_SIZE]{};
+		uint32_t	binaryVersion{ 0 };
+		uint64_t	key{ 0 };
+		uint64_t	dataSize{ 0 };
+	};
+
+	static VkPhysicalDeviceShaderObjectPropertiesEXT GetShaderObjectProperties()
+	{
+		auto* ctx = VulkanContext::GetRaw();
+
+		VkPhysicalDeviceShaderObjectPropertiesEXT shaderObjectProps{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_PROPERTIES_EXT
+		};
+		VkPhysicalDeviceProperties2 props2{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+			.pNext = &shaderObjectProps
+		};
+		vkGetPhysicalDeviceProperties2(*ctx->GetPhysicalDevice(), &props2);
+
+		return shaderObjectProps;
+	}
+
+	VulkanShaderObject::VulkanShaderObject(std::shared_ptr<VulkanShader> shader, const ShaderObjectSpecification& spec)
+		: m_Shader(shader), m_Spec(spec), m_SpecializationInfo(m_Spec.specialization.GetInfo())
+	{
+		if (!IsSupported())
+		{
+			VulkanEngine_CRITICAL("VK_EXT_shader_object is not enabled on this device");
+			return;
+		}
+
+		if (!CreateFromBinary())
+		{
+			CreateFromSPIRV();
+
+			// Nothing to cache when there was no SPIR-V to create it from
+			if (m_ShaderObject != VK_NULL_HANDLE)
+				WriteBinary();
+		}
+	}
+
+	VulkanShaderObject::~VulkanShaderObject()
+	{
+		VulkanRenderer::GetDeletionQueue().Release(m_ShaderObject);
+	}
+
+	bool VulkanShaderObject::IsSupported()
+	{
+		auto* ctx = VulkanContext::GetRaw();
+		return ctx && ctx->GetDevice()->IsExtensionEnabled(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+	}
+
+	std::filesystem::path VulkanShaderObject::GetCachedBinaryPath() const
+	{
+		return ShaderCache::GetCacheDir() / (m_Shader->GetPath().stem().string() + "_" + HashUtils::ToHex(GetCacheKey()) + ".shobj");
+	}
+
+	uint64_t VulkanShaderObject::GetCacheKey() const
+	{
+		// Set layout handles differ per run, so their bindings are part of the key instead
+		auto spirv = m_Shader->GetSPIRV();
+
+		uint64_t key = HashUtils::Hash64(spirv.data(), spirv.size() * sizeof(uint32_t));
+		key = HashUtils::Hash64(m_Shader->GetPath().generic_string(), key);
+
+		uint32_t layoutCount = static_cast<uint32_t>(m_Spec.setLayouts.size());
+		key = HashUtils::Hash64(&layoutCount, sizeof(layoutCount), key);
+		for (VkDescriptorSetLayout setLayout : m_Spec.setLayouts)
+		{
+			uint64_t bindingsHash = VkDescriptorSetLayoutBuilder::GetBindingsHash(setLayout);
+			key = HashUtils::Hash64(&bindingsHash, sizeof(bindingsHash), key);
+		}
+		key = HashUtils::Hash64(m_Spec.pushConstantRanges.data(), m_Spec.pushConstantRanges.size() * sizeof(VkPushConstantRange), key);
+		key = HashUtils::Hash64(&m_Spec.nextStage, sizeof(m_Spec.nextStage), key);
+		key = m_Spec.specialization.GetHash(key);
+
+		return key;
+	}
+
+	VkShaderCreateInfoEXT VulkanShaderObject::GetCreateInfo(VkShaderCodeTypeEXT codeType, size_t codeSize, const void* code) const
+	{
+		return {
+			.sType					= VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT,
+			.pNext					= nullptr,
+			.flags					= 0,
+			.stage					= m_Shader->GetStage(),
+			.nextStage				= m_Spec.nextStage,
+			.codeType				= codeType,
+			.codeSize				= codeSize,
+			.pCode					= code,
+			.pName					= "main",
+			.setLayoutCount			= static_cast<uint32_t>(m_Spec.setLayouts.size()),
+			.pSetLayouts			= m_Spec.setLayouts.data(),
+			.pushConstantRangeCount = static_cast<uint32_t>(m_Spec.pushConstantRanges.size()),
+			.pPushConstantRanges	= m_Spec.pushConstantRanges.data(),
+			.pSpecializationInfo	= m_Spec.specialization.IsEmpty() ? nullptr : &m_SpecializationInfo
+		};
+	}
+
+	bool VulkanShaderObject::CreateFromBinary()
+	{
+		auto cachedPath = GetCachedBinaryPath();
+		if (!std::filesystem::exists(cachedPath)) return false;
+
+		std::ifstream cacheFile(cachedPath, std::ios::binary);
+		if (!cacheFile.is_open()) return false;
+
+		ShaderBinaryHeader header;
+		cacheFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		// Binaries are only valid for the exact driver that produced them
+		auto props = GetShaderObjectProperties();
+
+		bool headerValid =
+			cacheFile.good()											&&
+			header.magic			== ShaderBinaryHeader::kMagic		&&
+			header.version			== ShaderBinaryHeader::kVersion	&&
+			header.binaryVersion	== props.shaderBinaryVersion		&&
+			header.key				== GetCacheKey()					&&
+			header.dataSize			> 0									&&
+			std::memcmp(header.binaryUUID, props.shaderBinaryUUID, VK_UUID_SIZE) == 0;
+
+		if (!headerValid)
+		{
+			VulkanEngine_DEBUG(fmt::runtime("Shader object binary outdated: {}"), cachedPath.string());
+			return false;
+		}
+
+		std::vector<char> binary(header.dataSize);
+		cacheFile.read(binary.data(), binary.size());
+		if (!cacheFile.good()) return false;
+
+		auto* ctx = VulkanContext::GetRaw();
+		const auto& ext = ctx->GetDevice()->GetExtensionFunctions();
+
+		VkShaderCreateInfoEXT createInfo = GetCreateInfo(VK_SHADER_CODE_TYPE_BINARY_EXT, binary.size(), binary.data());
+		VkResult res = ext.vkCreateShadersEXT(*ctx->GetDevice(), 1, &createInfo, nullptr, &m_ShaderObject);
+
+		if (res != VK_SUCCESS)
+		{
+			VulkanEngine_WARN(fmt::runtime("Shader object binary rejected ({}), recreating from SPIR-V"), string_VkResult(res));
+			m_ShaderObject = VK_NULL_HANDLE;
+			return false;
+		}
+
+		VulkanEngine_DEBUG(fmt::runtime("Loaded shader object binary: {}"), cachedPath.string());
+		return true;
+	}
+
+	void VulkanShaderObject::CreateFromSPIRV()
+	{
+		auto spirv = m_Shader->GetSPIRV();
+		if (spirv.empty())
+		{
+			VulkanEngine_CRITICAL(fmt::runtime("No SPIR-V data: {}"), m_Shader->GetPath().string());
+			return;
+		}
+
+		auto* ctx = VulkanContext::GetRaw();
+		const auto& ext = ctx->GetDevice()->GetExtensionFunctions();
+
+		VkShaderCreateInfoEXT createInfo = GetCreateInfo(VK_SHADER_CODE_TYPE_SPIRV_EXT, spirv.size() * sizeof(uint32_t), spirv.data());
+		CHECK_VK_RES(ext.vkCreateShadersEXT(*ctx->GetDevice(), 1, &createInfo, nullptr, &m_ShaderObject));
+
+		VulkanEngine_DEBUG(fmt::runtime("Created shader object: {}"), m_Shader->GetPath().string());
+	}
+
+	void VulkanShaderObject::WriteBinary()
+	{
+		auto* ctx = VulkanContext::GetRaw();
+		const auto& ext = ctx->GetDevice()->GetExtensionFunctions();
+		VkDevice device = *ctx->GetDevice();
+
+		size_t dataSize = 0;
+		CHECK_VK_RES(ext.vkGetShaderBinaryDataEXT(device, m_ShaderObject, &dataSize, nullptr));
+		if (dataSize == 0) return;
+
+		std::vector<char> binary(dataSize);
+		CHECK_VK_RES(ext.vkGetShaderBinaryDataEXT(device, m_ShaderObject, &dataSize, binary.data()));
+
+		auto props = GetShaderObjectProperties();
+
+		ShaderBinaryHeader header;
+		header.binaryVersion	= props.shaderBinaryVersion;
+		header.key				= GetCacheKey();
+		header.dataSize			= dataSize;
+		std::memcpy(header.binaryUUID, props.shaderBinaryUUID, VK_UUID_SIZE);
+
+		// Write to a temp file first so a crash never leaves a truncated binary behind
+		auto binaryPath	= GetCachedBinaryPath();
+		auto tempPath	= binaryPath;
+		tempPath += ".tmp";
+
+		bool written = false;
+		{
+			std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+			if (cacheFile.is_open())
+			{
+				cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				cacheFile.write(binary.data(), binary.size());
+				written = cacheFile.good();
+			}
+		}
+
+		std::error_code ec;
+		if (written)
+			std::filesystem::rename(tempPath, binaryPath, ec);
+
+		if (!written || ec)
+		{
+			VulkanEngine_WARN(fmt::runtime("Failed to write shader object binary: {}"), binaryPath.string());
+			std::filesystem::remove(tempPath, ec);
+			return;
+		}
+
+		VulkanEngine_DEBUG(fmt::runtime("Cached shader object binary to: {}"), binaryPath.string());
+	}
+
+}
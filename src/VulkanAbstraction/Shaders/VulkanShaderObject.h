@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "VulkanAbstraction/Shaders/VulkanShader.h"
+#include "VulkanAbstraction/VulkanTypes.h"
+
+
+namespace VulkanEngine {
+
+	struct ShaderObjectSpecification
+	{
+		std::vector<VkDescriptorSetLayout>	setLayouts;
+		std::vector<VkPushConstantRange>	pushConstantRanges;
+		VkShaderStageFlags					nextStage{ 0 };
+		SpecializationConstants				specialization;
+	};
+
+	// VK_EXT_shader_object path: a VkShaderEXT built straight from VulkanShader's SPIR-V,
+	// all pipeline state is set dynamically at record time.
+	// The driver binary is cached next to the SPIR-V cache and reused on the next run.
+	class VulkanShaderObject
+	{
+	public:
+		VulkanShaderObject(std::shared_ptr<VulkanShader> shader, const ShaderObjectSpecification& spec);
+		virtual ~VulkanShaderObject(); // through the deletion queue
+		VulkanShaderObject(const VulkanShaderObject&)				= delete;
+		VulkanShaderObject& operator=(const VulkanShaderObject&)	= delete;
+
+		static bool IsSupported();
+
+		VkShaderEXT				GetRaw()	const { return m_ShaderObject;		}
+		VkShaderStageFlagBits	GetStage()	const { return m_Shader->GetStage();	}
+
+	private:
+		std::filesystem::path	GetCachedBinaryPath()	const;
+		uint64_t				GetCacheKey()			const;
+
+		bool CreateFromBinary();
+		void CreateFromSPIRV();
+		void WriteBinary();
+
+		VkShaderCreateInfoEXT GetCreateInfo(VkShaderCodeTypeEXT codeType, size_t codeSize, const void* code) const;
+
+	private:
+		std::shared_ptr<VulkanShader>	m_Shader;
+		ShaderObjectSpecification		m_Spec;
+		VkSpecializationInfo			m_SpecializationInfo{}; // points into m_Spec
+		VkShaderEXT						m_ShaderObject{ VK_NULL_HANDLE };
+	};
+
+}
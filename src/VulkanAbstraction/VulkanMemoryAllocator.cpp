@@ -31,9 +31,17 @@ namespace VulkanEngine {
 
 	void VulkanMemoryAllocator::AllocateImage(
 		VkImageCreateInfo	imageInfo,	VmaAllocationCreateInfo allocInfo,
-		VkImage*			image,		VmaAllocation*			allocation)
+		VkImage*			image,		VmaAllocation*			allocation) const
 	{
 		CHECK_VK_RES(vmaCreateImage(m_Allocator, &imageInfo, &allocInfo, image, allocation, nullptr));
 	}
 
+	void VulkanMemoryAllocator::AllocateBuffer(
+		VkBufferCreateInfo	bufferInfo,	VmaAllocationCreateInfo allocInfo,
+		VkBuffer*			buffer,		VmaAllocation*			allocation,
+		VmaAllocationInfo*	allocationInfo) const
+	{
+		CHECK_VK_RES(vmaCreateBuffer(m_Allocator, &bufferInfo, &allocInfo, buffer, allocation, allocationInfo));
+	}
+
 }
\ No newline at end of file
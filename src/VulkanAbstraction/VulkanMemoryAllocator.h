@@ -11,9 +11,11 @@ namespace VulkanEngine {
 		VulkanMemoryAllocator();
 		virtual ~VulkanMemoryAllocator() = default;
 
-		void AllocateImage(VkImageCreateInfo imageInfo, VmaAllocationCreateInfo allocInfo, VkImage* image, VmaAllocation* allocation);
+		void AllocateImage(VkImageCreateInfo imageInfo, VmaAllocationCreateInfo allocInfo, VkImage* image, VmaAllocation* allocation) const;
+		void AllocateBuffer(VkBufferCreateInfo bufferInfo, VmaAllocationCreateInfo allocInfo, VkBuffer* buffer, VmaAllocation* allocation,
+			VmaAllocationInfo* allocationInfo = nullptr) const;
 
-		VmaAllocator GetRaw() { return m_Allocator; }
+		VmaAllocator GetRaw() const { return m_Allocator; }
 
 	private:
 		VmaAllocator m_Allocator{ VK_NULL_HANDLE };
@@ -1,9 +1,12 @@
 ﻿#include "VulkanRenderer.h"
 #include "VulkanAbstraction/Descriptors/VulkanDescriptorSet.h"
+#include "VulkanAbstraction/Shaders/ShaderHotReloader.h"
 #include "Core/Application.h"
 #include "Core/LogSystem.h"
 #include "Utility/Utility.h"
 
+#include <utility>
+
 namespace VulkanEngine {
 
 	void VulkanRenderer::Init()
@@ -19,7 +22,11 @@ namespace VulkanEngine {
 		s_Allocator			= std::make_unique<VulkanMemoryAllocator>();
 		s_ImGuiRenderer		= std::make_unique<ImGuiRenderer>();
 
+		if (VulkanPipelineLibrary::IsSupported())
+			s_PipelineLibrary = std::make_unique<VulkanPipelineLibrary>();
+
 		InitRenderTarget();
+		InitDepthTarget();
 	}
 
 	void VulkanRenderer::InitRenderTarget()
@@ -60,6 +67,36 @@ namespace VulkanEngine {
 		app->GetLifetimeManager()->Push(vmaDestroyImage, s_Allocator->GetRaw(), s_RenderTarget.image, s_RenderTarget.allocation);
 	}
 
+	void VulkanRenderer::InitDepthTarget()
+	{
+		auto* app = Application::GetRaw();
+		auto* ctx = VulkanContext::GetRaw();
+		VkDevice device = *ctx->GetDevice();
+
+		s_DepthTarget.format = DEPTH_FORMAT;
+		s_DepthTarget.extent = s_RenderTarget.extent;
+
+		// Sampled by the Hi-Z pyramid build
+		VkImageUsageFlags usage =
+			VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+			VK_IMAGE_USAGE_SAMPLED_BIT;
+
+		VkImageCreateInfo imageInfo = VulkanUtils::GetImageCreateInfo(DEPTH_FORMAT, s_DepthTarget.extent, usage);
+
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+		allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+		s_Allocator->AllocateImage(imageInfo, allocInfo, &s_DepthTarget.image, &s_DepthTarget.allocation);
+
+		VkImageViewCreateInfo viewInfo = VulkanUtils::GetImageViewCreateInfo(s_DepthTarget.image, DEPTH_FORMAT, VK_IMAGE_ASPECT_DEPTH_BIT);
+		CHECK_VK_RES(vkCreateImageView(device, &viewInfo, nullptr, &s_DepthTarget.imageView));
+
+		// Lifetime management
+		app->GetLifetimeManager()->Push(vkDestroyImageView, device, s_DepthTarget.imageView, nullptr);
+		app->GetLifetimeManager()->Push(vmaDestroyImage, s_Allocator->GetRaw(), s_DepthTarget.image, s_DepthTarget.allocation);
+	}
+
 	void VulkanRenderer::InitFrameData()
 	{
 		auto* ctx = VulkanContext::GetRaw();
@@ -70,6 +107,18 @@ namespace VulkanEngine {
 		{
 			frame.Init(device, queueFamily);
 		}
+
+		s_ImmediateFrame.Init(device, queueFamily);
+
+		uint32_t threadCount = Application::GetRaw()->GetJobSystem()->GetThreadCount();
+		s_CommandPools = std::make_unique<ThreadCommandPools>(device, queueFamily, threadCount, FRAMES_IN_FLIGHT);
+
+		// Flushed after the device idle EndInit pushes, before the allocator goes
+		s_DeletionQueue = std::make_unique<DeletionQueue>(device, s_Allocator->GetRaw());
+		Application::GetRaw()->GetLifetimeManager()->PushFunction([]() { s_DeletionQueue->Flush(); });
+
+		s_Resources = std::make_unique<ResourceRegistry>(ResourceRegistrySpecification{}, *s_DeletionQueue);
+		Application::GetRaw()->GetLifetimeManager()->PushFunction([]() { s_Resources->Flush(); });
 	}
 
 	void VulkanRenderer::InitSyncObjects()
@@ -90,6 +139,15 @@ namespace VulkanEngine {
 			app->GetLifetimeManager()->Push(vkDestroySemaphore, device, s_RenderFinishedSemaphores[i], nullptr);
 		}
 
+		VkSemaphoreTypeCreateInfo timelineInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+		timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		timelineInfo.initialValue  = 0;
+
+		VkSemaphoreCreateInfo timelineSemaphoreInfo = VulkanUtils::GetSemaphoreCreateInfo();
+		timelineSemaphoreInfo.pNext = &timelineInfo;
+
+		CHECK_VK_RES(vkCreateSemaphore(device, &timelineSemaphoreInfo, nullptr, &s_FrameTimeline));
+		app->GetLifetimeManager()->Push(vkDestroySemaphore, device, s_FrameTimeline, nullptr);
 	}
 
 	// ===========================================================================
@@ -104,6 +162,15 @@ namespace VulkanEngine {
 		// Wait for GPU to finish previous frame
 		CHECK_VK_RES(vkWaitForFences(*s_Context->GetDevice(), 1, &frame.renderFinishedFence, VK_TRUE, UINT64_MAX));
 
+		// Free what the retired frames released
+		uint64_t completedFrames = 0;
+		CHECK_VK_RES(vkGetSemaphoreCounterValue(*s_Context->GetDevice(), s_FrameTimeline, &completedFrames));
+		s_DeletionQueue->Collect(completedFrames);
+		s_Resources->Collect(completedFrames);
+
+		// Swap in hot reloaded pipelines before anything is recorded
+		ShaderHotReloader::OnFrameBoundary();
+
 		// Acquire next swapchain image
 		CHECK_VK_RES(vkAcquireNextImageKHR(
 			*s_Context->GetDevice(), ctx->GetSwaphain()->GetRaw(), UINT64_MAX,
@@ -113,6 +180,7 @@ namespace VulkanEngine {
 		// Reset frame resources
 		CHECK_VK_RES(vkResetFences(*s_Context->GetDevice(), 1, &frame.renderFinishedFence));
 		CHECK_VK_RES(vkResetCommandBuffer(frame.commandBuffer, 0));
+		s_CommandPools->Reset(s_CurrentFrameIndex);
 
 		// Begin command buffer recording
 		VkCommandBufferBeginInfo beginInfo = VulkanUtils::GetBeginCmdBufferInfo();
@@ -142,11 +210,17 @@ namespace VulkanEngine {
 		VkCommandBufferSubmitInfo cmdSubmitInfo = VulkanUtils::GetCommandBufferSubmitInfo(frame.commandBuffer);
 		VkSemaphoreSubmitInfo waitSemaphoreInfo = VulkanUtils::GetSemaphoreSubmitInfo(
 			VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, frame.imageAvailableSemaphore);
-		VkSemaphoreSubmitInfo signalSemaphoreInfo = VulkanUtils::GetSemaphoreSubmitInfo(
-			VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, s_RenderFinishedSemaphores[s_CurrentImageIndex]);
 
-		VkSubmitInfo2 submitInfo = VulkanUtils::GetSubmitInfo(&cmdSubmitInfo, &signalSemaphoreInfo, &waitSemaphoreInfo);
-		CHECK_VK_RES(vkQueueSubmit2(s_Context->GetDevice()->GetGraphicsQueue(), 1, &submitInfo, frame.renderFinishedFence));
+		// Binary for present, timeline for jobs waiting on the frame
+		std::array<VkSemaphoreSubmitInfo, 2> signalSemaphoreInfos = {
+			VulkanUtils::GetSemaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, s_RenderFinishedSemaphores[s_CurrentImageIndex]),
+			VulkanUtils::GetSemaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, s_FrameTimeline)
+		};
+		signalSemaphoreInfos[1].value = s_FrameNumber + 1;
+
+		VkSubmitInfo2 submitInfo = VulkanUtils::GetSubmitInfo(&cmdSubmitInfo, signalSemaphoreInfos.data(), &waitSemaphoreInfo);
+		submitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(signalSemaphoreInfos.size());
+		SubmitToGraphicsQueue(submitInfo, frame.renderFinishedFence);
 
 		VkSwapchainKHR swapchain = ctx->GetSwaphain()->GetRaw();
 		VkPresentInfoKHR presentInfo{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
@@ -156,31 +230,37 @@ namespace VulkanEngine {
 		presentInfo.waitSemaphoreCount = 1;
 		presentInfo.pWaitSemaphores = &s_RenderFinishedSemaphores[s_CurrentImageIndex];
 
-		CHECK_VK_RES(vkQueuePresentKHR(s_Context->GetDevice()->GetPresentationQueue(), &presentInfo));
+		{
+			// May be the graphics queue
+			std::lock_guard lock(s_QueueMutex);
+			CHECK_VK_RES(vkQueuePresentKHR(s_Context->GetDevice()->GetPresentationQueue(), &presentInfo));
+		}
 
 		AdvanceFrame();
 	}
 
 	void VulkanRenderer::BeginImGui()
 	{
-		VkCommandBuffer cmd = s_Frames[s_CurrentFrameIndex].commandBuffer;
-
 		s_ImGuiRenderer->BeginImGuiFrame();
 	}
 
-	void VulkanRenderer::EndImGui()
+	ImDrawData* VulkanRenderer::EndImGui()
 	{
-		VkCommandBuffer cmd = s_Frames[s_CurrentFrameIndex].commandBuffer;
-		auto* ctx = VulkanContext::GetRaw();
-		auto& swapchainImages = ctx->GetSwaphain()->GetImages();
-		SwapchainImage& targetImage = swapchainImages[s_CurrentImageIndex];
+		return s_ImGuiRenderer->EndImGuiFrame();
+	}
+
+	void VulkanRenderer::RenderImGui(ImDrawData* drawData)
+	{
+		if (!drawData)
+			return;
 
-		s_ImGuiRenderer->EndImGuiFrame(cmd, s_RenderTarget);
+		s_ImGuiRenderer->RecordImGui(s_Frames[s_CurrentFrameIndex].commandBuffer, s_RenderTarget, drawData);
 	}
 
 	void VulkanRenderer::AdvanceFrame()
 	{
 		s_CurrentFrameIndex = (s_CurrentFrameIndex + 1) % FRAMES_IN_FLIGHT;
+		s_FrameNumber++;
 	}
 
 	void VulkanRenderer::BlitSceneToSwapchain(VkCommandBuffer cmd)
@@ -216,7 +296,7 @@ namespace VulkanEngine {
 
 	void VulkanRenderer::Clear(const glm::vec3& clearColor)
 	{
-		VkCommandBuffer cmd = s_Frames[s_CurrentFrameIndex].commandBuffer;
+		VkCommandBuffer cmd = GetCommandBuffer();
 
 		// Clear requires transfer dst
 		VulkanUtils::InsertImageMemoryBarrier(
@@ -234,13 +314,30 @@ namespace VulkanEngine {
 
 	void VulkanRenderer::BindPipeline(VkPipeline pipeline, VkPipelineBindPoint bindPoint)
 	{
-		vkCmdBindPipeline(s_Frames[s_CurrentFrameIndex].commandBuffer, bindPoint, pipeline);
+		vkCmdBindPipeline(GetCommandBuffer(), bindPoint, pipeline);
+	}
+
+	void VulkanRenderer::BindPipeline(const VulkanPipeline& pipeline)
+	{
+		vkCmdBindPipeline(GetCommandBuffer(), pipeline.GetBindPoint(), pipeline.GetRaw());
+	}
+
+	void VulkanRenderer::BindPipeline(PipelineHandle pipeline)
+	{
+		const PipelineResource* resource = s_Resources->GetPipeline(pipeline);
+		if (!resource)
+		{
+			VulkanEngine_ERROR("BindPipeline: stale pipeline handle");
+			return;
+		}
+
+		vkCmdBindPipeline(GetCommandBuffer(), resource->bindPoint, resource->pipeline);
 	}
 
 	void VulkanRenderer::BindDescriptorSets(VkPipelineBindPoint bindPoint, VkPipelineLayout layout, VkDescriptorSet set)
 	{
 		vkCmdBindDescriptorSets(
-			s_Frames[s_CurrentFrameIndex].commandBuffer,
+			GetCommandBuffer(),
 			bindPoint,
 			layout,
 			0,
@@ -251,9 +348,21 @@ namespace VulkanEngine {
 		);
 	}
 
+	void VulkanRenderer::BindDescriptorSets(VkPipelineBindPoint bindPoint, VkPipelineLayout layout, DescriptorSetHandle set)
+	{
+		VkDescriptorSet resource = s_Resources->GetDescriptorSet(set);
+		if (resource == VK_NULL_HANDLE)
+		{
+			VulkanEngine_ERROR("BindDescriptorSets: stale descriptor set handle");
+			return;
+		}
+
+		BindDescriptorSets(bindPoint, layout, resource);
+	}
+
 	void VulkanRenderer::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
 	{
-		VkCommandBuffer cmd = s_Frames[s_CurrentFrameIndex].commandBuffer;
+		VkCommandBuffer cmd = GetCommandBuffer();
 
 		// Transition to general layout for compute shader storage access
 		VulkanUtils::InsertImageMemoryBarrier(
@@ -265,13 +374,536 @@ namespace VulkanEngine {
 		vkCmdDispatch(cmd, groupCountX, groupCountY, groupCountZ);
 	}
 
+	void VulkanRenderer::Dispatch(VkExtent3D extent, const std::array<uint32_t, 3>& workgroupSize)
+	{
+		VkExtent3D groupCount = VulkanUtils::GetGroupCount(extent, workgroupSize);
+		Dispatch(groupCount.width, groupCount.height, groupCount.depth);
+	}
+
+	void VulkanRenderer::DispatchIndirect(AllocatedBuffer& argumentBuffer, VkDeviceSize offset)
+	{
+		VkCommandBuffer cmd = GetCommandBuffer();
+
+		VulkanUtils::InsertImageMemoryBarrier(
+			cmd, s_RenderTarget.image, s_RenderTarget.imageState,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+			VK_IMAGE_LAYOUT_GENERAL
+		);
+
+		// Group count written earlier on the GPU
+		PrepareIndirectRead(argumentBuffer);
+
+		vkCmdDispatchIndirect(cmd, argumentBuffer.buffer, offset);
+	}
+
+	void VulkanRenderer::BeginRendering(bool withDepth)
+	{
+		VkCommandBuffer cmd = GetCommandBuffer();
+
+		VulkanUtils::InsertImageMemoryBarrier(
+			cmd, s_RenderTarget.image, s_RenderTarget.imageState,
+			VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+			VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+		);
+
+		if (withDepth)
+		{
+			VulkanUtils::InsertImageMemoryBarrier(
+				cmd, s_DepthTarget.image, s_DepthTarget.imageState,
+				VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+				VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_IMAGE_ASPECT_DEPTH_BIT
+			);
+		}
+
+		if (s_Recording.stream)
+		{
+			// Secondaries only draw inside rendering begun in the primary, ExecuteStream begins it there
+			CloseStreamBuffer();
+			s_Recording.stream->entries.push_back({ CommandStream::EntryType::BeginRendering, VK_NULL_HANDLE, withDepth });
+			s_Recording.insideRendering = true;
+			s_Recording.withDepth		= withDepth;
+			s_Recording.cmd				= BeginSecondary(true, withDepth);
+			return;
+		}
+
+		BeginRenderingScope(cmd, withDepth, 0);
+		SetViewportAndScissor(cmd);
+	}
+
+	void VulkanRenderer::EndRendering()
+	{
+		if (s_Recording.stream)
+		{
+			CloseStreamBuffer();
+			s_Recording.stream->entries.push_back({ CommandStream::EntryType::EndRendering });
+			s_Recording.insideRendering = false;
+			s_Recording.withDepth		= false;
+			s_Recording.cmd				= BeginSecondary(false, false);
+			return;
+		}
+
+		vkCmdEndRendering(GetCommandBuffer());
+	}
+
+	void VulkanRenderer::BeginRenderingScope(VkCommandBuffer cmd, bool withDepth, VkRenderingFlags flags)
+	{
+		const VkRenderingAttachmentInfo colorAttachment = VulkanUtils::GetRenderingAttachmentInfo(
+			s_RenderTarget.imageView, nullptr, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+		const VkRenderingAttachmentInfo depthAttachment = VulkanUtils::GetDepthAttachmentInfo(s_DepthTarget.imageView, 0.0f);
+		VkRenderingInfo renderingInfo = VulkanUtils::GetRenderingInfo(
+			colorAttachment, s_RenderTarget.extent, withDepth ? &depthAttachment : nullptr);
+		renderingInfo.flags = flags;
+
+		vkCmdBeginRendering(cmd, &renderingInfo);
+	}
+
+	void VulkanRenderer::SetViewportAndScissor(VkCommandBuffer cmd)
+	{
+		// Pipelines keep viewport and scissor dynamic
+		VkViewport viewport{
+			.x			= 0.0f,
+			.y			= 0.0f,
+			.width		= static_cast<float>(s_RenderTarget.extent.width),
+			.height		= static_cast<float>(s_RenderTarget.extent.height),
+			.minDepth	= 0.0f,
+			.maxDepth	= 1.0f
+		};
+		VkRect2D scissor{ .offset = { 0, 0 }, .extent = { s_RenderTarget.extent.width, s_RenderTarget.extent.height } };
+
+		vkCmdSetViewport(cmd, 0, 1, &viewport);
+		vkCmdSetScissor(cmd, 0, 1, &scissor);
+	}
+
+	void VulkanRenderer::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+	{
+		vkCmdDraw(GetCommandBuffer(), vertexCount, instanceCount, firstVertex, firstInstance);
+	}
+
+	void VulkanRenderer::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+	{
+		vkCmdDrawIndexed(GetCommandBuffer(), indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+	}
+
+	void VulkanRenderer::PrepareIndirectRead(AllocatedBuffer& buffer)
+	{
+		static constexpr VkAccessFlags2 kIndirectRead = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+
+		// Already readable and not written since
+		if (buffer.bufferState.currentAccess == kIndirectRead)
+			return;
+
+		VulkanUtils::InsertBufferMemoryBarrier(
+			GetCommandBuffer(), buffer.buffer, buffer.bufferState,
+			VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, kIndirectRead
+		);
+	}
+
+	void VulkanRenderer::DrawIndirect(AllocatedBuffer& argumentBuffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
+	{
+		if (argumentBuffer.bufferState.currentAccess != VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+			VulkanEngine_ERROR("DrawIndirect: argument buffer was not prepared for indirect read");
+
+		vkCmdDrawIndirect(GetCommandBuffer(), argumentBuffer.buffer, offset, drawCount, stride);
+	}
+
+	void VulkanRenderer::DrawIndirectCount(AllocatedBuffer& argumentBuffer, VkDeviceSize offset,
+		AllocatedBuffer& countBuffer, VkDeviceSize countOffset, uint32_t maxDrawCount, uint32_t stride)
+	{
+		if (argumentBuffer.bufferState.currentAccess != VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT ||
+			countBuffer.bufferState.currentAccess != VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+			VulkanEngine_ERROR("DrawIndirectCount: argument or count buffer was not prepared for indirect read");
+
+		vkCmdDrawIndirectCount(GetCommandBuffer(),
+			argumentBuffer.buffer, offset, countBuffer.buffer, countOffset, maxDrawCount, stride);
+	}
+
+	void VulkanRenderer::DrawIndexedIndirectCount(AllocatedBuffer& argumentBuffer, VkDeviceSize offset,
+		AllocatedBuffer& countBuffer, VkDeviceSize countOffset, uint32_t maxDrawCount, uint32_t stride)
+	{
+		if (argumentBuffer.bufferState.currentAccess != VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT ||
+			countBuffer.bufferState.currentAccess != VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+			VulkanEngine_ERROR("DrawIndexedIndirectCount: argument or count buffer was not prepared for indirect read");
+
+		vkCmdDrawIndexedIndirectCount(GetCommandBuffer(),
+			argumentBuffer.buffer, offset, countBuffer.buffer, countOffset, maxDrawCount, stride);
+	}
+
+	void VulkanRenderer::BindIndexBuffer(const AllocatedBuffer& indexBuffer, VkIndexType indexType)
+	{
+		vkCmdBindIndexBuffer(GetCommandBuffer(), indexBuffer.buffer, 0, indexType);
+	}
+
+	bool VulkanRenderer::IsMeshShadingSupported()
+	{
+		return s_Context && s_Context->GetDevice()->IsExtensionEnabled(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+	}
+
+	void VulkanRenderer::DrawMeshTasks(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+	{
+		const auto& ext = s_Context->GetDevice()->GetExtensionFunctions();
+
+		ext.vkCmdDrawMeshTasksEXT(GetCommandBuffer(), groupCountX, groupCountY, groupCountZ);
+	}
+
+	void VulkanRenderer::DrawMeshTasksIndirectCount(AllocatedBuffer& argumentBuffer, VkDeviceSize offset,
+		AllocatedBuffer& countBuffer, VkDeviceSize countOffset, uint32_t maxDrawCount, uint32_t stride)
+	{
+		// Task shaders may also read their command as storage, only the indirect read is required
+		if (!(argumentBuffer.bufferState.currentAccess & VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT) ||
+			!(countBuffer.bufferState.currentAccess & VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT))
+			VulkanEngine_ERROR("DrawMeshTasksIndirectCount: argument or count buffer was not prepared for indirect read");
+
+		const auto& ext = s_Context->GetDevice()->GetExtensionFunctions();
+
+		ext.vkCmdDrawMeshTasksIndirectCountEXT(GetCommandBuffer(),
+			argumentBuffer.buffer, offset, countBuffer.buffer, countOffset, maxDrawCount, stride);
+	}
+
+	void VulkanRenderer::BindShaderObjects(std::span<const VkShaderStageFlagBits> stages, std::span<const VkShaderEXT> shaders)
+	{
+		const auto& ext = s_Context->GetDevice()->GetExtensionFunctions();
+
+		ext.vkCmdBindShadersEXT(
+			GetCommandBuffer(),
+			static_cast<uint32_t>(stages.size()),
+			stages.data(),
+			shaders.data()
+		);
+	}
+
+	void VulkanRenderer::SetDynamicGraphicsState(const GraphicsState& state)
+	{
+		VkCommandBuffer cmd = GetCommandBuffer();
+		const auto& ext = s_Context->GetDevice()->GetExtensionFunctions();
+
+		// Viewport + scissor cover the render target
+		VkViewport viewport{
+			.x			= 0.0f,
+			.y			= 0.0f,
+			.width		= static_cast<float>(s_RenderTarget.extent.width),
+			.height		= static_cast<float>(s_RenderTarget.extent.height),
+			.minDepth	= 0.0f,
+			.maxDepth	= 1.0f
+		};
+		VkRect2D scissor{ .offset = { 0, 0 }, .extent = { s_RenderTarget.extent.width, s_RenderTarget.extent.height } };
+
+		vkCmdSetViewportWithCount(cmd, 1, &viewport);
+		vkCmdSetScissorWithCount(cmd, 1, &scissor);
+
+		// Input assembly + rasterization
+		vkCmdSetPrimitiveTopology(cmd, state.topology);
+		vkCmdSetPrimitiveRestartEnable(cmd, VK_FALSE);
+		vkCmdSetRasterizerDiscardEnable(cmd, VK_FALSE);
+		vkCmdSetCullMode(cmd, state.cullMode);
+		vkCmdSetFrontFace(cmd, state.frontFace);
+		vkCmdSetDepthBiasEnable(cmd, VK_FALSE);
+		ext.vkCmdSetPolygonModeEXT(cmd, state.polygonMode);
+		ext.vkCmdSetVertexInputEXT(cmd, 0, nullptr, 0, nullptr);
+
+		// Multisample
+		VkSampleMask sampleMask = ~0u;
+		ext.vkCmdSetRasterizationSamplesEXT(cmd, state.samples);
+		ext.vkCmdSetSampleMaskEXT(cmd, state.samples, &sampleMask);
+		ext.vkCmdSetAlphaToCoverageEnableEXT(cmd, VK_FALSE);
+
+		// Depth + stencil
+		vkCmdSetDepthTestEnable(cmd, state.depthTest);
+		vkCmdSetDepthWriteEnable(cmd, state.depthWrite);
+		vkCmdSetDepthCompareOp(cmd, state.depthCompareOp);
+		vkCmdSetDepthBoundsTestEnable(cmd, VK_FALSE);
+		vkCmdSetStencilTestEnable(cmd, VK_FALSE);
+
+		// Color blend for the single render target attachment
+		VkBool32 blendEnable = state.blendEnable;
+		VkColorComponentFlags writeMask =
+			VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+			VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+		ext.vkCmdSetColorBlendEnableEXT(cmd, 0, 1, &blendEnable);
+		ext.vkCmdSetColorBlendEquationEXT(cmd, 0, 1, &state.blendEquation);
+		ext.vkCmdSetColorWriteMaskEXT(cmd, 0, 1, &writeMask);
+	}
+
+	// ===========================================================================
+	// Parallel Recording
+	// ===========================================================================
+
+	void VulkanRenderer::BeginStream(CommandStream& stream)
+	{
+		stream.Clear();
+
+		s_Recording			= {};
+		s_Recording.stream	= &stream;
+		s_Recording.cmd		= BeginSecondary(false, false);
+	}
+
+	void VulkanRenderer::EndStream()
+	{
+		if (s_Recording.insideRendering)
+		{
+			VulkanEngine_ERROR("Command stream ended inside rendering, ending it");
+			EndRendering();
+		}
+
+		CloseStreamBuffer();
+		s_Recording = {};
+	}
+
+	void VulkanRenderer::ExecuteStream(const CommandStream& stream)
+	{
+		VkCommandBuffer cmd = s_Frames[s_CurrentFrameIndex].commandBuffer;
+		std::vector<VkCommandBuffer> secondaries;
+
+		// Consecutive secondaries in one call
+		auto executeSecondaries = [&]()
+			{
+				if (secondaries.empty())
+					return;
+
+				vkCmdExecuteCommands(cmd, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+				secondaries.clear();
+			};
+
+		for (const CommandStream::Entry& entry : stream.entries)
+		{
+			switch (entry.type)
+			{
+			case CommandStream::EntryType::Execute:
+				secondaries.push_back(entry.cmd);
+				break;
+
+			case CommandStream::EntryType::BeginRendering:
+				executeSecondaries();
+				BeginRenderingScope(cmd, entry.withDepth, VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT);
+				break;
+
+			case CommandStream::EntryType::EndRendering:
+				executeSecondaries();
+				vkCmdEndRendering(cmd);
+				break;
+			}
+		}
+
+		executeSecondaries();
+	}
+
+	void VulkanRenderer::RecordParallel(uint32_t count, uint32_t grainSize,
+		const std::function<void(VkCommandBuffer cmd, uint32_t first, uint32_t last)>& record)
+	{
+		if (count == 0)
+			return;
+
+		// Secondaries need a stream to be ordered into, the primary records serially
+		if (!s_Recording.stream)
+		{
+			record(GetCommandBuffer(), 0, count);
+			return;
+		}
+
+		grainSize = std::max(1u, grainSize);
+
+		CloseStreamBuffer();
+		RecordingState own = s_Recording;
+
+		std::vector<VkCommandBuffer> chunks((count + grainSize - 1) / grainSize);
+
+		Application::GetRaw()->GetJobSystem()->ParallelFor(count, grainSize,
+			[&](uint32_t first, uint32_t last)
+			{
+				// The thread may be in the middle of a stream of its own, helping while that one waits
+				VkCommandBuffer cmd = BeginSecondary(own.insideRendering, own.withDepth);
+				RecordingState previous = std::exchange(s_Recording, RecordingState{ .cmd = cmd });
+
+				record(cmd, first, last);
+				CHECK_VK_RES(vkEndCommandBuffer(cmd));
+
+				s_Recording = previous;
+				chunks[first / grainSize] = cmd;
+			});
+
+		// Under fibers other jobs may have recorded on this thread while it waited
+		s_Recording = own;
+
+		for (VkCommandBuffer chunk : chunks)
+			s_Recording.stream->entries.push_back({ CommandStream::EntryType::Execute, chunk });
+
+		s_Recording.cmd = BeginSecondary(own.insideRendering, own.withDepth);
+	}
+
+	VkCommandBuffer VulkanRenderer::BeginSecondary(bool insideRendering, bool withDepth)
+	{
+		VkCommandBuffer cmd = s_CommandPools->AcquireSecondary(s_CurrentFrameIndex);
+
+		VkCommandBufferInheritanceRenderingInfo renderingInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO };
+		renderingInfo.colorAttachmentCount		= 1;
+		renderingInfo.pColorAttachmentFormats	= &s_RenderTarget.format;
+		renderingInfo.depthAttachmentFormat		= withDepth ? DEPTH_FORMAT : VK_FORMAT_UNDEFINED;
+		renderingInfo.rasterizationSamples		= VK_SAMPLE_COUNT_1_BIT;
+
+		VkCommandBufferInheritanceInfo inheritanceInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+		inheritanceInfo.pNext = insideRendering ? &renderingInfo : nullptr;
+
+		VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		if (insideRendering)
+			usage |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+
+		VkCommandBufferBeginInfo beginInfo = VulkanUtils::GetBeginCmdBufferInfo(usage);
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+		CHECK_VK_RES(vkBeginCommandBuffer(cmd, &beginInfo));
+
+		// Dynamic state is not inherited from the primary
+		if (insideRendering)
+			SetViewportAndScissor(cmd);
+
+		return cmd;
+	}
+
+	void VulkanRenderer::CloseStreamBuffer()
+	{
+		CHECK_VK_RES(vkEndCommandBuffer(s_Recording.cmd));
+		s_Recording.stream->entries.push_back({ CommandStream::EntryType::Execute, s_Recording.cmd });
+		s_Recording.cmd = VK_NULL_HANDLE;
+	}
+
+	void VulkanRenderer::ImmediateSubmit(const std::function<void(VkCommandBuffer cmd)>& record)
+	{
+		std::lock_guard lock(s_ImmediateMutex);
+
+		VkDevice		device	= *s_Context->GetDevice();
+		VkCommandBuffer cmd		= s_ImmediateFrame.commandBuffer;
+
+		CHECK_VK_RES(vkResetFences(device, 1, &s_ImmediateFrame.renderFinishedFence));
+		CHECK_VK_RES(vkResetCommandBuffer(cmd, 0));
+
+		VkCommandBufferBeginInfo beginInfo = VulkanUtils::GetBeginCmdBufferInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		CHECK_VK_RES(vkBeginCommandBuffer(cmd, &beginInfo));
+
+		record(cmd);
+
+		CHECK_VK_RES(vkEndCommandBuffer(cmd));
+
+		VkCommandBufferSubmitInfo cmdSubmitInfo = VulkanUtils::GetCommandBufferSubmitInfo(cmd);
+		VkSubmitInfo2 submitInfo = VulkanUtils::GetSubmitInfo(&cmdSubmitInfo, nullptr, nullptr);
+
+		SubmitToGraphicsQueue(submitInfo, s_ImmediateFrame.renderFinishedFence);
+		CHECK_VK_RES(vkWaitForFences(device, 1, &s_ImmediateFrame.renderFinishedFence, VK_TRUE, UINT64_MAX));
+	}
+
+	void VulkanRenderer::SubmitToGraphicsQueue(const VkSubmitInfo2& submitInfo, VkFence fence)
+	{
+		std::lock_guard lock(s_QueueMutex);
+		CHECK_VK_RES(vkQueueSubmit2(s_Context->GetDevice()->GetGraphicsQueue(), 1, &submitInfo, fence));
+	}
+
+	AllocatedBuffer VulkanRenderer::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+		VmaMemoryUsage memoryUsage, VmaAllocationCreateFlags flags)
+	{
+		auto* app = Application::GetRaw();
+
+		AllocatedBuffer buffer = CreateUnmanagedBuffer(size, usage, memoryUsage, flags);
+
+		// Lifetime management
+		app->GetLifetimeManager()->Push(vmaDestroyBuffer, s_Allocator->GetRaw(), buffer.buffer, buffer.allocation);
+
+		return buffer;
+	}
+
+	AllocatedBuffer VulkanRenderer::CreateUnmanagedBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+		VmaMemoryUsage memoryUsage, VmaAllocationCreateFlags flags)
+	{
+		VkDevice device = *s_Context->GetDevice();
+
+		AllocatedBuffer buffer;
+		buffer.size = size;
+
+		VkBufferCreateInfo bufferInfo = VulkanUtils::GetBufferCreateInfo(size, usage | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
+
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.flags = flags;
+		allocInfo.usage = memoryUsage;
+
+		VmaAllocationInfo allocationInfo{};
+		s_Allocator->AllocateBuffer(bufferInfo, allocInfo, &buffer.buffer, &buffer.allocation, &allocationInfo);
+
+		buffer.mapped = allocationInfo.pMappedData;
+
+		VkBufferDeviceAddressInfo addressInfo{
+			.sType	= VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+			.buffer = buffer.buffer
+		};
+		buffer.address = vkGetBufferDeviceAddress(device, &addressInfo);
+
+		return buffer;
+	}
+
+	AllocatedImage VulkanRenderer::CreateUnmanagedImage(VkFormat format, VkExtent3D extent, VkImageUsageFlags usage,
+		uint32_t mipCount, VkImageAspectFlags aspect)
+	{
+		VkDevice device = *s_Context->GetDevice();
+
+		AllocatedImage image{};
+		image.format = format;
+		image.extent = extent;
+
+		VkImageCreateInfo imageInfo = VulkanUtils::GetImageCreateInfo(format, extent, usage);
+		imageInfo.mipLevels = mipCount;
+
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+		s_Allocator->AllocateImage(imageInfo, allocInfo, &image.image, &image.allocation);
+
+		VkImageViewCreateInfo viewInfo = VulkanUtils::GetImageViewCreateInfo(image.image, format, aspect);
+		viewInfo.subresourceRange.levelCount = mipCount;
+		CHECK_VK_RES(vkCreateImageView(device, &viewInfo, nullptr, &image.imageView));
+
+		return image;
+	}
+
+	AllocatedBuffer VulkanRenderer::CreateStagingBuffer(VkDeviceSize size)
+	{
+		AllocatedBuffer buffer;
+		buffer.size = size;
+
+		VkBufferCreateInfo bufferInfo = VulkanUtils::GetBufferCreateInfo(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+		allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+
+		VmaAllocationInfo allocationInfo{};
+		s_Allocator->AllocateBuffer(bufferInfo, allocInfo, &buffer.buffer, &buffer.allocation, &allocationInfo);
+
+		buffer.mapped = allocationInfo.pMappedData;
+
+		return buffer;
+	}
+
+	void VulkanRenderer::DestroyStagingBuffer(AllocatedBuffer& buffer)
+	{
+		if (buffer.buffer == VK_NULL_HANDLE)
+			return;
+
+		vmaDestroyBuffer(s_Allocator->GetRaw(), buffer.buffer, buffer.allocation);
+		buffer = {};
+	}
+
 	void VulkanRenderer::EndInit()
 	{
 		auto* app = Application::GetRaw();
 		auto* ctx = VulkanContext::GetRaw();
 		VkDevice	device = *ctx->GetDevice();
 
+		// Background pipeline work must finish before anything it references is destroyed
+		if (s_PipelineLibrary)
+			app->GetLifetimeManager()->PushFunction([]() { s_PipelineLibrary->StopWorker(); });
+
 		app->GetLifetimeManager()->Push(vkDeviceWaitIdle, device);
+
+		// Runs first, no rebuild may start once shutdown begins
+		app->GetLifetimeManager()->PushFunction([]() { ShaderHotReloader::Stop(); });
 	}
 
 }
\ No newline at end of file
@@ -5,17 +5,26 @@
 #include <vector>
 #include <array>
 #include <memory>
+#include <span>
+#include <functional>
+#include <mutex>
 
 #include "ImGui/ImGuiRenderer.h"
 
 #include "VulkanAbstraction/Core/VulkanContext.h"
 #include "VulkanAbstraction/VulkanSwapchain.h"
 #include "VulkanAbstraction/VulkanMemoryAllocator.h"
+#include "VulkanAbstraction/DeletionQueue.h"
+#include "VulkanAbstraction/Resources/ResourceRegistry.h"
 #include "VulkanAbstraction/VulkanTypes.h" 
+#include "VulkanAbstraction/Pipelines/VulkanPipelineLibrary.h"
+#include "VulkanAbstraction/Commands/CommandStream.h"
+#include "VulkanAbstraction/Commands/ThreadCommandPools.h"
 
 namespace VulkanEngine {
 
 	static constexpr unsigned int FRAMES_IN_FLIGHT = 2;
+	static constexpr VkFormat DEPTH_FORMAT = VK_FORMAT_D32_SFLOAT; // reverse-Z, cleared to 0
 
 	class VulkanRenderer
 	{
@@ -27,23 +36,114 @@ namespace VulkanEngine {
 
 		static void BeginFrame();
 		static void EndFrame();
+		// Main thread: BeginImGui, the layers' ImGui, EndImGui builds the draw data.
+		// RenderImGui records it into the frame, on whichever thread records.
 		static void BeginImGui();
-		static void EndImGui();
+		[[nodiscard]] static ImDrawData* EndImGui();
+		static void RenderImGui(ImDrawData* drawData);
 
 		static void Clear(const glm::vec3& clearColor);
 		static void BindPipeline(VkPipeline pipeline, VkPipelineBindPoint bindPoint);
+		static void BindPipeline(const VulkanPipeline& pipeline);
+		static void BindPipeline(PipelineHandle pipeline);
 		static void BindDescriptorSets(VkPipelineBindPoint bindPoint, VkPipelineLayout layout, VkDescriptorSet set);
+		static void BindDescriptorSets(VkPipelineBindPoint bindPoint, VkPipelineLayout layout, DescriptorSetHandle set);
 		static void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
+		static void Dispatch(VkExtent3D extent, const std::array<uint32_t, 3>& workgroupSize); // one invocation per texel
+		static void DispatchIndirect(AllocatedBuffer& argumentBuffer, VkDeviceSize offset = 0); // VkDispatchIndirectCommand
+
+		static void BeginRendering(bool withDepth = false); // pipelines drawn with depth use SetDepthFormat(DEPTH_FORMAT)
+		static void EndRendering();
+		static void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0);
+		static void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t vertexOffset = 0,
+			uint32_t firstInstance = 0);
+
+		// Indirect draws run inside rendering where buffer barriers are not allowed, so argument and
+		// count buffers are made readable beforehand (PrepareIndirectRead or ComputePassSequence)
+		static void PrepareIndirectRead(AllocatedBuffer& buffer);
+		static void DrawIndirect(AllocatedBuffer& argumentBuffer, VkDeviceSize offset, uint32_t drawCount,
+			uint32_t stride = sizeof(VkDrawIndirectCommand));
+		static void DrawIndirectCount(AllocatedBuffer& argumentBuffer, VkDeviceSize offset,
+			AllocatedBuffer& countBuffer, VkDeviceSize countOffset, uint32_t maxDrawCount,
+			uint32_t stride = sizeof(VkDrawIndirectCommand));
+		static void DrawIndexedIndirectCount(AllocatedBuffer& argumentBuffer, VkDeviceSize offset,
+			AllocatedBuffer& countBuffer, VkDeviceSize countOffset, uint32_t maxDrawCount,
+			uint32_t stride = sizeof(VkDrawIndexedIndirectCommand));
+		static void BindIndexBuffer(const AllocatedBuffer& indexBuffer, VkIndexType indexType = VK_INDEX_TYPE_UINT32);
+
+		// VK_EXT_mesh_shader path, only valid when IsMeshShadingSupported()
+		static bool IsMeshShadingSupported();
+		static void DrawMeshTasks(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1);
+		static void DrawMeshTasksIndirectCount(AllocatedBuffer& argumentBuffer, VkDeviceSize offset,
+			AllocatedBuffer& countBuffer, VkDeviceSize countOffset, uint32_t maxDrawCount,
+			uint32_t stride = sizeof(VkDrawMeshTasksIndirectCommandEXT));
+
+		// VK_EXT_shader_object path
+		static void BindShaderObjects(std::span<const VkShaderStageFlagBits> stages, std::span<const VkShaderEXT> shaders);
+		static void SetDynamicGraphicsState(const GraphicsState& state);
 
 		static void EndInit();
 
+		// Parallel recording, on job system threads. Between BeginStream and EndStream the calling thread's
+		// render commands go into secondaries from its own pool, collected in order into stream;
+		// ExecuteStream replays it into the frame's primary, main thread only.
+		static void BeginStream(CommandStream& stream);
+		static void EndStream();
+		static void ExecuteStream(const CommandStream& stream);
+
+		// record(cmd, first, last) over [0, count) in chunks of grainSize, recorded in parallel and executed in
+		// chunk order, inside the stream's rendering if it is in one. Outside a stream it records serially.
+		static void RecordParallel(uint32_t count, uint32_t grainSize,
+			const std::function<void(VkCommandBuffer cmd, uint32_t first, uint32_t last)>& record);
+
+		// The graphics queue is shared by the frame, immediate submits and asset uploads, from different threads
+		static void SubmitToGraphicsQueue(const VkSubmitInfo2& submitInfo, VkFence fence);
+
+		// Records and submits outside the frame loop, blocks until the GPU is done
+		static void ImmediateSubmit(const std::function<void(VkCommandBuffer cmd)>& record);
+
+		// Device local unless memoryUsage says otherwise, always device addressable; destroyed on shutdown
+		static AllocatedBuffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+			VmaMemoryUsage memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, VmaAllocationCreateFlags flags = 0);
+
+		// Same, but owned by the caller: hand it to the resource registry or the deletion queue
+		static AllocatedBuffer CreateUnmanagedBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+			VmaMemoryUsage memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, VmaAllocationCreateFlags flags = 0);
+
+		// Device local 2D image and a view over all its mips, owned by the caller like CreateUnmanagedBuffer
+		static AllocatedImage CreateUnmanagedImage(VkFormat format, VkExtent3D extent, VkImageUsageFlags usage,
+			uint32_t mipCount = 1, VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+
+		// Mapped transfer source that only lives for a copy, not lifetime managed: the caller destroys it
+		// once the GPU is done with it. Safe to call from any thread.
+		static AllocatedBuffer CreateStagingBuffer(VkDeviceSize size);
+		static void DestroyStagingBuffer(AllocatedBuffer& buffer);
+
 		[[nodiscard]] static const VulkanContext& GetContext() { return *s_Context; }
 		[[nodiscard]] static const AllocatedImage& GetRenderTarget() { return s_RenderTarget; }
+		[[nodiscard]] static AllocatedImage& GetDepthTarget() { return s_DepthTarget; }
 		[[nodiscard]] static const VulkanMemoryAllocator& GetAllocator() { return *s_Allocator; }
+		[[nodiscard]] static VulkanPipelineLibrary& GetPipelineLibrary() { return *s_PipelineLibrary; }
+		[[nodiscard]] static DeletionQueue& GetDeletionQueue() { return *s_DeletionQueue; }
+		[[nodiscard]] static ResourceRegistry& GetResources() { return *s_Resources; }
+		[[nodiscard]] static uint64_t GetFrameNumber() { return s_FrameNumber; }
+
+		// Reaches frame number + 1 once the GPU is done with that frame, jobs wait on it with JobSystem::Wait
+		[[nodiscard]] static VkSemaphore GetFrameTimeline() { return s_FrameTimeline; }
+		[[nodiscard]] static uint32_t GetFrameIndex() { return s_CurrentFrameIndex; }
+		[[nodiscard]] static bool IsInitialized() { return s_Context != nullptr; }
+
+		// Where the render commands above record: the frame's primary, unless the calling thread records a
+		// stream or a RecordParallel chunk
+		[[nodiscard]] static VkCommandBuffer GetCommandBuffer()
+		{
+			return s_Recording.cmd != VK_NULL_HANDLE ? s_Recording.cmd : s_Frames[s_CurrentFrameIndex].commandBuffer;
+		}
 
 	private:
 		static void InitCore();
 		static void InitRenderTarget();
+		static void InitDepthTarget();
 		static void InitFrameData();
 		static void InitSyncObjects();
 
@@ -51,18 +151,45 @@ namespace VulkanEngine {
 
 		static void BlitSceneToSwapchain(VkCommandBuffer cmd);
 
+		static void BeginRenderingScope(VkCommandBuffer cmd, bool withDepth, VkRenderingFlags flags);
+		static void SetViewportAndScissor(VkCommandBuffer cmd);
+
+		static VkCommandBuffer BeginSecondary(bool insideRendering, bool withDepth);
+		static void CloseStreamBuffer(); // ends the open secondary and appends it to the stream
+
 	private:
 		static inline std::unique_ptr<VulkanContext>			s_Context;
 		static inline std::unique_ptr<VulkanMemoryAllocator>	s_Allocator;
 		static inline std::unique_ptr<ImGuiRenderer>			s_ImGuiRenderer;
+		static inline std::unique_ptr<VulkanPipelineLibrary>	s_PipelineLibrary;
 
 		static inline AllocatedImage s_RenderTarget;
+		static inline AllocatedImage s_DepthTarget;
 
 		static inline std::array<Frame, FRAMES_IN_FLIGHT> s_Frames;
+		static inline Frame s_ImmediateFrame;
+		static inline std::mutex s_ImmediateMutex;
+		static inline std::mutex s_QueueMutex;
 		static inline std::vector<VkSemaphore> s_RenderFinishedSemaphores;
+		static inline std::unique_ptr<ThreadCommandPools> s_CommandPools;
+		static inline std::unique_ptr<DeletionQueue> s_DeletionQueue;
+		static inline std::unique_ptr<ResourceRegistry> s_Resources;
+		static inline VkSemaphore s_FrameTimeline = VK_NULL_HANDLE;
 
 		static inline uint32_t s_CurrentFrameIndex = 0;
 		static inline uint32_t s_CurrentImageIndex = 0;
+		static inline uint64_t s_FrameNumber = 0;
+
+		// What the calling thread records into
+		struct RecordingState
+		{
+			VkCommandBuffer cmd{ VK_NULL_HANDLE };
+			CommandStream*	stream{ nullptr };
+			bool			insideRendering{ false };
+			bool			withDepth{ false };
+		};
+
+		static inline thread_local RecordingState s_Recording;
 	};
 
 }
\ No newline at end of file
@@ -6,6 +6,41 @@
 
 namespace VulkanEngine {
 
+	void SpecializationConstants::Set(uint32_t constantID, uint32_t value)
+	{
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			if (entries[i].constantID == constantID)
+			{
+				data[i] = value;
+				return;
+			}
+		}
+
+		entries.push_back({
+			.constantID = constantID,
+			.offset		= static_cast<uint32_t>(data.size() * sizeof(uint32_t)),
+			.size		= sizeof(uint32_t)
+		});
+		data.push_back(value);
+	}
+
+	uint64_t SpecializationConstants::GetHash(uint64_t seed) const
+	{
+		uint64_t hash = HashUtils::Hash64(entries.data(), entries.size() * sizeof(VkSpecializationMapEntry), seed);
+		return HashUtils::Hash64(data.data(), data.size() * sizeof(uint32_t), hash);
+	}
+
+	VkSpecializationInfo SpecializationConstants::GetInfo() const
+	{
+		return VkSpecializationInfo{
+			.mapEntryCount	= static_cast<uint32_t>(entries.size()),
+			.pMapEntries	= entries.data(),
+			.dataSize		= data.size() * sizeof(uint32_t),
+			.pData			= data.data()
+		};
+	}
+
 	void Frame::Init(VkDevice device, uint32_t queueFamilyIndex)
 	{
 		auto* ctx = VulkanContext::GetRaw();
@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan.h>
 #include <vma/vk_mem_alloc.h>
+#include <array>
+#include <vector>
 
 
 namespace VulkanEngine {
@@ -23,6 +25,63 @@ namespace VulkanEngine {
 		VmaAllocation	allocation;
 	};
 
+    // Last GPU use of a buffer, the next use is ordered after it with a buffer barrier
+    struct BufferState
+    {
+        VkPipelineStageFlags2 currentStage = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2        currentAccess = VK_ACCESS_2_NONE;
+    };
+
+    struct AllocatedBuffer
+    {
+        BufferState     bufferState;
+        VkBuffer        buffer{ VK_NULL_HANDLE };
+        VmaAllocation   allocation{ VK_NULL_HANDLE };
+        VkDeviceSize    size{ 0 };
+        VkDeviceAddress address{ 0 };
+        void*           mapped{ nullptr }; // host visible allocations only
+    };
+
+    // Fixed-function state of a graphics draw.
+    // Baked into pipelines by VkPipelineBuilder, set with vkCmdSet* on the shader-object path.
+    struct GraphicsState
+    {
+        VkPrimitiveTopology     topology            = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        VkPolygonMode           polygonMode         = VK_POLYGON_MODE_FILL;
+        VkCullModeFlags         cullMode            = VK_CULL_MODE_NONE;
+        VkFrontFace             frontFace           = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        VkSampleCountFlagBits   samples             = VK_SAMPLE_COUNT_1_BIT;
+        bool                    depthTest           = false;
+        bool                    depthWrite          = false;
+        VkCompareOp             depthCompareOp      = VK_COMPARE_OP_GREATER_OR_EQUAL;
+        bool                    blendEnable         = false;
+        VkColorBlendEquationEXT blendEquation       = {
+            VK_BLEND_FACTOR_SRC_ALPHA, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, VK_BLEND_OP_ADD,
+            VK_BLEND_FACTOR_ONE,       VK_BLEND_FACTOR_ZERO,                VK_BLEND_OP_ADD
+        };
+    };
+
+    // Compute shaders declare local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2
+    // so the workgroup size can be chosen at pipeline creation
+    static constexpr uint32_t WORKGROUP_SIZE_X_ID = 0;
+    static constexpr uint32_t WORKGROUP_SIZE_Y_ID = 1;
+    static constexpr uint32_t WORKGROUP_SIZE_Z_ID = 2;
+
+    // Specialization constants applied to every stage, ids a stage doesn't declare are ignored.
+    // All values are 32-bit (int, uint, float bits, bool).
+    struct SpecializationConstants
+    {
+        std::vector<VkSpecializationMapEntry>   entries;
+        std::vector<uint32_t>                   data;
+
+        void Set(uint32_t constantID, uint32_t value);
+        bool IsEmpty() const { return entries.empty(); }
+        uint64_t GetHash(uint64_t seed) const;
+
+        // Points into this object, valid while it is alive and unchanged
+        VkSpecializationInfo GetInfo() const;
+    };
+
     struct Frame
     {
         VkCommandPool   commandPool{ VK_NULL_HANDLE };
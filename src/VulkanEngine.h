@@ -1,16 +1,44 @@
 #include "Core/Application.h"
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Jobs/FiberScheduler.h"
 #include "Core/LogSystem.h"
 #include "Core/Layers/Layer.h"
+#include "Core/Layers/LayerScheduler.h"
+#include "Core/RenderThread/RenderThread.h"
+
+#include "Utility/Utility.h"
 
 #include "VulkanAbstraction/VulkanRenderer.h"
+#include "VulkanAbstraction/Commands/CommandBucket.h"
+#include "VulkanAbstraction/Resources/ResourceRegistry.h"
 
 #include "VulkanAbstraction/Descriptors/VkDescriptorSetLayoutBuilder.h"
 #include "VulkanAbstraction/Descriptors/VulkanDescriptorSet.h"
 #include "VulkanAbstraction/Descriptors/VulkanDescriptorSetAllocator.h"
 
+#include "VulkanAbstraction/Compute/ComputePassSequence.h"
+
+#include "VulkanAbstraction/Assets/AssetLoader.h"
+#include "VulkanAbstraction/Assets/AssetPackage.h"
+#include "VulkanAbstraction/Assets/Texture.h"
+#include "VulkanAbstraction/Assets/TextureImporter.h"
+
+#include "VulkanAbstraction/Geometry/GltfImporter.h"
+#include "VulkanAbstraction/Geometry/MeshCache.h"
+#include "VulkanAbstraction/Geometry/MeshData.h"
+
+#include "VulkanAbstraction/Scene/GpuScene.h"
+#include "VulkanAbstraction/Scene/HiZPyramid.h"
+
 #include "VulkanAbstraction/Pipelines/VkPipelineBuilder.h"
 #include "VulkanAbstraction/Pipelines/VkPipelineLayoutBuilder.h"
+#include "VulkanAbstraction/Pipelines/VulkanLayoutCache.h"
+#include "VulkanAbstraction/Pipelines/WorkgroupAutotuner.h"
 
 #include "VulkanAbstraction/Shaders/VulkanShader.h"
+#include "VulkanAbstraction/Shaders/ShaderBatchCompiler.h"
+#include "VulkanAbstraction/Shaders/ShaderArchive.h"
+#include "VulkanAbstraction/Shaders/ShaderHotReloader.h"
+#include "VulkanAbstraction/Shaders/VulkanShaderObject.h"
 
 #include <vulkan/vulkan.h>
\ No newline at end of file
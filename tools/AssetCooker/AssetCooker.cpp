@@ -0,0 +1,141 @@
+#include "VulkanAbstraction/Assets/AssetPackage.h"
+#include "VulkanAbstraction/Assets/TextureImporter.h"
+#include "VulkanAbstraction/Geometry/GltfImporter.h"
+#include "VulkanAbstraction/Geometry/MeshCache.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+#include <optional>
+
+
+// Usage: AssetCooker <asset directory> <output package> [--quantize]
+// Every mesh (.gltf, .glb) and texture (.png, .jpg, .tga, .bmp) below the asset directory is converted to
+// its GPU layout and stored under its path relative to that directory, which is what AssetPackage::Find
+// looks up:
+//   meshes	imported, optimized and split into LODs and meshlets by GltfImporter, stored in the MeshCache layout
+//   textures	decoded to RGBA8 sRGB with a full mip chain, filtered in linear space
+// Shaders are not cooked here: their binaries depend on ShaderCompileOptions, ShaderPacker builds them
+// into the ShaderArchive VulkanShader loads from.
+
+using namespace VulkanEngine;
+
+static std::optional<AssetType> GetAssetType(const std::filesystem::path& path)
+{
+	static const std::set<std::string> s_Meshes		= { ".gltf", ".glb" };
+	static const std::set<std::string> s_Textures	= { ".png", ".jpg", ".jpeg", ".tga", ".bmp" };
+
+	std::string ext = path.extension().string();
+	std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+	if (s_Meshes.contains(ext))		return AssetType::Mesh;
+	if (s_Textures.contains(ext))	return AssetType::Texture;
+
+	return std::nullopt;
+}
+
+static const char* GetAssetTypeName(AssetType type)
+{
+	switch (type)
+	{
+	case AssetType::Mesh:		return "mesh";
+	case AssetType::Texture:	return "texture";
+	default:					return "unknown";
+	}
+}
+
+static bool CookMesh(const std::filesystem::path& path, const MeshImportOptions& options, std::vector<uint8_t>& blob)
+{
+	MeshData meshData;
+	if (!GltfImporter::Import(path, options, meshData))
+		return false;
+
+	std::ostringstream stream(std::ios::binary);
+	if (!MeshCache::Write(stream, meshData))
+		return false;
+
+	std::string bytes = std::move(stream).str();
+	blob.assign(bytes.begin(), bytes.end());
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	LogSystem::Initialize();
+
+	if (argc < 3)
+	{
+		VulkanEngine_ERROR("Usage: AssetCooker <asset directory> <output package> [--quantize]");
+		return 1;
+	}
+
+	std::filesystem::path assetDir		= std::filesystem::absolute(argv[1]).lexically_normal();
+	std::filesystem::path packagePath	= argv[2];
+
+	MeshImportOptions meshOptions;
+
+	for (int i = 3; i < argc; ++i)
+	{
+		if (std::string(argv[i]) == "--quantize")
+			meshOptions.quantize = true;
+	}
+
+	std::vector<std::filesystem::path> assetPaths;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(assetDir))
+	{
+		if (entry.is_regular_file() && GetAssetType(entry.path()))
+			assetPaths.push_back(entry.path());
+	}
+	std::sort(assetPaths.begin(), assetPaths.end());
+
+	std::vector<AssetPackage::Blob> blobs;
+	uint64_t sourceBytes = 0, cookedBytes = 0;
+	bool failed = false;
+
+	VulkanEngine_INFO(fmt::runtime("  {:<40} {:<8} {:>17}"), "asset", "type", "bytes");
+
+	for (const auto& assetPath : assetPaths)
+	{
+		AssetType type = *GetAssetType(assetPath);
+
+		AssetPackage::Blob blob{ .type = type };
+		bool cooked = false;
+
+		switch (type)
+		{
+		case AssetType::Mesh:		cooked = CookMesh(assetPath, meshOptions, blob.data);		break;
+		case AssetType::Texture:	cooked = TextureImporter::Import(assetPath, blob.data);		break;
+		}
+
+		if (!cooked)
+		{
+			failed = true;
+			continue;
+		}
+
+		std::filesystem::path relativePath = assetPath.lexically_relative(assetDir);
+		blob.key = AssetPackage::GetKey(relativePath);
+
+		std::error_code ec;
+		uint64_t sourceSize = std::filesystem::file_size(assetPath, ec);
+
+		VulkanEngine_INFO(fmt::runtime("  {:<40} {:<8} {:>7} -> {:>7}"), relativePath.generic_string(), GetAssetTypeName(type),
+			sourceSize, blob.data.size());
+
+		sourceBytes += sourceSize;
+		cookedBytes += blob.data.size();
+
+		blobs.push_back(std::move(blob));
+	}
+
+	// A partial package would silently miss assets at runtime, fail the build instead
+	if (failed)
+		return 1;
+
+	VulkanEngine_INFO(fmt::runtime("  {:<40} {:<8} {:>7} -> {:>7}"), "total", "", sourceBytes, cookedBytes);
+
+	if (!AssetPackage::Write(packagePath, std::move(blobs)))
+		return 1;
+
+	VulkanEngine_INFO(fmt::runtime("Cooked {} assets into {}"), assetPaths.size(), packagePath.string());
+	return 0;
+}
@@ -0,0 +1,103 @@
+#include "VulkanAbstraction/Shaders/ShaderArchive.h"
+#include "VulkanAbstraction/Shaders/ShaderCompiler.h"
+#include "Core/LogSystem.h"
+#include "Utility/Utility.h"
+
+
+// Usage: ShaderPacker <shader directory> <output archive> [--profile debug|release|size] [--include <directory>]...
+// Every shader stage file below the shader directory is compiled with the default options and the
+// chosen profile, and stored under its path relative to that directory, which is what
+// ShaderArchive::Find looks up. A per-shader size and instruction count report is printed.
+
+static bool IsShaderStage(const std::filesystem::path& path)
+{
+	std::string ext = path.extension().string();
+	return ext == ".vert" || ext == ".frag" || ext == ".comp" || ext == ".geom" || ext == ".task" || ext == ".mesh";
+}
+
+int main(int argc, char** argv)
+{
+	using namespace VulkanEngine;
+
+	LogSystem::Initialize();
+
+	if (argc < 3)
+	{
+		VulkanEngine_ERROR("Usage: ShaderPacker <shader directory> <output archive> [--profile debug|release|size] [--include <directory>]...");
+		return 1;
+	}
+
+	std::filesystem::path shaderDir		= std::filesystem::absolute(argv[1]).lexically_normal();
+	std::filesystem::path archivePath	= argv[2];
+
+	ShaderCompileOptions options;
+	std::vector<std::filesystem::path> includeDirs;
+
+	for (int i = 3; i + 1 < argc; i += 2)
+	{
+		std::string argument = argv[i];
+
+		if (argument == "--include")
+			includeDirs.push_back(argv[i + 1]);
+		else if (argument == "--profile" && !ShaderCompiler::ParseProfile(argv[i + 1], options.profile))
+		{
+			VulkanEngine_ERROR(fmt::runtime("Unknown shader profile: {}"), argv[i + 1]);
+			return 1;
+		}
+	}
+	ShaderCompiler::SetIncludeDirectories(includeDirs);
+
+	std::vector<std::filesystem::path> shaderPaths;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(shaderDir))
+	{
+		if (entry.is_regular_file() && IsShaderStage(entry.path()))
+			shaderPaths.push_back(entry.path());
+	}
+	std::sort(shaderPaths.begin(), shaderPaths.end());
+
+	std::vector<ShaderArchive::Blob> blobs;
+	ShaderCompileStats total;
+	bool failed = false;
+
+	VulkanEngine_INFO(fmt::runtime("Profile: {}"), ShaderCompiler::GetProfileName(options.profile));
+	VulkanEngine_INFO(fmt::runtime("  {:<32} {:>17} {:>17}"), "shader", "bytes", "instructions");
+
+	for (const auto& shaderPath : shaderPaths)
+	{
+		std::string source = FilesystemUtils::ReadFile(shaderPath, FilesystemUtils::ReadMode::Text);
+
+		ShaderArchive::Blob blob;
+		ShaderCompileStats stats;
+		if (!ShaderCompiler::Compile(shaderPath, source, options, blob.spirv, &stats))
+		{
+			failed = true;
+			continue;
+		}
+
+		std::filesystem::path relativePath = shaderPath.lexically_relative(shaderDir);
+		blob.key = ShaderArchive::GetKey(relativePath, options);
+
+		VulkanEngine_INFO(fmt::runtime("  {:<32} {:>7} -> {:>7} {:>7} -> {:>7}"), relativePath.generic_string(),
+			stats.sizeBefore, stats.sizeAfter, stats.instructionsBefore, stats.instructionsAfter);
+
+		total.sizeBefore			+= stats.sizeBefore;
+		total.sizeAfter				+= stats.sizeAfter;
+		total.instructionsBefore	+= stats.instructionsBefore;
+		total.instructionsAfter		+= stats.instructionsAfter;
+
+		blobs.push_back(std::move(blob));
+	}
+
+	// A partial archive would silently fall back to runtime compilation, fail the build instead
+	if (failed)
+		return 1;
+
+	VulkanEngine_INFO(fmt::runtime("  {:<32} {:>7} -> {:>7} {:>7} -> {:>7}"), "total",
+		total.sizeBefore, total.sizeAfter, total.instructionsBefore, total.instructionsAfter);
+
+	if (!ShaderArchive::Write(archivePath, options.profile, std::move(blobs)))
+		return 1;
+
+	VulkanEngine_INFO(fmt::runtime("Packed {} shaders into {}"), shaderPaths.size(), archivePath.string());
+	return 0;
+}